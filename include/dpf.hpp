@@ -8,6 +8,8 @@
 #ifndef LIBDPF_INCLUDE_DPF_HPP__
 #define LIBDPF_INCLUDE_DPF_HPP__
 
+#include "dpf/accumulate_full.hpp"
+
 #include "dpf/advice_bit_iterable.hpp"
 
 #include "dpf/aligned_allocator.hpp"
@@ -24,16 +26,32 @@
 
 #include "dpf/dpf_key.hpp"
 
+#include "dpf/dpf_key_batch.hpp"
+
 #include "dpf/eval_common.hpp"
 
 #include "dpf/eval_interval.hpp"
 
 #include "dpf/eval_full.hpp"
 
+#include "dpf/eval_full_depth_first.hpp"
+
+#include "dpf/eval_full_chunks.hpp"
+
+#include "dpf/eval_full_dot.hpp"
+
+#include "dpf/eval_full_batch.hpp"
+
+#include "dpf/eval_parallel.hpp"
+
 #include "dpf/eval_point.hpp"
 
 #include "dpf/eval_sequence.hpp"
 
+#include "dpf/eval_subtree.hpp"
+
+#include "dpf/half_tree_dpf_key.hpp"
+
 #include "dpf/interval_memoizer.hpp"
 
 #ifdef LIBDPF_HAS_NLOHMANN_JSON
@@ -52,6 +70,10 @@
 
 #include "dpf/literals.hpp"
 
+#if __has_include(<sys/mman.h>)
+#include "dpf/mapped_database.hpp"
+#endif
+
 #include "dpf/modint.hpp"
 
 #include "dpf/output_buffer.hpp"
@@ -74,6 +96,8 @@
 
 #include "dpf/sequence_recipe.hpp"
 
+#include "dpf/sequence_recipe_cache.hpp"
+
 #include "dpf/sequence_utils.hpp"
 
 #include "dpf/setbit_index_iterable.hpp"
@@ -0,0 +1,261 @@
+/// @file dpf/accumulate_full.hpp
+/// @brief sums the full-domain evaluations of many DPF keys
+/// @details For aggregation (histograms, heavy hitters, etc.), where a
+///          server adds up every client's DPF over the whole domain.
+///          Rather than materializing one output buffer per key and then
+///          summing them, the domain is walked one block of `2^lg_block`
+///          leaf nodes at a time, and every key's leaves for that block are
+///          folded (via `dpf::add_leaf`) into the same slice of the
+///          accumulator while it is still in cache. Each key keeps only its
+///          own root-to-block path between blocks, as in
+///          `dpf::eval_full_depth_first`.
+///
+///          With several threads, the blocks are split into contiguous
+///          ranges that are handed out from a shared counter; the ranges
+///          cover disjoint slices of the accumulator, so no partial
+///          accumulators or final reduction are needed.
+///
+///          Scratch memory is `keys * (depth + 1)` interior nodes plus one
+///          block memoizer per thread.
+/// @author Ryan Henry <ryan.henry@ucalgary.ca>
+/// @copyright Copyright (c) 2019-2024 Ryan Henry and [others](@ref authors)
+/// @license Released under a GNU General Public v2.0 (GPLv2) license;
+///          see [LICENSE.md](@ref license) for details.
+
+#ifndef LIBDPF_INCLUDE_DPF_ACCUMULATE_FULL_HPP__
+#define LIBDPF_INCLUDE_DPF_ACCUMULATE_FULL_HPP__
+
+#include <hedley/hedley.h>
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "dpf/bit.hpp"
+#include "dpf/dpf_key.hpp"
+#include "dpf/eval_common.hpp"
+#include "dpf/leaf_arithmetic.hpp"
+#include "dpf/output_buffer.hpp"
+#include "dpf/wildcard.hpp"
+#include "dpf/interval_memoizer.hpp"
+#include "dpf/eval_interval.hpp"
+#include "dpf/eval_full_depth_first.hpp"
+#include "dpf/eval_parallel.hpp"
+
+namespace dpf
+{
+
+namespace internal
+{
+
+/// @brief adds output `I` of each of `dpfs[0..keys)` on the blocks
+///        `[first_block, last_block)` into `acc`, which holds one leaf per
+///        leaf node of the domain
+template <std::size_t I,
+          typename DpfKey,
+          typename LeafT,
+          typename IntegralT = typename DpfKey::integral_type>
+void accumulate_blocks(const DpfKey * dpfs, std::size_t keys,
+    std::size_t lg_block, IntegralT first_block, IntegralT last_block,
+    LeafT * acc)
+{
+    using dpf_type = DpfKey;
+    using integral_type = typename DpfKey::integral_type;
+    using node_type = typename DpfKey::interior_node;
+    using output_type = typename DpfKey::concrete_output_type<I>;
+    constexpr auto depth = dpf_type::depth;
+    constexpr auto countr_zero = utils::countr_zero<std::size_t>{};
+
+    const std::size_t split = depth - lg_block,
+        block_len = std::size_t(1) << lg_block;
+
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    // paths[k*(split+1) + l] is key k's ancestor at level l of the block
+    std::vector<node_type> paths(keys * (split + 1));
+HEDLEY_PRAGMA(GCC diagnostic pop)
+    auto memoizer = dpf::basic_interval_memoizer<dpf_type>(block_len);
+
+    for (std::size_t k = 0; k < keys; ++k) paths[k * (split + 1)] = dpfs[k].root();
+
+    for (integral_type block = first_block; block < last_block; ++block)
+    {
+        // see `internal::depth_first_block_walker::expand`
+        std::size_t first_level = 1;
+        if (block != first_block)
+        {
+            first_level = split - countr_zero(static_cast<std::size_t>(block));
+        }
+        integral_type from_node = block << lg_block,
+            to_node = (block + 1) << lg_block;
+        LeafT * slice = acc + static_cast<std::size_t>(from_node);
+
+        for (std::size_t k = 0; k < keys; ++k)
+        {
+            const auto & dpf = dpfs[k];
+            node_type * path = &paths[k * (split + 1)];
+            for (std::size_t level = first_level; level <= split; ++level)
+            {
+                bool dir = (block >> (split - level)) & 1;
+                path[level] = dpf_type::traverse_interior(path[level-1],
+                    dpf.correction_word(level-1, dir), dir);
+            }
+            eval_subtree_interior(dpf, split, path[split], from_node, to_node,
+                memoizer);
+
+            auto cw = std::get<I>(dpf.leaf_nodes).get();
+            const node_type * nodes = &memoizer[depth][0];
+            DPF_UNROLL_LOOP
+            for (std::size_t j = 0; j < block_len; ++j)
+            {
+                slice[j] = dpf::add_leaf<output_type>(slice[j],
+                    dpf.template traverse_exterior<I>(nodes[j],
+                        get_if_lo_bit(cw, nodes[j])));
+            }
+        }
+    }
+}
+
+}  // namespace internal
+
+/// @brief adds the full-domain evaluation of output `I` of each of
+///        `dpfs[0..keys)` into `accumulator`
+/// @details After the call, `accumulator[i]` has been increased (via
+///          `dpf::add_leaf`, so, e.g., XORed for `dpf::bit` outputs) by the
+///          `i`th output that `dpf::eval_full` would produce for each key.
+/// @param threads the number of threads to use
+/// @throws std::length_error if `accumulator` is smaller than the domain
+/// @return `accumulator`
+template <std::size_t I = 0,
+          typename DpfKey,
+          typename OutputBuffer>
+OutputBuffer & accumulate_full(const DpfKey * dpfs, std::size_t keys,
+    OutputBuffer & accumulator,  // NOLINT(runtime/references)
+    std::size_t threads = 1, std::size_t lg_block = default_lg_block)
+{
+    static_assert(!dpf::is_wildcard_v<typename DpfKey::raw_input_type>,
+        "accumulate_full does not support wildcard inputs");
+    using dpf_type = DpfKey;
+    using integral_type = typename DpfKey::integral_type;
+    using leaf_node_type = std::tuple_element_t<I, typename DpfKey::leaf_tuple>;
+    constexpr auto depth = dpf_type::depth;
+
+    for (std::size_t k = 0; k < keys; ++k) assert_not_wildcard_output<I>(dpfs[k]);
+    if (HEDLEY_UNLIKELY(utils::is_below_domain_size<dpf_type>(std::size(accumulator))))
+    {
+        throw std::length_error("accumulator is smaller than the domain");
+    }
+    if (keys == 0) return accumulator;
+
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    auto acc = reinterpret_cast<leaf_node_type *>(utils::data(accumulator));
+HEDLEY_PRAGMA(GCC diagnostic pop)
+
+    lg_block = std::min(lg_block, depth);
+    const integral_type blocks = integral_type{1} << (depth - lg_block);
+
+    threads = std::max(threads, std::size_t(1));
+    const std::size_t ranges = static_cast<std::size_t>(std::min(blocks,
+        static_cast<integral_type>(threads * internal::parallel_subtrees_per_thread)));
+    if (threads == 1 || ranges == 1)
+    {
+        internal::accumulate_blocks<I>(dpfs, keys, lg_block, integral_type{0},
+            blocks, acc);
+        return accumulator;
+    }
+    threads = std::min(threads, ranges);
+
+    // range r covers blocks [first(r), first(r+1))
+    const integral_type per_range = blocks / ranges;
+    const std::size_t extra = static_cast<std::size_t>(blocks % ranges);
+    auto first = [&](std::size_t r)
+    {
+        return per_range * r + std::min(r, extra);
+    };
+
+    std::atomic_size_t next{0};
+    std::exception_ptr error = nullptr;
+    std::mutex error_mutex;
+
+    auto worker = [&]()
+    {
+        try
+        {
+            for (std::size_t r = next++; r < ranges; r = next++)
+            {
+                internal::accumulate_blocks<I>(dpfs, keys, lg_block, first(r),
+                    first(r + 1), acc);
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (error == nullptr) error = std::current_exception();
+            next = ranges;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    try
+    {
+        for (std::size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+    }
+    catch (...)
+    {
+        // run with however many threads could be started
+    }
+    worker();
+    for (auto & thread : pool) thread.join();
+
+    if (error != nullptr) std::rethrow_exception(error);
+    return accumulator;
+}
+
+/// @brief adds the full-domain evaluation of output `I` of each key in the
+///        contiguous range `dpfs` into `accumulator`
+template <std::size_t I = 0,
+          typename DpfKeys,
+          typename OutputBuffer,
+          std::enable_if_t<!std::is_pointer_v<std::decay_t<DpfKeys>>
+              && !std::is_integral_v<std::decay_t<OutputBuffer>>, bool> = true>
+HEDLEY_ALWAYS_INLINE
+OutputBuffer & accumulate_full(const DpfKeys & dpfs,
+    OutputBuffer & accumulator,  // NOLINT(runtime/references)
+    std::size_t threads = 1, std::size_t lg_block = default_lg_block)
+{
+    return accumulate_full<I>(std::data(dpfs), std::size(dpfs), accumulator,
+        threads, lg_block);
+}
+
+/// @brief sums the full-domain evaluations of output `I` of each key in the
+///        contiguous range `dpfs`
+/// @return a new output buffer holding the sum
+template <std::size_t I = 0,
+          typename DpfKeys,
+          std::enable_if_t<!std::is_pointer_v<std::decay_t<DpfKeys>>, bool> = true>
+auto accumulate_full(const DpfKeys & dpfs, std::size_t threads = 1,
+    std::size_t lg_block = default_lg_block)
+{
+    using dpf_type = std::decay_t<decltype(*std::data(dpfs))>;
+    using output_type = typename dpf_type::concrete_output_type<I>;
+
+    auto accumulator = make_output_buffer_for_full<dpf_type, I>();
+    // unlike the other output buffers, bit arrays start out uninitialized
+    if constexpr (std::is_same_v<output_type, dpf::bit>) accumulator.unset();
+    accumulate_full<I>(dpfs, accumulator, threads, lg_block);
+    return accumulator;
+}
+
+}  // namespace dpf
+
+#endif  // LIBDPF_INCLUDE_DPF_ACCUMULATE_FULL_HPP__
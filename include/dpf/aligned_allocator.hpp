@@ -65,9 +65,9 @@ class aligned_allocator
     using difference_type = std::ptrdiff_t;
     using pointer = value_type *;
     using unique_ptr = std::unique_ptr<value_type[], deleter<pointer>>;
-    using const_pointer = std::add_const_t<pointer>;
+    using const_pointer = const value_type *;
     using reference = value_type &;
-    using const_reference = std::add_const_t<reference>;
+    using const_reference = const value_type &;
     static constexpr size_type alignment = Alignment;
 
     /// @brief class whose member `other` is a typedef of
@@ -11,6 +11,16 @@
 
 #include <asio.hpp>
 
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "dpf/prg.hpp"
 #include "dpf/dpf_key.hpp"
 
@@ -165,6 +175,261 @@ auto make_dpf(PeerT & peer0, PeerT & peer1, dpfargs<InputT, OutputT, OutputTs...
     return std::make_tuple(bytes_written0, bytes_written1);
 }
 
+//
+// make_dpf_parallel
+//
+
+namespace detail
+{
+
+// slots per worker in `make_dpf_parallel`'s ring buffer
+static constexpr std::size_t keygen_slots_per_thread = 4;
+
+// yields before a thread waiting on `keygen_ring` parks itself
+static constexpr std::size_t keygen_spins_before_park = 64;
+
+/// @brief a bounded ring buffer that hands the `t`th generated key to the
+///        writer as ticket `t`
+/// @details Ticket `t` lives in slot `t % capacity`, whose sequence number
+///          is `t` while the slot is free for it and `t + 1` once it has been
+///          filled; releasing the slot bumps it to `t + capacity`, the next
+///          ticket to use that slot. Producers that get more than `capacity`
+///          tickets ahead of the consumer wait, which bounds memory. Waiting
+///          threads spin briefly and then park on a condition variable, so
+///          workers stalled by a slow peer do not burn a core each.
+template <typename T>
+class keygen_ring
+{
+  public:
+    explicit keygen_ring(std::size_t capacity)
+      : capacity_{capacity},
+        slots_{std::make_unique<slot[]>(capacity)}
+    {
+        for (std::size_t i = 0; i < capacity_; ++i)
+        {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief waits for the slot of `ticket` to be free, then fills it
+    /// @return `false` if the ring was cancelled while waiting
+    bool put(std::size_t ticket, T && value)
+    {
+        slot & s = slots_[ticket % capacity_];
+        if (!wait_for(s, ticket)) return false;
+        s.value = std::move(value);
+        publish(s, ticket + 1);
+        return true;
+    }
+
+    /// @brief waits for `ticket` to be filled
+    /// @return a pointer to its value, or `nullptr` if the ring was cancelled
+    ///         while waiting
+    T * get(std::size_t ticket)
+    {
+        slot & s = slots_[ticket % capacity_];
+        return wait_for(s, ticket + 1) ? &s.value : nullptr;
+    }
+
+    /// @brief frees the slot of `ticket`, which must have been `get`
+    void release(std::size_t ticket)
+    {
+        publish(slots_[ticket % capacity_], ticket + capacity_);
+    }
+
+    /// @brief wakes every waiting thread and makes all later waits fail
+    void cancel()
+    {
+        stop_.store(true);
+        std::lock_guard<std::mutex> lock(mutex_);
+        parked_.notify_all();
+    }
+
+  private:
+    struct alignas(64) slot
+    {
+        std::atomic_size_t sequence;
+        T value;
+    };
+
+    void publish(slot & s, std::size_t sequence)
+    {
+        s.sequence.store(sequence);
+        // taking the lock orders this wakeup after any concurrent waiter's
+        // final check of `sequence`, so the wakeup cannot be lost
+        if (waiters_.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            parked_.notify_all();
+        }
+    }
+
+    bool wait_for(const slot & s, std::size_t sequence)
+    {
+        // seq_cst, like `publish`: a parked waiter's `++waiters_` and its
+        // next load of `sequence` must not be reordered against the
+        // publisher's store of `sequence` and load of `waiters_`, or each
+        // could miss the other's write and the waiter would sleep forever
+        auto ready = [&]()
+        {
+            return s.sequence.load(std::memory_order_seq_cst) == sequence
+                || stop_.load(std::memory_order_relaxed);
+        };
+        for (std::size_t spin = 0; !ready(); ++spin)
+        {
+            if (spin < keygen_spins_before_park)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            ++waiters_;
+            parked_.wait(lock, ready);
+            --waiters_;
+        }
+        return s.sequence.load(std::memory_order_acquire) == sequence;
+    }
+
+    std::size_t capacity_;
+    std::unique_ptr<slot[]> slots_;
+    std::atomic_bool stop_{false};
+    std::atomic_size_t waiters_{0};
+    std::mutex mutex_;
+    std::condition_variable parked_;
+};
+
+}  // namespace detail
+
+/// @brief generates `count` key pairs for `args` on `threads` worker
+///        threads, while the calling thread writes them to `peer0` and
+///        `peer1`
+/// @details Keys reach the writer through a `detail::keygen_ring` with
+///          `threads * keygen_slots_per_thread` slots, so writes overlap
+///          with generation and a slow peer stalls the workers rather than
+///          letting generated keys pile up. Keys are written in the order
+///          of generation and in the same format as `make_dpf`.
+///          `root_sampler` is called concurrently from the workers.
+/// @return the bytes written to each peer and the number of key pairs
+///         written; on a write error, these reflect the writes that succeeded
+/// @throws whatever key generation throws on a worker thread
+template <typename InteriorPRG = dpf::prg::aes128,
+          typename ExteriorPRG = InteriorPRG,
+          typename PeerT,
+          typename InputT,
+          typename OutputT,
+          typename ...OutputTs>
+auto make_dpf_parallel(PeerT & peer0, PeerT & peer1, std::size_t count, const dpfargs<InputT, OutputT, OutputTs...> & args, std::size_t threads, ::asio::error_code & error, root_sampler_t<InteriorPRG> root_sampler = dpf::uniform_sample<typename InteriorPRG::block_type>)
+{
+    using dpf_type = utils::dpf_type_t<InteriorPRG, ExteriorPRG, InputT, OutputT, OutputTs...>;
+    using correction_words_array = typename dpf_type::correction_words_array;
+    using correction_advice_array = typename dpf_type::correction_advice_array;
+    using interior_node = typename dpf_type::interior_node;
+    using leaf_tuple = typename dpf_type::leaf_tuple;
+    using beaver_tuple = typename dpf_type::beaver_tuple;
+    using input_type = typename dpf_type::input_type;
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    using key_parts = decltype(dpf::detail::make_dpf_impl<InteriorPRG, ExteriorPRG>(args, std::move(root_sampler)));
+HEDLEY_PRAGMA(GCC diagnostic pop)
+
+    std::size_t bytes_written0 = 0, bytes_written1 = 0, num_written = 0;
+    if (count == 0) return std::make_tuple(bytes_written0, bytes_written1, num_written);
+    threads = std::clamp(threads, std::size_t(1), count);
+
+    detail::keygen_ring<key_parts> ring(threads * detail::keygen_slots_per_thread);
+    std::atomic_size_t next{0};
+    std::exception_ptr worker_error = nullptr;
+    std::mutex error_mutex;
+
+    auto worker = [&]()
+    {
+        try
+        {
+            for (std::size_t ticket = next++; ticket < count; ticket = next++)
+            {
+                auto sampler = root_sampler;
+                if (!ring.put(ticket, dpf::detail::make_dpf_impl<InteriorPRG, ExteriorPRG>(args, std::move(sampler)))) return;
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (worker_error == nullptr) worker_error = std::current_exception();
+            ring.cancel();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    auto join = [&]()
+    {
+        ring.cancel();
+        for (auto & thread : pool) thread.join();
+    };
+    try
+    {
+        for (std::size_t t = 0; t < threads; ++t) pool.emplace_back(worker);
+    }
+    catch (...)
+    {
+        // proceed with however many workers could be started
+        if (pool.empty()) throw;
+    }
+
+    for (; num_written < count; ++num_written)
+    {
+        key_parts * parts = ring.get(num_written);
+        if (parts == nullptr) break;
+
+        auto & [correction_words, correction_advice, priv0, priv1] = *parts;
+        auto & [root0, leaves0, beavers0, offset_share0] = priv0;
+        auto & [root1, leaves1, beavers1, offset_share1] = priv1;
+
+        bytes_written0 += ::asio::write(peer0,
+            std::array<::asio::const_buffer, 6>{
+                ::asio::buffer(&correction_words,  sizeof(correction_words_array)),
+                ::asio::buffer(&correction_advice, sizeof(correction_advice_array)),
+                ::asio::buffer(&root0,             sizeof(interior_node)),
+                ::asio::buffer(&leaves0,           sizeof(leaf_tuple)),
+                ::asio::buffer(&beavers0,          sizeof(beaver_tuple)),
+                ::asio::buffer(&offset_share0,     sizeof(input_type))
+            }, error);
+        if (error) break;
+
+        bytes_written1 += ::asio::write(peer1,
+            std::array<::asio::const_buffer, 6>{
+                ::asio::buffer(&correction_words,  sizeof(correction_words_array)),
+                ::asio::buffer(&correction_advice, sizeof(correction_advice_array)),
+                ::asio::buffer(&root1,             sizeof(interior_node)),
+                ::asio::buffer(&leaves1,           sizeof(leaf_tuple)),
+                ::asio::buffer(&beavers1,          sizeof(beaver_tuple)),
+                ::asio::buffer(&offset_share1,     sizeof(input_type))
+            }, error);
+        if (error) break;
+
+        ring.release(num_written);
+    }
+    join();
+
+    if (worker_error != nullptr) std::rethrow_exception(worker_error);
+    return std::make_tuple(bytes_written0, bytes_written1, num_written);
+}
+
+template <typename InteriorPRG = dpf::prg::aes128,
+          typename ExteriorPRG = InteriorPRG,
+          typename PeerT,
+          typename InputT,
+          typename OutputT,
+          typename ...OutputTs>
+HEDLEY_ALWAYS_INLINE
+auto make_dpf_parallel(PeerT & peer0, PeerT & peer1, std::size_t count, const dpfargs<InputT, OutputT, OutputTs...> & args, std::size_t threads, root_sampler_t<InteriorPRG> root_sampler = dpf::uniform_sample<typename InteriorPRG::block_type>)
+{
+    ::asio::error_code error{};
+    auto ret = dpf::asio::make_dpf_parallel<InteriorPRG, ExteriorPRG>(peer0, peer1, count, args, threads, error, root_sampler);
+    if (error) throw error;
+    return ret;
+}
+
 //
 // async_make_dpf
 //
@@ -592,7 +592,9 @@ struct countl_zero_symmetric_difference<dpf::bitstring<Nbits, WordT>>
         for (auto i = lhs.data_length(); i > 0; --i,
             prefix_len += bitlength_of_v<word_type>)
         {
-            psnip_uint64_t limb = xor_op(lhs.data(i-1), rhs.data(i-1));
+            word_type limb = xor_op(lhs.data(i-1), rhs.data(i-1));
+            // the top word may carry bits past `Nbits` (e.g., from `~`)
+            if (i == lhs.data_length()) limb &= static_cast<word_type>(~word_type{0}) >> adjust;
             if (limb)
             {
                 return prefix_len + utils::clz(limb) - adjust;
@@ -0,0 +1,75 @@
+/// @file dpf/chacha_block.hpp
+/// @brief the scalar ChaCha block function
+/// @details Shared by `dpf::prg::chacha` and the DRBG in `dpf/random.hpp`.
+///          Depends on no SIMD headers, so `dpf/random.hpp` can use it
+///          without pulling in the PRGs.
+/// @author Ryan Henry <ryan.henry@ucalgary.ca>
+/// @copyright Copyright (c) 2019-2024 Ryan Henry and [others](@ref authors)
+/// @license Released under a GNU General Public v2.0 (GPLv2) license;
+///          see [LICENSE.md](@ref license) for details.
+
+#ifndef LIBDPF_INCLUDE_DPF_CHACHA_BLOCK_HPP__
+#define LIBDPF_INCLUDE_DPF_CHACHA_BLOCK_HPP__
+
+#include <cstddef>
+#include <algorithm>
+
+#include "hedley/hedley.h"
+#include "portable-snippets/exact-int/exact-int.h"
+
+namespace dpf
+{
+
+namespace prg
+{
+
+namespace detail
+{
+
+HEDLEY_ALWAYS_INLINE
+HEDLEY_CONST
+constexpr psnip_uint32_t chacha_rotl(psnip_uint32_t x, int r) noexcept
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+HEDLEY_ALWAYS_INLINE
+void chacha_quarter_round(psnip_uint32_t & a, psnip_uint32_t & b,
+    psnip_uint32_t & c, psnip_uint32_t & d) noexcept
+{
+    a += b; d ^= a; d = chacha_rotl(d, 16);
+    c += d; b ^= c; b = chacha_rotl(b, 12);
+    a += b; d ^= a; d = chacha_rotl(d, 8);
+    c += d; b ^= c; b = chacha_rotl(b, 7);
+}
+
+/// @brief one ChaCha block function (rounds plus feed-forward)
+template <std::size_t Rounds>
+HEDLEY_NO_THROW
+void chacha_block(const psnip_uint32_t (&in)[16],
+    psnip_uint32_t (&out)[16]) noexcept
+{
+    static_assert(Rounds % 2 == 0, "ChaCha requires an even round count");
+    std::copy_n(in, 16, out);
+    for (std::size_t r = 0; r < Rounds; r += 2)
+    {
+        chacha_quarter_round(out[0], out[4], out[8], out[12]);
+        chacha_quarter_round(out[1], out[5], out[9], out[13]);
+        chacha_quarter_round(out[2], out[6], out[10], out[14]);
+        chacha_quarter_round(out[3], out[7], out[11], out[15]);
+        chacha_quarter_round(out[0], out[5], out[10], out[15]);
+        chacha_quarter_round(out[1], out[6], out[11], out[12]);
+        chacha_quarter_round(out[2], out[7], out[8], out[13]);
+        chacha_quarter_round(out[3], out[4], out[9], out[14]);
+    }
+HEDLEY_PRAGMA(GCC unroll 16)
+    for (std::size_t w = 0; w < 16; ++w) out[w] += in[w];
+}
+
+}  // namespace detail
+
+}  // namespace prg
+
+}  // namespace dpf
+
+#endif  // LIBDPF_INCLUDE_DPF_CHACHA_BLOCK_HPP__
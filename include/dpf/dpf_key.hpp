@@ -10,11 +10,14 @@
 #define LIBDPF_INCLUDE_DPF_DPF_KEY_HPP__
 
 #include <cstddef>
+#include <algorithm>
 #include <utility>
 #include <tuple>
 #include <array>
 #include <bitset>
 #include <atomic>
+#include <iterator>
+#include <vector>
 
 #include "dpf/prg_aes.hpp"
 #include "dpf/wildcard.hpp"
@@ -169,7 +172,6 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
         mutable_wildcard_mask_{dpf::utils::make_bitset(dpf::is_wildcard_v<OutputT>,
             dpf::is_wildcard_v<OutputTs>...)},
         leaf_nodes(get_wrappers(leaves, beavers)),
-        common_part_hash_{utils::get_common_part_hash(correction_words_, correction_advice_, leaf_nodes, wildcard_mask)},
         offset_x{offset_share}
     { }
     dpf_key(const dpf_key &) = delete;
@@ -178,7 +180,28 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
     const interior_node & root() const { return root_; }
     const correction_words_array & correction_words() const { return correction_words_; }
     const correction_advice_array & correction_advice() const { return correction_advice_; }
-    const digest_type & common_part_hash() const { return common_part_hash_; }
+    /// @brief hash of the correction words, advice, and non-wildcard leaves
+    /// @details Computed on first use. Wildcard leaves are always hashed as
+    ///          a zero byte, so assigning them does not change the hash.
+    const digest_type & common_part_hash() const
+    {
+        return common_part_hash_.get([this]()
+            {
+                return utils::get_common_part_hash(correction_words_,
+                    correction_advice_, leaf_nodes, wildcard_mask);
+            });
+    }
+    /// @brief hash of the correction words and advice only; memoizers use
+    ///        it so that keys differing only in their leaves share levels
+    /// @details Computed on first use.
+    const digest_type & interior_hash() const
+    {
+        return interior_hash_.get([this]()
+            {
+                return utils::get_interior_hash(correction_words_,
+                    correction_advice_);
+            });
+    }
 
     std::string wildcard_bitmask() const
     {
@@ -214,6 +237,87 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
             interior_prg::eval(unset_lo_2bits(node), dir), cw, node);
     }
 
+    /// @brief traverses `count` nodes in the same direction
+    /// @details Writes the `dir`-child of `nodes[i]` to `out[i]`. The PRG is
+    ///          invoked on batches of nodes so that it can keep several
+    ///          blocks in flight. `nodes` and `out` may alias.
+    HEDLEY_NO_THROW
+    static void traverse_interior(const interior_node * nodes,
+        const interior_node & cw, bool dir, interior_node * out,
+        std::size_t count) noexcept
+    {
+        interior_node parents[traversal_batch], seeds[traversal_batch],
+            children[traversal_batch];
+        for (std::size_t i = 0; i < count; i += traversal_batch)
+        {
+            std::size_t n = std::min(traversal_batch, count - i);
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                parents[k] = nodes[i+k];
+                seeds[k] = unset_lo_2bits(parents[k]);
+            }
+            interior_prg::eval_many(seeds, dir, children, n);
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                out[i+k] = dpf::xor_if_lo_bit(children[k], cw, parents[k]);
+            }
+        }
+    }
+
+    /// @brief traverses `count` nodes in both directions
+    /// @details Writes the left and right children of `nodes[i]` to
+    ///          `out[2*i]` and `out[2*i+1]`, respectively. `nodes` and `out`
+    ///          may alias, provided that no child overwrites a node that
+    ///          comes after its parent.
+    HEDLEY_NO_THROW
+    HEDLEY_ALWAYS_INLINE
+    static void traverse_interior(const interior_node * nodes,
+        const interior_node (&cw)[2], interior_node * out,
+        std::size_t count) noexcept
+    {
+        traverse_interior(nodes, cw, count, out, count);
+    }
+
+    /// @brief traverses `count` nodes in both directions, with a separate
+    ///        pair of correction words for each group of `nodes_per_cw`
+    ///        consecutive nodes
+    /// @details As above, except that `nodes[i]` is corrected by
+    ///          `cws[2*g]` (left) and `cws[2*g+1]` (right), where
+    ///          `g = i / nodes_per_cw`. Used to advance several keys'
+    ///          trees in lockstep, so that the PRG can interleave blocks
+    ///          from different keys.
+    HEDLEY_NO_THROW
+    static void traverse_interior(const interior_node * nodes,
+        const interior_node * cws, std::size_t nodes_per_cw,
+        interior_node * out, std::size_t count) noexcept
+    {
+        interior_node parents[traversal_batch], seeds[traversal_batch],
+            children[2][traversal_batch];
+        const interior_node * cw = cws;
+        std::size_t left_in_group = nodes_per_cw;
+        for (std::size_t i = 0; i < count; i += traversal_batch)
+        {
+            std::size_t n = std::min(traversal_batch, count - i);
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                parents[k] = nodes[i+k];
+                seeds[k] = unset_lo_2bits(parents[k]);
+            }
+            interior_prg::eval_many(seeds, 0, children[0], n);
+            interior_prg::eval_many(seeds, 1, children[1], n);
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                out[2*(i+k)] = dpf::xor_if_lo_bit(children[0][k], cw[0], parents[k]);
+                out[2*(i+k)+1] = dpf::xor_if_lo_bit(children[1][k], cw[1], parents[k]);
+                if (--left_in_group == 0)
+                {
+                    cw += 2;
+                    left_in_group = nodes_per_cw;
+                }
+            }
+        }
+    }
+
     template <std::size_t I = 0,
               typename LeafT>
     HEDLEY_NO_THROW
@@ -245,6 +349,8 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
         dpf::is_wildcard_v<OutputTs>...};
 
   private:
+    static constexpr std::size_t traversal_batch = 32;
+
     static auto get_wrappers(const leaf_tuple & leaves,
                              const beaver_tuple & beavers)
     {
@@ -270,7 +376,8 @@ HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
 HEDLEY_PRAGMA(GCC diagnostic pop)
     correction_advice_array correction_advice_;
     std::bitset<sizeof...(OutputTs)+1> mutable_wildcard_mask_;
-    digest_type common_part_hash_;
+    utils::lazy_digest<> common_part_hash_;
+    utils::lazy_digest<> interior_hash_;
 };  // struct dpf_key
 
 template <typename PRG>
@@ -448,6 +555,193 @@ auto make_dpf(InputT && x, OutputTs && ...ys)
     return make_dpf<InteriorPRG, ExteriorPRG>(dpf::make_dpfargs(x, ys...));
 }
 
+namespace detail
+{
+
+// number of keys whose trees `make_dpfs` grows in lockstep
+static constexpr std::size_t keygen_batch = 32;
+
+/// @brief generates the key pairs for `args[0..count)`, appending them to
+///        `dpfs0` and `dpfs1`
+/// @details Computes the same keys as calling `make_dpf_impl` on each of
+///          `args` in turn; but the trees of up to `keygen_batch` keys are
+///          grown level by level in lockstep so that the `4 * keygen_batch`
+///          PRG calls per level are issued through `eval_many`, which keeps
+///          the AES pipeline full. The leaves of the batch are likewise
+///          expanded with one `ExteriorPRG::eval_many` per leaf block. A
+///          custom `root_sampler` is called exactly as `make_dpf_impl` calls
+///          it, so the keys are identical, key for key. The default sampler
+///          is instead replaced by one `uniform_fill` of the batch's `2*n`
+///          roots; the keys are then distributed as, but not bit-identical
+///          to, those of `make_dpf_impl`.
+template <typename InteriorPRG,
+          typename ExteriorPRG,
+          typename InputT,
+          typename OutputT,
+          typename ...OutputTs,
+          typename DpfKeys>
+void make_dpfs_impl(const dpfargs<InputT, OutputT, OutputTs...> * args,
+    std::size_t count, root_sampler_t<InteriorPRG> root_sampler,
+    DpfKeys & dpfs0, DpfKeys & dpfs1)  // NOLINT(runtime/references)
+{
+    using dpf_type = utils::dpf_type_t<InteriorPRG, ExteriorPRG, InputT,
+                                       OutputT, OutputTs...>;
+    using interior_node = typename dpf_type::interior_node;
+    using input_type = typename dpf_type::input_type;
+    using correction_words_array = typename dpf_type::correction_words_array;
+    using correction_advice_array = typename dpf_type::correction_advice_array;
+    using exterior_node = typename dpf_type::exterior_node;
+    using leaf_tuple = typename dpf_type::leaf_tuple;
+
+    constexpr auto depth = dpf_type::depth;
+    const bool default_sampler = root_sampler
+        == &dpf::uniform_sample<typename InteriorPRG::block_type>;
+
+    input_type xs[keygen_batch], x0s[keygen_batch]{}, x1s[keygen_batch]{};
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    // lanes 2k and 2k+1 hold the two shares of key k
+    interior_node roots[2*keygen_batch], parents[2*keygen_batch],
+        children[2][2*keygen_batch];
+    std::vector<correction_words_array> correction_words(keygen_batch);
+    std::vector<leaf_tuple> leaf_masks(2*keygen_batch);
+HEDLEY_PRAGMA(GCC diagnostic pop)
+    std::vector<correction_advice_array> correction_advice(keygen_batch);
+    bool advice[2*keygen_batch];
+
+    for (std::size_t i = 0; i < count; i += keygen_batch)
+    {
+        std::size_t n = std::min(keygen_batch, count - i);
+
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            if constexpr (dpf::is_wildcard_v<InputT>)
+            {
+                std::tie(xs[k], x0s[k], x1s[k]) = args[i+k].x();
+            }
+            else
+            {
+                xs[k] = args[i+k].x;
+            }
+            utils::flip_msb_if_signed_integral(xs[k]);
+        }
+
+        if (default_sampler)
+        {
+            dpf::uniform_fill(roots, 2*n);
+        }
+        else
+        {
+            for (std::size_t j = 0; j < 2*n; ++j) roots[j] = root_sampler();
+        }
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            roots[2*k] = dpf::unset_lo_bit(roots[2*k]);
+            roots[2*k+1] = dpf::set_lo_bit(roots[2*k+1]);
+            parents[2*k] = roots[2*k];
+            parents[2*k+1] = roots[2*k+1];
+        }
+
+        auto mask = dpf_type::msb_mask;
+        for (std::size_t level = 0; level < depth; ++level, mask >>= 1)
+        {
+            for (std::size_t j = 0; j < 2*n; ++j)
+            {
+                advice[j] = dpf::get_lo_bit_and_clear_lo_2bits(parents[j]);
+            }
+            InteriorPRG::eval_many(parents, 0, children[0], 2*n);
+            InteriorPRG::eval_many(parents, 1, children[1], 2*n);
+
+            // see `make_dpf_impl`
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                bool bit = !!(mask & xs[k]);
+                interior_node child[2] = {
+                    children[0][2*k] ^ children[0][2*k+1],
+                    children[1][2*k] ^ children[1][2*k+1]
+                };
+
+                bool t[2] = {
+                    static_cast<bool>(dpf::get_lo_bit(child[0]) ^ !bit),
+                    static_cast<bool>(dpf::get_lo_bit(child[1]) ^ bit)
+                };
+                auto cw = dpf::set_lo_bit(child[!bit], t[bit]);
+                parents[2*k] = dpf::xor_if(children[bit][2*k], cw, advice[2*k]);
+                parents[2*k+1] = dpf::xor_if(children[bit][2*k+1], cw, advice[2*k+1]);
+
+                correction_words[k][level] = child[!bit];
+                correction_advice[k][level] = static_cast<psnip_uint8_t>(t[1] << 1) | t[0];
+            }
+        }
+
+        bool signs[keygen_batch];
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            signs[k] = dpf::get_lo_bit(parents[2*k]);
+            parents[2*k] = dpf::unset_lo_2bits(parents[2*k]);
+            parents[2*k+1] = dpf::unset_lo_2bits(parents[2*k+1]);
+        }
+        // expand all 2n final seeds together, one `eval_many` per leaf block
+        dpf::make_leaf_masks_many<ExteriorPRG, std::decay_t<OutputT>,
+            std::decay_t<OutputTs>...>(parents, 2*n, leaf_masks.data());
+
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            auto [pair0, pair1] = std::apply([&](auto && ...ys)
+                {
+                    return dpf::make_leaves_from_masks<exterior_node>(xs[k],
+                                                                      leaf_masks[2*k],
+                                                                      leaf_masks[2*k+1],
+                                                                      signs[k], ys...); }, args[i+k].y);
+            auto && [leaves0, beavers0] = pair0;
+            auto && [leaves1, beavers1] = pair1;
+
+            dpfs0.emplace_back(roots[2*k], correction_words[k],
+                correction_advice[k], leaves0, beavers0, x0s[k]);
+            dpfs1.emplace_back(roots[2*k+1], correction_words[k],
+                correction_advice[k], leaves1, beavers1, x1s[k]);
+        }
+    }
+}  // make_dpfs_impl
+
+}  // namespace detail
+
+/// @brief generates a key pair for each of `args[0..count)`
+/// @details Equivalent to calling `dpf::make_dpf` on each of `args` in
+///          turn, but several times faster; see `detail::make_dpfs_impl`.
+/// @return a pair of vectors holding, respectively, the first and second
+///         key of each pair, in the order of `args`
+template <typename InteriorPRG = dpf::prg::aes128,
+          typename ExteriorPRG = InteriorPRG,
+          typename InputT,
+          typename OutputT,
+          typename ...OutputTs>
+auto make_dpfs(const dpfargs<InputT, OutputT, OutputTs...> * args,
+    std::size_t count, root_sampler_t<InteriorPRG> root_sampler = dpf::uniform_sample<typename InteriorPRG::block_type>)
+{
+    using dpf_type = utils::dpf_type_t<InteriorPRG, ExteriorPRG, InputT,
+                                       OutputT, OutputTs...>;
+
+    std::pair<std::vector<dpf_type>, std::vector<dpf_type>> dpfs;
+    dpfs.first.reserve(count);
+    dpfs.second.reserve(count);
+    detail::make_dpfs_impl<InteriorPRG, ExteriorPRG>(args, count,
+        root_sampler, dpfs.first, dpfs.second);
+    return dpfs;
+}  // make_dpfs
+
+/// @brief generates a key pair for each `dpfargs` in the contiguous range
+///        `args`
+template <typename InteriorPRG = dpf::prg::aes128,
+          typename ExteriorPRG = InteriorPRG,
+          typename DpfArgs>
+auto make_dpfs(const DpfArgs & args,
+    root_sampler_t<InteriorPRG> root_sampler = dpf::uniform_sample<typename InteriorPRG::block_type>)
+{
+    return make_dpfs<InteriorPRG, ExteriorPRG>(std::data(args),
+        std::size(args), root_sampler);
+}
+
 template <typename InteriorPRG = dpf::prg::aes128,
           typename ExteriorPRG = InteriorPRG,
           typename InputT,
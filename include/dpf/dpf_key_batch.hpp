@@ -0,0 +1,381 @@
+/// @file dpf/dpf_key_batch.hpp
+/// @brief column-wise storage for many DPF keys of the same type
+/// @details A `dpf::dpf_key_batch` holds the roots of all of its keys in one
+///          array, the correction words (and advice) for each level in one
+///          array per level, and the leaves in one array, rather than one
+///          self-contained `dpf_key` object per key. Loading many keys thus
+///          touches a few long arrays, and the per-key extras of `dpf_key`
+///          (wildcard bitset, offset share, cached common-part digest) go
+///          away.
+///
+///          Individual keys are accessed through `dpf::dpf_key_view`
+///          handles, which offer the same interface as `dpf_key` and so can
+///          be passed to the `eval_*` functions, memoizers, and batched
+///          evaluators (e.g., `dpf::eval_full_batch` and
+///          `dpf::accumulate_full` on `batch.views()`).
+///
+///          Only keys without wildcard inputs or outputs can be batched.
+/// @author Ryan Henry <ryan.henry@ucalgary.ca>
+/// @copyright Copyright (c) 2019-2024 Ryan Henry and [others](@ref authors)
+/// @license Released under a GNU General Public v2.0 (GPLv2) license;
+///          see [LICENSE.md](@ref license) for details.
+
+#ifndef LIBDPF_INCLUDE_DPF_DPF_KEY_BATCH_HPP__
+#define LIBDPF_INCLUDE_DPF_DPF_KEY_BATCH_HPP__
+
+#include <hedley/hedley.h>
+
+#include <cstddef>
+#include <array>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "dpf/dpf_key.hpp"
+#include "dpf/utils.hpp"
+#include "dpf/wildcard.hpp"
+
+namespace dpf
+{
+
+template <typename DpfKey>
+class dpf_key_batch;
+
+/// @brief a lightweight handle to the `index`th key of a `dpf_key_batch`
+/// @details Usable wherever a `const DpfKey &` is expected by the
+///          evaluation functions. Valid until the batch is modified.
+template <typename DpfKey>
+class dpf_key_view
+{
+  public:
+    using key_type = DpfKey;
+    using batch_type = dpf_key_batch<DpfKey>;
+
+    using interior_prg = typename DpfKey::interior_prg;
+    using interior_node = typename DpfKey::interior_node;
+    using exterior_prg = typename DpfKey::exterior_prg;
+    using exterior_node = typename DpfKey::exterior_node;
+    using input_type = typename DpfKey::input_type;
+    using raw_input_type = typename DpfKey::raw_input_type;
+    using integral_type = typename DpfKey::integral_type;
+    using outputs_tuple = typename DpfKey::outputs_tuple;
+    template <std::size_t I>
+    using output_type_t = typename DpfKey::template output_type_t<I>;
+    using concrete_outputs_tuple = typename DpfKey::concrete_outputs_tuple;
+    template <std::size_t I>
+    using concrete_output_type = typename DpfKey::template concrete_output_type<I>;
+    using offset_type = typename DpfKey::offset_type;
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    using leaf_tuple = typename DpfKey::leaf_tuple;
+    using beaver_tuple = typename DpfKey::beaver_tuple;
+    using leaf_wrapper_tuple = typename DpfKey::leaf_wrapper_tuple;
+    using correction_words_array = typename DpfKey::correction_words_array;
+HEDLEY_PRAGMA(GCC diagnostic pop)
+    using correction_advice_array = typename DpfKey::correction_advice_array;
+
+    static constexpr std::size_t outputs_per_leaf = DpfKey::outputs_per_leaf;
+    static constexpr std::size_t lg_outputs_per_leaf = DpfKey::lg_outputs_per_leaf;
+    static constexpr std::size_t depth = DpfKey::depth;
+    static constexpr auto msb_mask = DpfKey::msb_mask;
+    static constexpr auto wildcard_mask = DpfKey::wildcard_mask;
+
+    dpf_key_view(const batch_type & batch, std::size_t index)
+      : leaf_nodes{batch.leaf_nodes_[index]},
+        offset_x{},
+        batch_{&batch},
+        index_{index}
+    { }
+
+    HEDLEY_ALWAYS_INLINE
+    const interior_node & root() const { return batch_->roots_[index_]; }
+
+    /// @brief the batch this key lives in, and its position there
+    const batch_type & batch() const noexcept { return *batch_; }
+    std::size_t index() const noexcept { return index_; }
+
+    /// @brief gathers this key's correction words from the batch's columns
+    correction_words_array correction_words() const
+    {
+        correction_words_array cws;
+        for (std::size_t level = 0; level < depth; ++level)
+        {
+            cws[level] = correction_word(level);
+        }
+        return cws;
+    }
+
+    /// @brief gathers this key's correction advice from the batch's columns
+    correction_advice_array correction_advice() const
+    {
+        correction_advice_array advice;
+        for (std::size_t level = 0; level < depth; ++level)
+        {
+            advice[level] = correction_advice(level);
+        }
+        return advice;
+    }
+
+    /// @brief as `dpf_key::common_part_hash`, but recomputed on each call
+    digest_type common_part_hash() const
+    {
+        return utils::get_common_part_hash(correction_words(),
+            correction_advice(), leaf_nodes, wildcard_mask);
+    }
+
+    /// @brief as `dpf_key::interior_hash`; cached by the batch
+    const digest_type & interior_hash() const
+    {
+        return batch_->interior_hashes_[index_].get([this]()
+            {
+                return utils::get_interior_hash(correction_words(),
+                    correction_advice());
+            });
+    }
+
+    HEDLEY_ALWAYS_INLINE
+    const interior_node & correction_word(std::size_t level) const
+    {
+        return batch_->correction_words_[level][index_];
+    }
+
+    HEDLEY_ALWAYS_INLINE
+    psnip_uint8_t correction_advice(std::size_t level) const
+    {
+        return batch_->correction_advice_[level][index_];
+    }
+
+    HEDLEY_ALWAYS_INLINE
+    auto correction_word(std::size_t level, bool direction) const
+    {
+        return set_lo_bit(correction_word(level),
+            (correction_advice(level) >> direction) & 1);
+    }
+
+    HEDLEY_NO_THROW
+    HEDLEY_ALWAYS_INLINE
+    static auto traverse_interior(const interior_node & node,
+        const interior_node & cw, bool dir) noexcept
+    {
+        return DpfKey::traverse_interior(node, cw, dir);
+    }
+
+    HEDLEY_NO_THROW
+    HEDLEY_ALWAYS_INLINE
+    static void traverse_interior(const interior_node * nodes,
+        const interior_node & cw, bool dir, interior_node * out,
+        std::size_t count) noexcept
+    {
+        DpfKey::traverse_interior(nodes, cw, dir, out, count);
+    }
+
+    HEDLEY_NO_THROW
+    HEDLEY_ALWAYS_INLINE
+    static void traverse_interior(const interior_node * nodes,
+        const interior_node (&cw)[2], interior_node * out,
+        std::size_t count) noexcept
+    {
+        DpfKey::traverse_interior(nodes, cw, out, count);
+    }
+
+    HEDLEY_NO_THROW
+    HEDLEY_ALWAYS_INLINE
+    static void traverse_interior(const interior_node * nodes,
+        const interior_node * cws, std::size_t nodes_per_cw,
+        interior_node * out, std::size_t count) noexcept
+    {
+        DpfKey::traverse_interior(nodes, cws, nodes_per_cw, out, count);
+    }
+
+    template <std::size_t I = 0,
+              typename LeafT>
+    HEDLEY_NO_THROW
+    HEDLEY_ALWAYS_INLINE
+    static auto traverse_exterior(const interior_node & node,
+        const LeafT & correction_word) noexcept
+    {
+        return DpfKey::template traverse_exterior<I>(node, correction_word);
+    }
+
+    template <std::size_t I = 0>
+    HEDLEY_NO_THROW
+    HEDLEY_ALWAYS_INLINE
+    auto traverse_exterior(const interior_node & node) const noexcept
+    {
+        return traverse_exterior<I>(node, std::get<I>(leaf_nodes).get());
+    }
+
+    const leaf_wrapper_tuple & leaf_nodes;
+    const offset_type offset_x;
+
+  private:
+    const batch_type * batch_;
+    std::size_t index_;
+};  // class dpf_key_view
+
+/// @brief stores keys of type `DpfKey` column-wise
+/// @details `correction_words(level)` points to the `level`th correction
+///          word of every key, in order, so lockstep evaluation of many keys
+///          reads each level's correction words with one sequential scan.
+template <typename DpfKey>
+class dpf_key_batch
+{
+  public:
+    using key_type = DpfKey;
+    using view_type = dpf_key_view<DpfKey>;
+    using interior_node = typename DpfKey::interior_node;
+    using input_type = typename DpfKey::input_type;
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    using leaf_tuple = typename DpfKey::leaf_tuple;
+    using beaver_tuple = typename DpfKey::beaver_tuple;
+    using leaf_wrapper_tuple = typename DpfKey::leaf_wrapper_tuple;
+    using correction_words_array = typename DpfKey::correction_words_array;
+HEDLEY_PRAGMA(GCC diagnostic pop)
+    using correction_advice_array = typename DpfKey::correction_advice_array;
+
+    static constexpr std::size_t depth = DpfKey::depth;
+
+    static_assert(!dpf::is_wildcard_v<typename DpfKey::raw_input_type>,
+        "dpf_key_batch does not support wildcard inputs");
+    static_assert(std::apply([](auto ...is_wildcard) { return !(is_wildcard || ...); },
+        DpfKey::wildcard_mask), "dpf_key_batch does not support wildcard outputs");
+
+    dpf_key_batch() = default;
+    dpf_key_batch(dpf_key_batch &&) = default;
+    dpf_key_batch & operator=(dpf_key_batch &&) = default;
+    // views point into the batch, so copying would be error-prone
+    dpf_key_batch(const dpf_key_batch &) = delete;
+    dpf_key_batch & operator=(const dpf_key_batch &) = delete;
+
+    std::size_t size() const noexcept { return std::size(roots_); }
+    bool empty() const noexcept { return std::empty(roots_); }
+
+    void reserve(std::size_t count)
+    {
+        roots_.reserve(count);
+        for (auto & column : correction_words_) column.reserve(count);
+        for (auto & column : correction_advice_) column.reserve(count);
+        leaf_nodes_.reserve(count);
+        interior_hashes_.reserve(count);
+    }
+
+    /// @brief appends a key from its parts; the signature matches
+    ///        `dpf_key`'s constructor, so `dpf::asio::read_dpf` can read
+    ///        keys straight into a batch
+    void emplace_back(const interior_node & root,
+        const correction_words_array & correction_words,
+        const correction_advice_array & correction_advice,
+        const leaf_tuple & leaves,
+        const beaver_tuple & beavers,
+        const input_type &)
+    {
+        append(root, correction_words, correction_advice,
+            make_wrappers(leaves, beavers,
+                std::make_index_sequence<std::tuple_size_v<leaf_tuple>>()));
+    }
+
+    /// @brief appends a copy of `dpf`
+    void push_back(const DpfKey & dpf)
+    {
+        append(dpf.root(), dpf.correction_words(), dpf.correction_advice(),
+            dpf.leaf_nodes);
+    }
+
+    HEDLEY_ALWAYS_INLINE
+    view_type operator[](std::size_t index) const
+    {
+        return view_type(*this, index);
+    }
+
+    view_type at(std::size_t index) const
+    {
+        if (HEDLEY_UNLIKELY(index >= size()))
+        {
+            throw std::out_of_range("index is out of range");
+        }
+        return (*this)[index];
+    }
+
+    /// @brief a view of each key, in order, for functions that take a
+    ///        contiguous range of keys
+    std::vector<view_type> views() const
+    {
+        std::vector<view_type> ret;
+        ret.reserve(size());
+        for (std::size_t i = 0; i < size(); ++i) ret.emplace_back(*this, i);
+        return ret;
+    }
+
+    const interior_node * roots() const noexcept { return std::data(roots_); }
+
+    /// @brief the `level`th correction word of each key, in order
+    const interior_node * correction_words(std::size_t level) const noexcept
+    {
+        return std::data(correction_words_[level]);
+    }
+
+    /// @brief the `level`th correction advice of each key, in order
+    const psnip_uint8_t * correction_advice(std::size_t level) const noexcept
+    {
+        return std::data(correction_advice_[level]);
+    }
+
+  private:
+    template <std::size_t ...Is>
+    static auto make_wrappers(const leaf_tuple & leaves,
+        const beaver_tuple & beavers, std::index_sequence<Is...>)
+    {
+        return leaf_wrapper_tuple(std::tuple_element_t<Is, leaf_wrapper_tuple>(
+            std::get<Is>(leaves), std::get<Is>(beavers))...);
+    }
+
+    void append(const interior_node & root,
+        const correction_words_array & correction_words,
+        const correction_advice_array & correction_advice,
+        const leaf_wrapper_tuple & leaves)
+    {
+        roots_.push_back(root);
+        for (std::size_t level = 0; level < depth; ++level)
+        {
+            correction_words_[level].push_back(correction_words[level]);
+            correction_advice_[level].push_back(correction_advice[level]);
+        }
+        leaf_nodes_.push_back(leaves);
+        interior_hashes_.emplace_back();
+    }
+
+    friend view_type;
+
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    std::vector<interior_node> roots_;
+    std::array<std::vector<interior_node>, depth> correction_words_;
+HEDLEY_PRAGMA(GCC diagnostic pop)
+    std::array<std::vector<psnip_uint8_t>, depth> correction_advice_;
+    std::vector<leaf_wrapper_tuple> leaf_nodes_;
+    mutable std::vector<utils::lazy_digest<>> interior_hashes_;
+};  // class dpf_key_batch
+
+/// @brief packs `dpfs[0..count)` into a new `dpf_key_batch`
+template <typename DpfKey>
+auto make_dpf_key_batch(const DpfKey * dpfs, std::size_t count)
+{
+    dpf_key_batch<DpfKey> batch;
+    batch.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) batch.push_back(dpfs[i]);
+    return batch;
+}
+
+/// @brief packs the keys in the contiguous range `dpfs` into a new
+///        `dpf_key_batch`
+template <typename DpfKeys>
+auto make_dpf_key_batch(const DpfKeys & dpfs)
+{
+    return make_dpf_key_batch(std::data(dpfs), std::size(dpfs));
+}
+
+}  // namespace dpf
+
+#endif  // LIBDPF_INCLUDE_DPF_DPF_KEY_BATCH_HPP__
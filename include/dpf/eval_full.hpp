@@ -91,7 +91,7 @@ template <std::size_t I = 0,
           std::size_t ...Is,
           typename DpfKey,
           typename OutputBuffers,
-          std::enable_if_t<!std::is_base_of_v<dpf::interval_memoizer_base<DpfKey>,
+          std::enable_if_t<!std::is_base_of_v<dpf::interval_memoizer_tag_,
               std::decay_t<OutputBuffers>>, bool> = true>
 HEDLEY_ALWAYS_INLINE
 auto eval_full(const DpfKey & dpf, OutputBuffers & outbufs)  // NOLINT(runtime/references)
@@ -105,7 +105,7 @@ template <std::size_t I = 0,
           std::size_t ...Is,
           typename DpfKey,
           typename IntervalMemoizer,
-          std::enable_if_t<std::is_base_of_v<dpf::interval_memoizer_base<DpfKey>,
+          std::enable_if_t<std::is_base_of_v<dpf::interval_memoizer_tag_,
               std::decay_t<IntervalMemoizer>>, bool> = true>
 HEDLEY_ALWAYS_INLINE
 auto eval_full(const DpfKey & dpf,
@@ -0,0 +1,355 @@
+/// @file dpf/eval_full_batch.hpp
+/// @brief lockstep full-domain evaluation of a batch of keys
+/// @details Evaluates several keys (e.g., one per client query) over the
+///          full domain by walking all of their trees together. Within each
+///          block of `2^lg_block` leaf nodes, level `l` of every key is
+///          stored contiguously (key-major) and advanced with a single call
+///          to `traverse_interior`, so that the PRG interleaves blocks from
+///          different keys even where each individual tree is still narrow.
+///          Above the blocks, each key keeps its own root-to-block path as
+///          in `dpf::eval_full_depth_first`.
+///
+///          `dpf::eval_full_dot_batch` fuses this with a database scan, so
+///          that each record is read once per batch rather than once per
+///          key.
+///
+///          Scratch memory is `2 * keys * 2^lg_block` interior nodes.
+/// @author Ryan Henry <ryan.henry@ucalgary.ca>
+/// @copyright Copyright (c) 2019-2024 Ryan Henry and [others](@ref authors)
+/// @license Released under a GNU General Public v2.0 (GPLv2) license;
+///          see [LICENSE.md](@ref license) for details.
+
+#ifndef LIBDPF_INCLUDE_DPF_EVAL_FULL_BATCH_HPP__
+#define LIBDPF_INCLUDE_DPF_EVAL_FULL_BATCH_HPP__
+
+#include <portable-snippets/builtin/builtin.h>
+#include <hedley/hedley.h>
+
+#include <cstddef>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "dpf/dpf_key.hpp"
+#include "dpf/dpf_key_batch.hpp"
+#include "dpf/eval_common.hpp"
+#include "dpf/output_buffer.hpp"
+#include "dpf/wildcard.hpp"
+#include "dpf/eval_interval.hpp"
+#include "dpf/eval_full_depth_first.hpp"
+#include "dpf/eval_full_dot.hpp"
+
+namespace dpf
+{
+
+namespace internal
+{
+
+/// @brief writes the correction words of `dpfs[0..keys)` on levels
+///        `[first_level, first_level + levels)` to `cws`, where
+///        `cws[(l*keys + k)*2 + dir]` is key `k`'s word below level
+///        `first_level + l`
+template <typename DpfKey>
+void gather_correction_words_by_key(const DpfKey * dpfs, std::size_t keys,
+    std::size_t first_level, std::size_t levels,
+    typename DpfKey::interior_node * cws)
+{
+    for (std::size_t k = 0; k < keys; ++k)
+    {
+        for (std::size_t l = 0; l < levels; ++l)
+        {
+            cws[(l*keys + k)*2] = dpfs[k].correction_word(first_level + l, 0);
+            cws[(l*keys + k)*2 + 1] = dpfs[k].correction_word(first_level + l, 1);
+        }
+    }
+}
+
+template <typename DpfKey>
+void gather_correction_words(const DpfKey * dpfs, std::size_t keys,
+    std::size_t first_level, std::size_t levels,
+    typename DpfKey::interior_node * cws)
+{
+    gather_correction_words_by_key(dpfs, keys, first_level, levels, cws);
+}
+
+/// @brief as above, but when `dpfs` are consecutive keys of one
+///        `dpf_key_batch` (e.g., from `batch.views()`), each level is read
+///        with one sequential scan of the batch's column for that level
+template <typename DpfKey>
+void gather_correction_words(const dpf_key_view<DpfKey> * dpfs,
+    std::size_t keys, std::size_t first_level, std::size_t levels,
+    typename DpfKey::interior_node * cws)
+{
+    if (keys == 0) return;
+    const auto & batch = dpfs[0].batch();
+    const std::size_t first = dpfs[0].index();
+    for (std::size_t k = 1; k < keys; ++k)
+    {
+        if (&dpfs[k].batch() != &batch || dpfs[k].index() != first + k)
+        {
+            gather_correction_words_by_key(dpfs, keys, first_level, levels,
+                cws);
+            return;
+        }
+    }
+
+    for (std::size_t l = 0; l < levels; ++l)
+    {
+        const auto * words = batch.correction_words(first_level + l) + first;
+        const auto * advice = batch.correction_advice(first_level + l) + first;
+        auto * out = &cws[l*keys*2];
+        for (std::size_t k = 0; k < keys; ++k)
+        {
+            out[2*k] = set_lo_bit(words[k], advice[k] & 1);
+            out[2*k + 1] = set_lo_bit(words[k], (advice[k] >> 1) & 1);
+        }
+    }
+}
+
+/// @brief expands the first `blocks` blocks of `2^lg_block` leaf nodes of
+///        each of `dpfs[0..keys)` in lockstep, calling
+///        `f(from_node, to_node, nodes)` after each one, where the parents of
+///        key `k`'s leaves are `nodes[k*2^lg_block..(k+1)*2^lg_block)`
+template <typename DpfKey,
+          typename Function,
+          typename IntegralT = typename DpfKey::integral_type>
+void eval_blocks_batch(const DpfKey * dpfs, std::size_t keys,
+    std::size_t lg_block, IntegralT blocks, Function && f)
+{
+    using dpf_type = DpfKey;
+    using integral_type = typename DpfKey::integral_type;
+    using node_type = typename DpfKey::interior_node;
+    constexpr auto depth = dpf_type::depth;
+    constexpr auto countr_zero = utils::countr_zero<std::size_t>{};
+
+    lg_block = std::min(lg_block, depth);
+    const std::size_t split = depth - lg_block,
+        block_len = std::size_t(1) << lg_block;
+
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    // paths[k*(split+1) + l] is key k's ancestor at level l of the block
+    std::vector<node_type> paths(keys * (split + 1));
+    // cws[(l*keys + k)*2 + dir] is key k's correction word below level split+l
+    std::vector<node_type> cws(2 * keys * lg_block);
+    std::vector<node_type> rows[2] = {
+        std::vector<node_type>(keys * block_len),
+        std::vector<node_type>(keys * block_len)
+    };
+HEDLEY_PRAGMA(GCC diagnostic pop)
+
+    for (std::size_t k = 0; k < keys; ++k)
+    {
+        paths[k * (split + 1)] = dpfs[k].root();
+    }
+    gather_correction_words(dpfs, keys, split, lg_block, cws.data());
+
+    for (integral_type block = 0; block < blocks; ++block)
+    {
+        // see `internal::eval_blocks_depth_first`
+        std::size_t first_level = 1;
+        if (block != 0)
+        {
+            first_level = split - countr_zero(static_cast<std::size_t>(block));
+        }
+        for (std::size_t k = 0; k < keys; ++k)
+        {
+            node_type * path = &paths[k * (split + 1)];
+            for (std::size_t level = first_level; level <= split; ++level)
+            {
+                bool dir = (block >> (split - level)) & 1;
+                path[level] = dpf_type::traverse_interior(path[level-1],
+                    dpfs[k].correction_word(level-1, dir), dir);
+            }
+            rows[0][k] = path[split];
+        }
+
+        std::size_t cur = 0;
+        for (std::size_t l = 0, nodes_per_key = 1; l < lg_block;
+            ++l, nodes_per_key <<= 1, cur ^= 1)
+        {
+            dpf_type::traverse_interior(rows[cur].data(), &cws[l*keys*2],
+                nodes_per_key, rows[cur^1].data(), keys * nodes_per_key);
+        }
+
+        integral_type from_node = block << lg_block,
+            to_node = (block + 1) << lg_block;
+        f(from_node, to_node, static_cast<const node_type *>(rows[cur].data()));
+    }
+}
+
+}  // namespace internal
+
+/// @brief evaluates output `I` of each of `dpfs[0..keys)` over the full
+///        domain, writing the result for `dpfs[k]` to `outbufs[k]`
+/// @details Each `outbufs[k]` holds exactly what `dpf::eval_full` would
+///          write for `dpfs[k]`.
+template <std::size_t I = 0,
+          typename DpfKey,
+          typename OutputBuffer>
+void eval_full_batch(const DpfKey * dpfs, std::size_t keys,
+    OutputBuffer * outbufs, std::size_t lg_block = default_lg_block)
+{
+    static_assert(!dpf::is_wildcard_v<typename DpfKey::raw_input_type>,
+        "eval_full_batch does not support wildcard inputs");
+    using integral_type = typename DpfKey::integral_type;
+    using node_type = typename DpfKey::interior_node;
+    constexpr auto depth = DpfKey::depth;
+
+    for (std::size_t k = 0; k < keys; ++k) assert_not_wildcard_output<I>(dpfs[k]);
+    if (keys == 0) return;
+
+    lg_block = std::min(lg_block, depth);
+    const std::size_t block_len = std::size_t(1) << lg_block;
+    internal::eval_blocks_batch(dpfs, keys, lg_block,
+        integral_type{1} << (depth - lg_block),
+        [&](integral_type from_node, integral_type, const node_type * nodes)
+        {
+            for (std::size_t k = 0; k < keys; ++k)
+            {
+                internal::eval_exterior_nodes<I>(dpfs[k], nodes + k*block_len,
+                    block_len, outbufs[k], static_cast<std::size_t>(from_node));
+            }
+        });
+}
+
+/// @brief evaluates output `I` of each key in the contiguous range `dpfs`
+///        into the corresponding buffer of `outbufs`
+template <std::size_t I = 0,
+          typename DpfKeys,
+          typename OutputBuffers,
+          std::enable_if_t<!std::is_pointer_v<std::decay_t<DpfKeys>>
+              && !std::is_integral_v<std::decay_t<OutputBuffers>>, bool> = true>
+HEDLEY_ALWAYS_INLINE
+void eval_full_batch(const DpfKeys & dpfs,
+    OutputBuffers & outbufs,  // NOLINT(runtime/references)
+    std::size_t lg_block = default_lg_block)
+{
+    if (HEDLEY_UNLIKELY(std::size(dpfs) != std::size(outbufs)))
+    {
+        throw std::invalid_argument("need exactly one output buffer per key");
+    }
+    eval_full_batch<I>(std::data(dpfs), std::size(dpfs), std::data(outbufs),
+        lg_block);
+}
+
+/// @brief evaluates output `I` of each key in the contiguous range `dpfs`
+/// @return a `std::vector` holding one output buffer per key
+template <std::size_t I = 0,
+          typename DpfKeys,
+          std::enable_if_t<!std::is_pointer_v<std::decay_t<DpfKeys>>, bool> = true>
+auto eval_full_batch(const DpfKeys & dpfs,
+    std::size_t lg_block = default_lg_block)
+{
+    using dpf_type = std::decay_t<decltype(*std::data(dpfs))>;
+    using output_buffer_type = decltype(make_output_buffer_for_full<dpf_type, I>());
+
+    std::vector<output_buffer_type> outbufs;
+    outbufs.reserve(std::size(dpfs));
+    for (std::size_t k = 0; k < std::size(dpfs); ++k)
+    {
+        outbufs.emplace_back(make_output_buffer_for_full<dpf_type, I>());
+    }
+    eval_full_batch<I>(dpfs, outbufs, lg_block);
+    return outbufs;
+}
+
+/// @brief computes, for each `k`, the inner product of the full-domain
+///        evaluation of output `I` of `dpfs[k]` with `database[0..records)`
+///        into `accs[k]`
+/// @details Equivalent to calling `dpf::eval_full_dot` once per key, except
+///          that the database is streamed through only once.
+template <std::size_t I = 0,
+          typename DpfKey,
+          typename Record,
+          typename Accumulator>
+void eval_full_dot_batch(const DpfKey * dpfs, std::size_t keys,
+    const Record * database, std::size_t records, Accumulator * accs,
+    std::size_t lg_block = default_lg_block)
+{
+    static_assert(!dpf::is_wildcard_v<typename DpfKey::raw_input_type>,
+        "eval_full_dot_batch does not support wildcard inputs");
+    using dpf_type = DpfKey;
+    using integral_type = typename DpfKey::integral_type;
+    using node_type = typename DpfKey::interior_node;
+    using output_type = typename DpfKey::concrete_output_type<I>;
+    constexpr auto depth = dpf_type::depth;
+    constexpr auto outputs_per_leaf = dpf_type::outputs_per_leaf;
+
+    for (std::size_t k = 0; k < keys; ++k) assert_not_wildcard_output<I>(dpfs[k]);
+    if (HEDLEY_UNLIKELY(utils::exceeds_domain_size<dpf_type>(records)))
+    {
+        throw std::length_error("database is larger than the domain");
+    }
+    if (keys == 0 || records == 0) return;
+
+    lg_block = std::min(lg_block, depth);
+    const std::size_t block_len = std::size_t(1) << lg_block,
+        outputs_per_block = outputs_per_leaf << lg_block;
+    const auto blocks = static_cast<integral_type>(
+        (records + outputs_per_block - 1) / outputs_per_block);
+
+    std::vector<dpf::output_buffer<output_type>> scratch;
+    scratch.reserve(keys);
+    for (std::size_t k = 0; k < keys; ++k) scratch.emplace_back(outputs_per_block);
+
+    internal::eval_blocks_batch(dpfs, keys, lg_block, blocks,
+        [&](integral_type from_node, integral_type, const node_type * nodes)
+        {
+            for (std::size_t k = 0; k < keys; ++k)
+            {
+                internal::eval_exterior_nodes<I>(dpfs[k], nodes + k*block_len,
+                    block_len, scratch[k]);
+            }
+
+            std::size_t base = static_cast<std::size_t>(from_node) * outputs_per_leaf,
+                count = std::min(outputs_per_block, records - base);
+            const Record * rec = database + base;
+            if constexpr (std::is_same_v<output_type, dpf::bit>)
+            {
+                // the block of records stays in cache across the keys
+                for (std::size_t k = 0; k < keys; ++k)
+                {
+                    internal::xor_records_if(accs[k], scratch[k].data(),
+                        rec, count);
+                }
+            }
+            else
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    for (std::size_t k = 0; k < keys; ++k)
+                    {
+                        accs[k] += scratch[k][i] * rec[i];
+                    }
+                }
+            }
+        });
+}
+
+/// @brief as above, for contiguous ranges of keys, records, and
+///        accumulators
+template <std::size_t I = 0,
+          typename DpfKeys,
+          typename Database,
+          typename Accumulators,
+          std::enable_if_t<!std::is_pointer_v<std::decay_t<DpfKeys>>, bool> = true>
+HEDLEY_ALWAYS_INLINE
+void eval_full_dot_batch(const DpfKeys & dpfs, const Database & database,
+    Accumulators & accs,  // NOLINT(runtime/references)
+    std::size_t lg_block = default_lg_block)
+{
+    if (HEDLEY_UNLIKELY(std::size(dpfs) != std::size(accs)))
+    {
+        throw std::invalid_argument("need exactly one accumulator per key");
+    }
+    eval_full_dot_batch<I>(std::data(dpfs), std::size(dpfs),
+        std::data(database), std::size(database), std::data(accs), lg_block);
+}
+
+}  // namespace dpf
+
+#endif  // LIBDPF_INCLUDE_DPF_EVAL_FULL_BATCH_HPP__
@@ -0,0 +1,266 @@
+/// @file dpf/eval_full_chunks.hpp
+/// @brief streaming variant of `dpf::eval_full`
+/// @details Produces the full-domain evaluation one chunk of
+///          `outputs_per_leaf * 2^lg_chunk` outputs at a time, using the
+///          blocked depth-first traversal of `dpf::eval_full_depth_first`.
+///          Only the current chunk, its memoizer, and the `O(depth)` path
+///          down to it are ever held in memory, so domains far larger than
+///          RAM can be scanned. Chunk `k` holds exactly the outputs that
+///          `dpf::eval_full` would write to positions
+///          `[k * chunk_size, (k+1) * chunk_size)` of its output buffer.
+///
+///          Chunks can be pulled from the input range returned by
+///          `dpf::eval_full_chunks`, or pushed to a callback by
+///          `dpf::eval_full_for_each_chunk`, which can optionally compute
+///          chunk `k+1` on a second thread while the callback consumes
+///          chunk `k`.
+/// @author Ryan Henry <ryan.henry@ucalgary.ca>
+/// @copyright Copyright (c) 2019-2024 Ryan Henry and [others](@ref authors)
+/// @license Released under a GNU General Public v2.0 (GPLv2) license;
+///          see [LICENSE.md](@ref license) for details.
+
+#ifndef LIBDPF_INCLUDE_DPF_EVAL_FULL_CHUNKS_HPP__
+#define LIBDPF_INCLUDE_DPF_EVAL_FULL_CHUNKS_HPP__
+
+#include <hedley/hedley.h>
+
+#include <cstddef>
+#include <condition_variable>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "dpf/dpf_key.hpp"
+#include "dpf/eval_common.hpp"
+#include "dpf/output_buffer.hpp"
+#include "dpf/wildcard.hpp"
+#include "dpf/eval_interval.hpp"
+#include "dpf/eval_full_depth_first.hpp"
+
+namespace dpf
+{
+
+/// @brief a single-pass range over the chunks of the full-domain
+///        evaluation of output `I` of a DPF
+/// @details Every iterator refers to the same chunk buffer, which is
+///          overwritten when any iterator is advanced. Calling `begin()`
+///          again restarts the evaluation from the first chunk.
+template <std::size_t I,
+          typename DpfKey>
+class full_chunks
+{
+  public:
+    static_assert(!dpf::is_wildcard_v<typename DpfKey::raw_input_type>,
+        "eval_full_chunks does not support wildcard inputs");
+
+    using dpf_type = DpfKey;
+    using integral_type = typename DpfKey::integral_type;
+    using output_type = typename DpfKey::concrete_output_type<I>;
+    using chunk_type = dpf::output_buffer<output_type>;
+
+    class iterator
+    {
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = chunk_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const chunk_type *;
+        using reference = const chunk_type &;
+
+        iterator() = default;
+        iterator(full_chunks * chunks, integral_type index)
+          : chunks_{chunks}, index_{index}
+        { }
+
+        reference operator*() const { return chunks_->chunk_; }
+        pointer operator->() const { return &chunks_->chunk_; }
+
+        iterator & operator++()
+        {
+            if (++index_ < chunks_->size()) chunks_->compute(index_);
+            return *this;
+        }
+
+        /// @brief the index of the current chunk
+        integral_type index() const { return index_; }
+
+        bool operator==(const iterator & rhs) const { return index_ == rhs.index_; }
+        bool operator!=(const iterator & rhs) const { return index_ != rhs.index_; }
+
+      private:
+        full_chunks * chunks_ = nullptr;
+        integral_type index_{0};
+    };
+
+    full_chunks(const DpfKey & dpf, std::size_t lg_chunk)
+      : dpf_{dpf},
+        walker_{dpf, lg_chunk},
+        chunk_(dpf_type::outputs_per_leaf << walker_.lg_block())
+    { }
+
+    full_chunks(const full_chunks &) = delete;
+    full_chunks & operator=(const full_chunks &) = delete;
+
+    iterator begin()
+    {
+        compute(0);
+        return iterator{this, 0};
+    }
+
+    iterator end() { return iterator{this, size()}; }
+
+    /// @brief the number of chunks
+    integral_type size() const { return walker_.blocks(); }
+
+    /// @brief the number of outputs in each chunk
+    std::size_t chunk_size() const { return std::size(chunk_); }
+
+  private:
+    void compute(integral_type index)
+    {
+        walker_.expand(index);
+        internal::eval_interval_exterior<I>(dpf_, walker_.from_node(index),
+            walker_.to_node(index), chunk_, walker_.memoizer());
+    }
+
+    const DpfKey & dpf_;
+    internal::depth_first_block_walker<DpfKey> walker_;
+    chunk_type chunk_;
+};
+
+/// @brief returns an input range over the full-domain evaluation of output
+///        `I` of `dpf`, in chunks of `outputs_per_leaf * 2^lg_chunk` outputs
+/// @details The range refers to `dpf`, which must outlive it.
+template <std::size_t I = 0,
+          typename DpfKey>
+auto eval_full_chunks(const DpfKey & dpf,
+    std::size_t lg_chunk = default_lg_block)
+{
+    assert_not_wildcard_output<I>(dpf);
+
+    return full_chunks<I, DpfKey>(dpf, lg_chunk);
+}
+
+/// @brief calls `f(k, chunk)` for each chunk `k` of the full-domain
+///        evaluation of output `I` of `dpf`, in order
+/// @param overlap if `true`, the next chunk is computed on a second thread
+///        while `f` consumes the current one; this uses a second chunk
+///        buffer
+template <std::size_t I = 0,
+          typename DpfKey,
+          typename Function>
+void eval_full_for_each_chunk(const DpfKey & dpf, Function && f,
+    std::size_t lg_chunk = default_lg_block, bool overlap = false)
+{
+    assert_not_wildcard_output<I>(dpf);
+    static_assert(!dpf::is_wildcard_v<typename DpfKey::raw_input_type>,
+        "eval_full_for_each_chunk does not support wildcard inputs");
+
+    using integral_type = typename DpfKey::integral_type;
+    using chunk_type = typename full_chunks<I, DpfKey>::chunk_type;
+
+    if (!overlap)
+    {
+        full_chunks<I, DpfKey> chunks(dpf, lg_chunk);
+        for (auto it = std::begin(chunks); it != std::end(chunks); ++it)
+        {
+            f(it.index(), *it);
+        }
+        return;
+    }
+
+    internal::depth_first_block_walker<DpfKey> walker(dpf, lg_chunk);
+    const integral_type count = walker.blocks();
+    const std::size_t chunk_size = DpfKey::outputs_per_leaf << walker.lg_block();
+    chunk_type bufs[2] = { chunk_type(chunk_size), chunk_type(chunk_size) };
+
+    // chunk `k` is written to `bufs[k % 2]`, so the producer may start on
+    // chunk `k` only once chunk `k-2` has been consumed
+    std::mutex mutex;
+    std::condition_variable cv;
+    integral_type produced{0}, consumed{0};
+    bool stop = false;
+    std::exception_ptr error = nullptr;
+
+    auto producer = [&]()
+    {
+        try
+        {
+            for (integral_type k = 0; k < count; ++k)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&]{ return stop || k - consumed < 2; });
+                    if (stop) return;
+                }
+                walker.expand(k);
+                internal::eval_interval_exterior<I>(dpf, walker.from_node(k),
+                    walker.to_node(k), bufs[static_cast<std::size_t>(k & 1)],
+                    walker.memoizer());
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    produced = k + 1;
+                }
+                cv.notify_all();
+            }
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                error = std::current_exception();
+                stop = true;
+            }
+            cv.notify_all();
+        }
+    };
+
+    std::thread thread;
+    try
+    {
+        thread = std::thread(producer);
+    }
+    catch (...)
+    {
+        eval_full_for_each_chunk<I>(dpf, f, lg_chunk, false);
+        return;
+    }
+
+    try
+    {
+        for (integral_type k = 0; k < count; ++k)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]{ return stop || produced > k; });
+                if (produced <= k) break;
+            }
+            f(k, static_cast<const chunk_type &>(bufs[static_cast<std::size_t>(k & 1)]));
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                consumed = k + 1;
+            }
+            cv.notify_all();
+        }
+    }
+    catch (...)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        cv.notify_all();
+        thread.join();
+        throw;
+    }
+    thread.join();
+
+    if (error != nullptr) std::rethrow_exception(error);
+}
+
+}  // namespace dpf
+
+#endif  // LIBDPF_INCLUDE_DPF_EVAL_FULL_CHUNKS_HPP__
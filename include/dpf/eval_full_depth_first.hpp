@@ -0,0 +1,216 @@
+/// @file dpf/eval_full_depth_first.hpp
+/// @brief blocked depth-first variant of `dpf::eval_full`
+/// @details Rather than materializing every level of the tree, the leaves
+///          are produced one block of `2^lg_block` leaf nodes at a time. The
+///          path from the root down to the current block is kept on a
+///          small stack of `depth - lg_block` nodes and only the part that
+///          changes between consecutive blocks is recomputed; each block is
+///          then expanded breadth-first inside a memoizer that holds just
+///          that block. Memory (excluding the output) is thus
+///          `O(depth + 2^lg_block)` nodes, which, for the default block
+///          size, stays resident in L2.
+/// @author Ryan Henry <ryan.henry@ucalgary.ca>
+/// @copyright Copyright (c) 2019-2024 Ryan Henry and [others](@ref authors)
+/// @license Released under a GNU General Public v2.0 (GPLv2) license;
+///          see [LICENSE.md](@ref license) for details.
+
+#ifndef LIBDPF_INCLUDE_DPF_EVAL_FULL_DEPTH_FIRST_HPP__
+#define LIBDPF_INCLUDE_DPF_EVAL_FULL_DEPTH_FIRST_HPP__
+
+#include <portable-snippets/builtin/builtin.h>
+#include <hedley/hedley.h>
+
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "dpf/dpf_key.hpp"
+#include "dpf/eval_common.hpp"
+#include "dpf/output_buffer.hpp"
+#include "dpf/interval_memoizer.hpp"
+#include "dpf/rotation_iterable.hpp"
+#include "dpf/eval_interval.hpp"
+
+namespace dpf
+{
+
+/// @brief default (base-2 logarithm of the) number of leaf nodes per block;
+///        `2^12` nodes take 64 KiB per memoizer level
+static constexpr std::size_t default_lg_block = 12;
+
+namespace internal
+{
+
+/// @brief expands consecutive blocks of `2^lg_block` leaf nodes, keeping
+///        only the path from the root down to the current block between
+///        calls
+template <typename DpfKey>
+class depth_first_block_walker
+{
+  public:
+    using dpf_type = DpfKey;
+    using integral_type = typename DpfKey::integral_type;
+    using node_type = typename DpfKey::interior_node;
+    using memoizer_type = dpf::basic_interval_memoizer<DpfKey>;
+    static constexpr auto depth = dpf_type::depth;
+
+    depth_first_block_walker(const DpfKey & dpf, std::size_t lg_block)
+      : dpf_{dpf},
+        lg_block_{std::min(lg_block, depth)},
+        split_{depth - lg_block_},
+        memoizer_{std::size_t(1) << lg_block_}
+    {
+        path_[0] = dpf.root();
+    }
+
+    /// @brief expands `block` into `memoizer()`; `block` must be `0` or one
+    ///        more than the previously expanded block
+    void expand(integral_type block)
+    {
+        constexpr auto countr_zero = utils::countr_zero<std::size_t>{};
+
+        // the ancestors of `block` above level `split - ctz(block)` are
+        // shared with `block - 1` and are still on the stack
+        std::size_t level = 1;
+        if (block != 0)
+        {
+            level = split_ - countr_zero(static_cast<std::size_t>(block));
+        }
+        for (; level <= split_; ++level)
+        {
+            bool dir = (block >> (split_ - level)) & 1;
+            path_[level] = dpf_type::traverse_interior(path_[level-1],
+                dpf_.correction_word(level-1, dir), dir);
+        }
+
+        eval_subtree_interior(dpf_, split_, path_[split_], from_node(block),
+            to_node(block), memoizer_);
+    }
+
+    integral_type from_node(integral_type block) const { return block << lg_block_; }
+    integral_type to_node(integral_type block) const { return (block + 1) << lg_block_; }
+    std::size_t lg_block() const { return lg_block_; }
+    /// @brief the number of blocks that make up the full domain
+    integral_type blocks() const { return integral_type{1} << split_; }
+    memoizer_type & memoizer() { return memoizer_; }
+
+  private:
+    const DpfKey & dpf_;
+    const std::size_t lg_block_;
+    const std::size_t split_;
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    std::array<node_type, depth+1> path_;
+HEDLEY_PRAGMA(GCC diagnostic pop)
+    memoizer_type memoizer_;
+};
+
+/// @brief expands the first `blocks` blocks of `2^lg_block` leaf nodes,
+///        in order, calling `f(from_node, to_node, memoizer)` after each one
+template <typename DpfKey,
+          typename Function,
+          typename IntegralT = typename DpfKey::integral_type>
+void eval_blocks_depth_first(const DpfKey & dpf, std::size_t lg_block,
+    IntegralT blocks, Function && f)
+{
+    using integral_type = typename DpfKey::integral_type;
+
+    depth_first_block_walker<DpfKey> walker(dpf, lg_block);
+    for (integral_type block = 0; block < blocks; ++block)
+    {
+        walker.expand(block);
+        f(walker.from_node(block), walker.to_node(block), walker.memoizer());
+    }
+}
+
+template <std::size_t ...Is,
+          typename DpfKey,
+          typename OutputBuffers,
+          std::size_t ...IIs>
+void eval_full_depth_first_impl(const DpfKey & dpf, OutputBuffers && outbufs,
+    std::size_t lg_block, std::index_sequence<IIs...>)
+{
+    using integral_type = typename DpfKey::integral_type;
+    constexpr auto depth = DpfKey::depth;
+
+    lg_block = std::min(lg_block, depth);
+    eval_blocks_depth_first(dpf, lg_block,
+        integral_type{1} << (depth - lg_block),
+        [&dpf, &outbufs](integral_type from_node, integral_type to_node,
+            auto & memoizer)  // NOLINT(runtime/references)
+        {
+            (eval_interval_exterior<Is>(dpf, from_node, to_node,
+                utils::get<IIs>(outbufs), memoizer,
+                static_cast<std::size_t>(from_node)), ...);
+        });
+}
+
+template <std::size_t ...Is,
+          typename DpfKey,
+          typename OutputBuffers,
+          std::size_t ...IIs,
+          std::enable_if_t<dpf::is_wildcard_v<typename DpfKey::raw_input_type>, bool> = false>
+auto eval_full_depth_first(const DpfKey & dpf, OutputBuffers && outbufs,
+    std::size_t lg_block, std::index_sequence<IIs...>)
+{
+    auto offset = dpf.offset_x(0);  // N.B.: throws if dpf is not ready
+
+    eval_full_depth_first_impl<Is...>(dpf, outbufs, lg_block,
+        std::make_index_sequence<sizeof...(Is)>());
+
+    return utils::make_tuple(dpf::rotation_iterable(std::begin(utils::get<IIs>(outbufs)), std::end(utils::get<IIs>(outbufs)), offset)...);
+}
+
+template <std::size_t ...Is,
+          typename DpfKey,
+          typename OutputBuffers,
+          std::size_t ...IIs,
+          std::enable_if_t<!dpf::is_wildcard_v<typename DpfKey::raw_input_type>, bool> = false>
+auto eval_full_depth_first(const DpfKey & dpf, OutputBuffers && outbufs,
+    std::size_t lg_block, std::index_sequence<IIs...>)
+{
+    eval_full_depth_first_impl<Is...>(dpf, outbufs, lg_block,
+        std::make_index_sequence<sizeof...(Is)>());
+
+    return utils::make_tuple(std::ref(utils::get<IIs>(outbufs))...);
+}
+
+}  // namespace internal
+
+template <std::size_t I = 0,
+          std::size_t ...Is,
+          typename DpfKey,
+          typename OutputBuffers,
+          std::enable_if_t<!std::is_integral_v<std::decay_t<OutputBuffers>>, bool> = true>
+HEDLEY_ALWAYS_INLINE
+auto eval_full_depth_first(const DpfKey & dpf,
+    OutputBuffers & outbufs,  // NOLINT(runtime/references)
+    std::size_t lg_block = default_lg_block)
+{
+    assert_not_wildcard_output<I, Is...>(dpf);
+
+    return internal::eval_full_depth_first<I, Is...>(dpf, outbufs, lg_block, std::make_index_sequence<1+sizeof...(Is)>());
+}
+
+template <std::size_t I = 0,
+          std::size_t ...Is,
+          typename DpfKey>
+HEDLEY_ALWAYS_INLINE
+auto eval_full_depth_first(const DpfKey & dpf,
+    std::size_t lg_block = default_lg_block)
+{
+    auto outbufs = utils::make_tuple(
+        make_output_buffer_for_full<I>(dpf),
+        make_output_buffer_for_full<Is>(dpf)...);
+
+    // see the comment in `dpf::eval_full` on moving `outbufs`
+    auto iterable = eval_full_depth_first<I, Is...>(dpf, outbufs, lg_block);
+    return std::make_pair(std::move(outbufs), std::move(iterable));
+}
+
+}  // namespace dpf
+
+#endif  // LIBDPF_INCLUDE_DPF_EVAL_FULL_DEPTH_FIRST_HPP__
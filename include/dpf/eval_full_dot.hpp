@@ -0,0 +1,159 @@
+/// @file dpf/eval_full_dot.hpp
+/// @brief fused full-domain evaluation and database inner product
+/// @details Computes the inner product between the full-domain evaluation
+///          of a DPF and a database of records, as needed by DPF-based PIR,
+///          without materializing the output vector. The tree is walked
+///          with the same blocked depth-first traversal used by
+///          `dpf::eval_full_depth_first`; each block of leaves is written to
+///          a small scratch buffer and immediately folded into the
+///          accumulator:
+///           - for `dpf::bit` outputs, `acc ^= record` for each set bit;
+///           - otherwise, `acc += output * record`.
+///
+///          Record `i` is paired with the `i`th output in the order used
+///          by `dpf::eval_full`. The database may be shorter than the
+///          domain, in which case the outputs past its end are never
+///          computed.
+/// @author Ryan Henry <ryan.henry@ucalgary.ca>
+/// @copyright Copyright (c) 2019-2024 Ryan Henry and [others](@ref authors)
+/// @license Released under a GNU General Public v2.0 (GPLv2) license;
+///          see [LICENSE.md](@ref license) for details.
+
+#ifndef LIBDPF_INCLUDE_DPF_EVAL_FULL_DOT_HPP__
+#define LIBDPF_INCLUDE_DPF_EVAL_FULL_DOT_HPP__
+
+#include <hedley/hedley.h>
+
+#include <cstddef>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#include "dpf/dpf_key.hpp"
+#include "dpf/eval_common.hpp"
+#include "dpf/output_buffer.hpp"
+#include "dpf/wildcard.hpp"
+#include "dpf/eval_interval.hpp"
+#include "dpf/eval_full_depth_first.hpp"
+
+namespace dpf
+{
+
+namespace internal
+{
+
+/// @brief `acc ^= record` if `bit` is set; branch-free for integral records
+template <typename Accumulator,
+          typename Record>
+HEDLEY_ALWAYS_INLINE
+void xor_record_if(Accumulator & acc, const Record & record, bool bit)  // NOLINT(runtime/references)
+{
+    if constexpr (std::is_integral_v<Record>)
+    {
+        acc ^= record & (Record(0) - Record(bit));
+    }
+    else if (bit)
+    {
+        acc ^= record;
+    }
+}
+
+/// @brief `acc ^= records[i]` for each `i < count` whose bit is set in the
+///        packed `dpf::bit` outputs `words`
+template <typename Accumulator,
+          typename Word,
+          typename Record>
+HEDLEY_ALWAYS_INLINE
+void xor_records_if(Accumulator & acc, const Word * words,  // NOLINT(runtime/references)
+    const Record * records, std::size_t count)
+{
+    constexpr std::size_t bits_per_word = utils::bitlength_of_v<Word>;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        xor_record_if(acc, records[i],
+            (words[i / bits_per_word] >> (i % bits_per_word)) & 1);
+    }
+}
+
+}  // namespace internal
+
+/// @brief computes the inner product of the full-domain evaluation of
+///        output `I` of `dpf` with `database[0..records)`
+/// @return `acc`, after folding in every record
+template <std::size_t I = 0,
+          typename DpfKey,
+          typename Record,
+          typename Accumulator>
+Accumulator & eval_full_dot(const DpfKey & dpf, const Record * database,
+    std::size_t records, Accumulator & acc,  // NOLINT(runtime/references)
+    std::size_t lg_block = default_lg_block)
+{
+    assert_not_wildcard_output<I>(dpf);
+    static_assert(!dpf::is_wildcard_v<typename DpfKey::raw_input_type>,
+        "eval_full_dot does not support wildcard inputs");
+
+    using dpf_type = DpfKey;
+    using integral_type = typename DpfKey::integral_type;
+    using output_type = typename DpfKey::concrete_output_type<I>;
+    constexpr auto depth = dpf_type::depth;
+    constexpr auto outputs_per_leaf = dpf_type::outputs_per_leaf;
+
+    if (HEDLEY_UNLIKELY(utils::exceeds_domain_size<dpf_type>(records)))
+    {
+        throw std::length_error("database is larger than the domain");
+    }
+    if (records == 0) return acc;
+
+    lg_block = std::min(lg_block, depth);
+    const std::size_t outputs_per_block = outputs_per_leaf << lg_block;
+    const auto blocks = static_cast<integral_type>(
+        (records + outputs_per_block - 1) / outputs_per_block);
+    auto scratch = dpf::output_buffer<output_type>(outputs_per_block);
+
+    internal::eval_blocks_depth_first(dpf, lg_block, blocks,
+        [&](integral_type from_node, integral_type to_node,
+            auto & memoizer)  // NOLINT(runtime/references)
+        {
+            internal::eval_interval_exterior<I>(dpf, from_node, to_node,
+                scratch, memoizer);
+
+            std::size_t base = static_cast<std::size_t>(from_node) * outputs_per_leaf,
+                count = std::min(outputs_per_block, records - base);
+            const Record * rec = database + base;
+            if constexpr (std::is_same_v<output_type, dpf::bit>)
+            {
+                internal::xor_records_if(acc, scratch.data(), rec, count);
+            }
+            else
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    acc += scratch[i] * rec[i];
+                }
+            }
+        });
+
+    return acc;
+}
+
+/// @brief computes the inner product of the full-domain evaluation of
+///        output `I` of `dpf` with a contiguous `database` (e.g., a
+///        `std::vector` or a `dpf::mapped_database`)
+template <std::size_t I = 0,
+          typename DpfKey,
+          typename Database,
+          typename Accumulator,
+          std::enable_if_t<!std::is_pointer_v<std::decay_t<Database>>, bool> = true>
+HEDLEY_ALWAYS_INLINE
+Accumulator & eval_full_dot(const DpfKey & dpf, const Database & database,
+    Accumulator & acc,  // NOLINT(runtime/references)
+    std::size_t lg_block = default_lg_block)
+{
+    return eval_full_dot<I>(dpf, std::data(database), std::size(database),
+        acc, lg_block);
+}
+
+}  // namespace dpf
+
+#endif  // LIBDPF_INCLUDE_DPF_EVAL_FULL_DOT_HPP__
@@ -32,21 +32,19 @@ namespace dpf
 namespace internal
 {
 
+/// @brief builds levels `level_index` through `to_level` of the interval
+///        that was most recently assigned to `memoizer`
 template <typename DpfKey,
           typename IntervalMemoizer,
           typename IntegralT = typename DpfKey::integral_type>
-inline auto eval_interval_interior(const DpfKey & dpf, IntegralT from_node,
-    IntegralT to_node, IntervalMemoizer & memoizer,  // NOLINT(runtime/references)
-    std::size_t to_level = DpfKey::depth)
+inline void eval_interval_levels(const DpfKey & dpf, IntegralT from_node,
+    IntervalMemoizer & memoizer,  // NOLINT(runtime/references)
+    std::size_t level_index, std::size_t to_level)
 {
     using dpf_type = DpfKey;
     using integral_type = typename DpfKey::integral_type;
     using node_type = typename DpfKey::interior_node;
 
-    // level_index represents the current level being built
-    // level_index = 0 => root
-    // level_index = depth => last layer of interior nodes
-    std::size_t level_index = memoizer.assign_interval(dpf, from_node, to_node);
     std::size_t nodes_at_level = memoizer.get_nodes_at_level();
     integral_type mask = utils::get_node_mask<dpf_type>(dpf.msb_mask, level_index);
 
@@ -66,13 +64,11 @@ inline auto eval_interval_interior(const DpfKey & dpf, IntegralT from_node,
             memoizer[level_index][i++] = dpf_type::traverse_interior(memoizer[level_index-1][j++], cw[1], 1);
         }
         // process all nodes which require both a left traversal and a right traversal
-        DPF_UNROLL_LOOP
-        for (; i < nodes_at_level - to_offset;)
-        {
-            auto cur_node = memoizer[level_index-1][j++];
-            memoizer[level_index][i++] = dpf_type::traverse_interior(cur_node, cw[0], 0);
-            memoizer[level_index][i++] = dpf_type::traverse_interior(cur_node, cw[1], 1);
-        }
+        std::size_t parents = (nodes_at_level - to_offset - i) / 2;
+        dpf_type::traverse_interior(&memoizer[level_index-1][j], cw,
+            &memoizer[level_index][i], parents);
+        i += 2*parents;
+        j += parents;
         // process node which only requires a left traversal
         if (to_offset == true)
         {
@@ -81,33 +77,58 @@ inline auto eval_interval_interior(const DpfKey & dpf, IntegralT from_node,
     }
 }
 
-template <std::size_t I,
-          typename DpfKey,
-          typename OutputBuffer,
+template <typename DpfKey,
           typename IntervalMemoizer,
           typename IntegralT = typename DpfKey::integral_type>
-inline auto eval_interval_exterior(const DpfKey & dpf, IntegralT from_node,
-    IntegralT to_node, OutputBuffer && outbuf, IntervalMemoizer && memoizer,
-    std::size_t start = 0)
+inline auto eval_interval_interior(const DpfKey & dpf, IntegralT from_node,
+    IntegralT to_node, IntervalMemoizer & memoizer,  // NOLINT(runtime/references)
+    std::size_t to_level = DpfKey::depth)
 {
-    assert_not_wildcard_output<I>(dpf);
-    if (HEDLEY_UNLIKELY(to_node < from_node)) throw std::runtime_error("to_node<from_node");
+    // level_index represents the current level being built
+    // level_index = 0 => root
+    // level_index = depth => last layer of interior nodes
+    std::size_t level_index = memoizer.assign_interval(dpf, from_node, to_node);
+    eval_interval_levels(dpf, from_node, memoizer, level_index, to_level);
+}
+
+/// @brief evaluates the leaves `[from_node, to_node)` of the subtree rooted
+///        at `node`, which must be the ancestor at `level` of every leaf in
+///        that range
+template <typename DpfKey,
+          typename IntervalMemoizer,
+          typename IntegralT = typename DpfKey::integral_type>
+inline auto eval_subtree_interior(const DpfKey & dpf, std::size_t level,
+    const typename DpfKey::interior_node & node, IntegralT from_node,
+    IntegralT to_node, IntervalMemoizer & memoizer,  // NOLINT(runtime/references)
+    std::size_t to_level = DpfKey::depth)
+{
+    std::size_t level_index = memoizer.assign_subtree(dpf, level, node,
+        from_node, to_node);
+    eval_interval_levels(dpf, from_node, memoizer, level_index, to_level);
+}
 
+/// @brief writes the outputs of the `count` leaf nodes whose parents are
+///        `nodes[0..count)` to `outbuf`, starting at leaf node `start`
+template <std::size_t I,
+          typename DpfKey,
+          typename OutputBuffer>
+inline void eval_exterior_nodes(const DpfKey & dpf,
+    const typename DpfKey::interior_node * nodes, std::size_t count,
+    OutputBuffer && outbuf, std::size_t start = 0)
+{
     using dpf_type = DpfKey;
     using output_type = typename DpfKey::concrete_output_type<I>;
     using exterior_node_type = typename DpfKey::exterior_node;
 
-    std::size_t nodes_in_interval = to_node - from_node;
-
 HEDLEY_PRAGMA(GCC diagnostic push)
 HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
     auto cw = std::get<I>(dpf.leaf_nodes).get();
     auto rawbuf = reinterpret_cast<exterior_node_type *>(utils::data(outbuf));
     DPF_UNROLL_LOOP
-    for (std::size_t j = 0, k = start; j < nodes_in_interval; ++j, ++k)
+    for (std::size_t j = 0, k = start; j < count; ++j, ++k)
     {
-        auto leaf = dpf.template traverse_exterior<I>(memoizer[dpf_type::depth][j],
-            get_if_lo_bit(cw, memoizer[dpf_type::depth][j]));
+        auto leaf = dpf.template traverse_exterior<I>(nodes[j],
+            get_if_lo_bit(cw, nodes[j]));
         if constexpr (std::is_same_v<output_type, dpf::bit>)
         {
             std::memcpy(&rawbuf[k], &leaf, sizeof(leaf));
@@ -120,6 +141,23 @@ HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
 HEDLEY_PRAGMA(GCC diagnostic pop)
 }
 
+template <std::size_t I,
+          typename DpfKey,
+          typename OutputBuffer,
+          typename IntervalMemoizer,
+          typename IntegralT = typename DpfKey::integral_type>
+inline auto eval_interval_exterior(const DpfKey & dpf, IntegralT from_node,
+    IntegralT to_node, OutputBuffer && outbuf, IntervalMemoizer && memoizer,
+    std::size_t start = 0)
+{
+    assert_not_wildcard_output<I>(dpf);
+    if (HEDLEY_UNLIKELY(to_node < from_node)) throw std::runtime_error("to_node<from_node");
+
+    std::size_t nodes_in_interval = to_node - from_node;
+    eval_exterior_nodes<I>(dpf, &memoizer[DpfKey::depth][0],
+        nodes_in_interval, outbuf, start);
+}
+
 template <std::size_t ...Is,
           typename DpfKey,
           typename InputT,
@@ -197,7 +235,7 @@ template <std::size_t I = 0,
           typename DpfKey,
           typename InputT,
           typename OutputBuffers,
-          std::enable_if_t<!std::is_base_of_v<dpf::interval_memoizer_base<DpfKey>,
+          std::enable_if_t<!std::is_base_of_v<dpf::interval_memoizer_tag_,
               std::decay_t<OutputBuffers>>, bool> = true>
 HEDLEY_ALWAYS_INLINE
 auto eval_interval(const DpfKey & dpf, InputT from, InputT to,
@@ -212,7 +250,7 @@ template <std::size_t I = 0,
           typename DpfKey,
           typename InputT,
           typename IntervalMemoizer,
-          std::enable_if_t<std::is_base_of_v<dpf::interval_memoizer_base<DpfKey>,
+          std::enable_if_t<std::is_base_of_v<dpf::interval_memoizer_tag_,
               std::decay_t<IntervalMemoizer>>, bool> = true>
 HEDLEY_ALWAYS_INLINE
 auto eval_interval(const DpfKey & dpf, InputT from, InputT to,
@@ -0,0 +1,476 @@
+/// @file dpf/eval_parallel.hpp
+/// @brief multithreaded variants of `dpf::eval_interval`, `dpf::eval_full`,
+///        and `dpf::eval_sequence`
+/// @details The top levels of the tree are expanded serially until there
+///          are enough subtrees to keep every thread busy. The subtrees are
+///          then handed out one at a time from a shared counter, so threads
+///          that finish early simply take more of them. Each thread owns a
+///          `dpf::basic_interval_memoizer` sized for a single subtree and
+///          writes its leaves straight into the corresponding (disjoint)
+///          range of the output buffers.
+///
+///          `dpf::eval_sequence_parallel` does the same for a
+///          `dpf::sequence_recipe`: the recipe is cut (see
+///          `dpf::split_sequence_recipe`) at the first level with enough
+///          nodes, and each sub-recipe is evaluated with its own sequence
+///          memoizer.
+/// @author Ryan Henry <ryan.henry@ucalgary.ca>
+/// @copyright Copyright (c) 2019-2024 Ryan Henry and [others](@ref authors)
+/// @license Released under a GNU General Public v2.0 (GPLv2) license;
+///          see [LICENSE.md](@ref license) for details.
+
+#ifndef LIBDPF_INCLUDE_DPF_EVAL_PARALLEL_HPP__
+#define LIBDPF_INCLUDE_DPF_EVAL_PARALLEL_HPP__
+
+#include <hedley/hedley.h>
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "dpf/dpf_key.hpp"
+#include "dpf/eval_common.hpp"
+#include "dpf/output_buffer.hpp"
+#include "dpf/interval_memoizer.hpp"
+#include "dpf/subinterval_iterable.hpp"
+#include "dpf/rotation_iterable.hpp"
+#include "dpf/eval_interval.hpp"
+#include "dpf/eval_subtree.hpp"
+#include "dpf/sequence_recipe.hpp"
+#include "dpf/sequence_memoizer.hpp"
+#include "dpf/subsequence_iterable.hpp"
+#include "dpf/eval_sequence.hpp"
+
+namespace dpf
+{
+
+/// @brief the number of threads used when none is specified
+inline std::size_t default_eval_threads()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+namespace internal
+{
+
+// subtrees handed out per thread; more gives better load balancing at the
+// cost of more (serial) work expanding the top of the tree
+static constexpr std::size_t parallel_subtrees_per_thread = 8;
+// never split into subtrees with fewer than 2^this many leaves
+static constexpr std::size_t parallel_lg_min_subtree = 10;
+
+template <std::size_t ...Is,
+          typename DpfKey,
+          typename OutputBuffers,
+          std::size_t ...IIs,
+          typename IntegralT = typename DpfKey::integral_type>
+void eval_nodes_parallel(const DpfKey & dpf, IntegralT from_node,
+    IntegralT to_node, OutputBuffers && outbufs, std::size_t start,
+    std::size_t threads, std::index_sequence<IIs...>)
+{
+    using dpf_type = DpfKey;
+    using integral_type = typename DpfKey::integral_type;
+    constexpr auto depth = dpf_type::depth;
+
+    threads = std::max(threads, std::size_t(1));
+    const std::size_t target = threads * parallel_subtrees_per_thread;
+    const std::size_t max_level = depth > parallel_lg_min_subtree
+        ? depth - parallel_lg_min_subtree : 0;
+    auto subtrees_at = [from_node, to_node](std::size_t level)
+    {
+        std::size_t shift = depth - level;
+        return static_cast<std::size_t>(((to_node - 1) >> shift) - (from_node >> shift) + 1);
+    };
+
+    std::size_t level = 0;
+    while (level < max_level && subtrees_at(level) < target) ++level;
+
+    const auto frontier = expand_frontier(dpf, from_node, to_node, level);
+    const std::size_t shift = depth - level;
+    const integral_type first_subtree = from_node >> shift;
+    const std::size_t subtree_len = std::min(
+        static_cast<std::size_t>(to_node - from_node), std::size_t(1) << shift);
+    threads = std::min(threads, frontier.size());
+
+    std::atomic_size_t next{0};
+    std::exception_ptr error = nullptr;
+    std::mutex error_mutex;
+
+    auto worker = [&]()
+    {
+        try
+        {
+            auto memoizer = dpf::basic_interval_memoizer<dpf_type>(subtree_len);
+            for (std::size_t i = next++; i < frontier.size(); i = next++)
+            {
+                integral_type node = first_subtree + i,
+                    sub_from = std::max(from_node, node << shift),
+                    sub_to = std::min(to_node, (node + 1) << shift);
+                eval_subtree_interior(dpf, level, frontier[i], sub_from,
+                    sub_to, memoizer);
+                (eval_interval_exterior<Is>(dpf, sub_from, sub_to,
+                    utils::get<IIs>(outbufs), memoizer,
+                    start + static_cast<std::size_t>(sub_from - from_node)), ...);
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (error == nullptr) error = std::current_exception();
+            next = frontier.size();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    try
+    {
+        for (std::size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+    }
+    catch (...)
+    {
+        // run with however many threads could be started
+    }
+    worker();
+    for (auto & thread : pool) thread.join();
+
+    if (error != nullptr) std::rethrow_exception(error);
+}
+
+template <std::size_t ...Is,
+          typename DpfKey,
+          typename InputT,
+          typename OutputBuffers,
+          std::size_t ...IIs>
+void eval_interval_parallel_impl(const DpfKey & dpf, InputT from, InputT to,
+    OutputBuffers && outbufs, std::size_t threads,
+    std::index_sequence<IIs...> iis)
+{
+    using dpf_type = DpfKey;
+    using integral_type = typename DpfKey::integral_type;
+    constexpr auto last_node = integral_type{(integral_type{1} << dpf.depth)-1};
+
+    utils::flip_msb_if_signed_integral(from);
+    utils::flip_msb_if_signed_integral(to);
+
+    integral_type from_node = utils::get_from_node<dpf_type>(from),
+        to_node = utils::get_to_node<dpf_type>(to);
+
+    if (from_node < to_node)
+    {
+        eval_nodes_parallel<Is...>(dpf, from_node, to_node, outbufs, 0,
+            threads, iis);
+    }
+    else  // if (to <= from)
+    {
+        eval_nodes_parallel<Is...>(dpf, from_node, last_node, outbufs, 0,
+            threads, iis);
+        eval_nodes_parallel<Is...>(dpf, integral_type{0}, to_node, outbufs,
+            last_node-from_node, threads, iis);
+    }
+}
+
+template <std::size_t ...Is,
+          typename DpfKey,
+          typename InputT,
+          typename OutputBuffers,
+          std::size_t ...IIs>
+auto eval_interval_parallel(const DpfKey & dpf, InputT from, InputT to,
+    OutputBuffers && outbufs, std::size_t threads,
+    std::index_sequence<IIs...>)
+{
+    using dpf_type = DpfKey;
+    constexpr auto mod_pow_2 = utils::mod_pow_2<InputT>{};
+    constexpr auto to_integral_t = utils::to_integral_type<InputT>{};
+
+    eval_interval_parallel_impl<Is...>(dpf, from, to, outbufs, threads, std::make_index_sequence<sizeof...(Is)>());
+
+    return utils::make_tuple(subinterval_iterable(std::begin(utils::get<IIs>(outbufs)), utils::size(utils::get<IIs>(outbufs)), to_integral_t(from), to_integral_t(to), mod_pow_2(from, dpf_type::lg_outputs_per_leaf), dpf_type::outputs_per_leaf)...);
+}
+
+template <std::size_t ...Is,
+          typename DpfKey,
+          typename OutputBuffers,
+          std::size_t ...IIs,
+          std::enable_if_t<dpf::is_wildcard_v<typename DpfKey::raw_input_type>, bool> = false>
+auto eval_full_parallel(const DpfKey & dpf, OutputBuffers && outbufs,
+    std::size_t threads, std::index_sequence<IIs...>)
+{
+    using dpf_type = DpfKey;
+    using input_type = typename dpf_type::input_type;
+    auto offset = dpf.offset_x(0);  // N.B.: throws if dpf is not ready
+
+    eval_interval_parallel_impl<Is...>(dpf,
+            std::numeric_limits<input_type>::min(),
+            std::numeric_limits<input_type>::max(),
+            outbufs, threads, std::make_index_sequence<sizeof...(Is)>());
+
+    return utils::make_tuple(dpf::rotation_iterable(std::begin(utils::get<IIs>(outbufs)), std::end(utils::get<IIs>(outbufs)), offset)...);
+}
+
+template <std::size_t ...Is,
+          typename DpfKey,
+          typename OutputBuffers,
+          std::size_t ...IIs,
+          std::enable_if_t<!dpf::is_wildcard_v<typename DpfKey::raw_input_type>, bool> = false>
+auto eval_full_parallel(const DpfKey & dpf, OutputBuffers && outbufs,
+    std::size_t threads, std::index_sequence<IIs...>)
+{
+    using dpf_type = DpfKey;
+    using input_type = typename dpf_type::input_type;
+
+    eval_interval_parallel_impl<Is...>(dpf,
+            std::numeric_limits<input_type>::min(),
+            std::numeric_limits<input_type>::max(),
+            outbufs, threads, std::make_index_sequence<sizeof...(Is)>());
+
+    return utils::make_tuple(std::ref(utils::get<IIs>(outbufs))...);
+}
+
+/// @brief the shallowest level of `recipe` with at least `target` nodes,
+///        or its depth if there is no such level
+inline std::size_t sequence_split_level(const sequence_recipe & recipe,
+    std::size_t target)
+{
+    const auto & level_endpoints = recipe.level_endpoints();
+    std::size_t level = 0;
+    while (level < recipe.depth()
+        && level_endpoints[level+1] - level_endpoints[level] < target) ++level;
+    return level;
+}
+
+template <std::size_t I,
+          typename DpfKey,
+          typename OutputBuffer,
+          typename SequenceMemoizer>
+void eval_subrecipe_exterior_output_only(const DpfKey & dpf,
+    const sequence_subrecipe & sub, OutputBuffer && outbuf,
+    SequenceMemoizer && memoizer, std::mutex & bits_mutex)  // NOLINT(runtime/references)
+{
+    using output_type = typename DpfKey::concrete_output_type<I>;
+
+    if constexpr (std::is_same_v<output_type, dpf::bit>)
+    {
+        // neighbouring subtrees may share a word of `outbuf`, so bits are
+        // written to a private buffer first and copied over under a lock
+        auto bits = dpf::output_buffer<dpf::bit>(sub.recipe.output_indices().size());
+        eval_sequence_exterior_output_only<I>(dpf, sub.recipe, bits, memoizer);
+        std::lock_guard<std::mutex> lock(bits_mutex);
+        for (std::size_t i = 0; i < std::size(bits); ++i)
+        {
+            outbuf[sub.first_output + i] = static_cast<bool>(bits[i]);
+        }
+    }
+    else
+    {
+        eval_sequence_exterior_output_only<I>(dpf, sub.recipe, outbuf,
+            memoizer, sub.first_output);
+    }
+}
+
+template <std::size_t ...Is,
+          typename DpfKey,
+          typename OutputBuffers,
+          typename ReturnType,
+          std::size_t ...IIs>
+auto eval_sequence_parallel(const DpfKey & dpf, const sequence_recipe & recipe,
+    OutputBuffers && outbufs, ReturnType, std::size_t threads,
+    std::index_sequence<IIs...>)
+{
+    using dpf_type = DpfKey;
+    static_assert(std::is_same_v<ReturnType, return_entire_node_tag_> ||
+                    std::is_same_v<ReturnType, return_output_only_tag_>);
+
+    if (dpf_type::depth != recipe.depth())
+    {
+        throw std::logic_error("incorrect dpf depth");
+    }
+    if (dpf_type::lg_outputs_per_leaf != recipe.lg_outputs_per_leaf())
+    {
+        throw std::logic_error("incorrect dpf outputs per leaf");
+    }
+
+    threads = std::max(threads, std::size_t(1));
+    const auto subrecipes = split_sequence_recipe<dpf_type>(recipe,
+        sequence_split_level(recipe, threads * parallel_subtrees_per_thread));
+    threads = std::min(threads, subrecipes.size());
+
+    std::atomic_size_t next{0};
+    std::exception_ptr error = nullptr;
+    std::mutex error_mutex, bits_mutex;
+
+    auto worker = [&]()
+    {
+        try
+        {
+            for (std::size_t i = next++; i < subrecipes.size(); i = next++)
+            {
+                const auto & sub = subrecipes[i];
+                auto memoizer = dpf::make_double_space_sequence_memoizer<dpf_type>(sub.recipe);
+                eval_sequence_interior(dpf, sub.recipe, memoizer);
+                if constexpr (std::is_same_v<ReturnType, return_entire_node_tag_>)
+                {
+                    (eval_sequence_exterior_entire_node<Is>(dpf, sub.recipe,
+                        utils::get<IIs>(outbufs), memoizer, sub.first_leaf), ...);
+                }
+                else
+                {
+                    (eval_subrecipe_exterior_output_only<Is>(dpf, sub,
+                        utils::get<IIs>(outbufs), memoizer, bits_mutex), ...);
+                }
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (error == nullptr) error = std::current_exception();
+            next = subrecipes.size();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    try
+    {
+        for (std::size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+    }
+    catch (...)
+    {
+        // run with however many threads could be started
+    }
+    worker();
+    for (auto & thread : pool) thread.join();
+
+    if (error != nullptr) std::rethrow_exception(error);
+
+    if constexpr (std::is_same_v<ReturnType, return_entire_node_tag_>)
+    {
+        return utils::make_tuple(
+            recipe_subsequence_iterable(std::begin(utils::get<IIs>(outbufs)), recipe.output_indices())...);
+    }
+    else
+    {
+        return utils::make_tuple(subinterval_iterable(std::begin(utils::get<IIs>(outbufs)), utils::size(utils::get<IIs>(outbufs)), 0, recipe.output_indices().size()-1, 0, 0)...);
+    }
+}
+
+}  // namespace internal
+
+template <std::size_t I = 0,
+          std::size_t ...Is,
+          typename DpfKey,
+          typename InputT,
+          typename OutputBuffers,
+          std::enable_if_t<!std::is_integral_v<std::decay_t<OutputBuffers>>, bool> = true>
+HEDLEY_ALWAYS_INLINE
+auto eval_interval_parallel(const DpfKey & dpf, InputT from, InputT to,
+    OutputBuffers & outbufs,  // NOLINT(runtime/references)
+    std::size_t threads = default_eval_threads())
+{
+    assert_not_wildcard_output<I, Is...>(dpf);
+
+    return internal::eval_interval_parallel<I, Is...>(dpf, dpf.offset_x(from), dpf.offset_x(to), outbufs, threads, std::make_index_sequence<1+sizeof...(Is)>());
+}
+
+template <std::size_t I = 0,
+          std::size_t ...Is,
+          typename DpfKey,
+          typename InputT>
+HEDLEY_ALWAYS_INLINE
+auto eval_interval_parallel(const DpfKey & dpf, InputT from, InputT to,
+    std::size_t threads = default_eval_threads())
+{
+    auto outbufs = utils::make_tuple(
+        make_output_buffer_for_interval<I>(dpf, from, to),
+        make_output_buffer_for_interval<Is>(dpf, from, to)...);
+
+    // see the comment in `dpf::eval_interval` on moving `outbufs`
+    auto iterable = eval_interval_parallel<I, Is...>(dpf, from, to, outbufs, threads);
+    return std::make_pair(std::move(outbufs), std::move(iterable));
+}
+
+template <std::size_t I = 0,
+          std::size_t ...Is,
+          typename DpfKey,
+          typename OutputBuffers,
+          std::enable_if_t<!std::is_integral_v<std::decay_t<OutputBuffers>>, bool> = true>
+HEDLEY_ALWAYS_INLINE
+auto eval_full_parallel(const DpfKey & dpf,
+    OutputBuffers & outbufs,  // NOLINT(runtime/references)
+    std::size_t threads = default_eval_threads())
+{
+    assert_not_wildcard_output<I, Is...>(dpf);
+
+    return internal::eval_full_parallel<I, Is...>(dpf, outbufs, threads, std::make_index_sequence<1+sizeof...(Is)>());
+}
+
+template <std::size_t I = 0,
+          std::size_t ...Is,
+          typename DpfKey>
+HEDLEY_ALWAYS_INLINE
+auto eval_full_parallel(const DpfKey & dpf,
+    std::size_t threads = default_eval_threads())
+{
+    auto outbufs = utils::make_tuple(
+        make_output_buffer_for_full<I>(dpf),
+        make_output_buffer_for_full<Is>(dpf)...);
+
+    // see the comment in `dpf::eval_full` on moving `outbufs`
+    auto iterable = eval_full_parallel<I, Is...>(dpf, outbufs, threads);
+    return std::make_pair(std::move(outbufs), std::move(iterable));
+}
+
+/// @brief evaluates `dpf` at the points described by `recipe` using
+///        `threads` threads
+/// @details Produces the same outputs, in the same layout, as
+///          `dpf::eval_sequence(dpf, recipe, outbufs, return_type)`.
+template <std::size_t I = 0,
+          std::size_t ...Is,
+          typename DpfKey,
+          typename OutputBuffers,
+          typename ReturnType = return_entire_node_tag_,
+          std::enable_if_t<!std::is_base_of_v<return_type_tag_, std::decay_t<OutputBuffers>>, bool> = true,
+          std::enable_if_t<std::is_base_of_v<return_type_tag_, ReturnType>, bool> = true>
+HEDLEY_ALWAYS_INLINE
+auto eval_sequence_parallel(const DpfKey & dpf, const sequence_recipe & recipe,
+    OutputBuffers & outbufs,  // NOLINT(runtime/references)
+    ReturnType return_type = ReturnType{},
+    std::size_t threads = default_eval_threads())
+{
+    assert_not_wildcard_output<I, Is...>(dpf);
+    assert_not_wildcard_input(dpf);
+
+    return internal::eval_sequence_parallel<I, Is...>(dpf, recipe, outbufs, return_type, threads, std::make_index_sequence<1+sizeof...(Is)>());
+}
+
+template <std::size_t I = 0,
+          std::size_t ...Is,
+          typename DpfKey,
+          typename ReturnType = return_entire_node_tag_,
+          std::enable_if_t<std::is_base_of_v<return_type_tag_, ReturnType>, bool> = true>
+HEDLEY_ALWAYS_INLINE
+auto eval_sequence_parallel(const DpfKey & dpf, const sequence_recipe & recipe,
+    ReturnType return_type = ReturnType{},
+    std::size_t threads = default_eval_threads())
+{
+    auto outbufs = utils::make_tuple(
+        make_output_buffer_for_recipe_subsequence<I>(dpf, recipe, return_type),
+        make_output_buffer_for_recipe_subsequence<Is>(dpf, recipe, return_type)...);
+
+    // see the comment in `dpf::eval_full` on moving `outbufs`
+    auto iterable = eval_sequence_parallel<I, Is...>(dpf, recipe, outbufs, return_type, threads);
+    return std::make_pair(std::move(outbufs), std::move(iterable));
+}
+
+}  // namespace dpf
+
+#endif  // LIBDPF_INCLUDE_DPF_EVAL_PARALLEL_HPP__
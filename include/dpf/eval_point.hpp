@@ -14,10 +14,15 @@
 #include <hedley/hedley.h>
 
 #include <cstddef>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
 #include <tuple>
+#include <type_traits>
 
 #include "dpf/dpf_key.hpp"
 #include "dpf/eval_common.hpp"
+#include "dpf/output_buffer.hpp"
 #include "dpf/path_memoizer.hpp"
 
 namespace dpf
@@ -68,6 +73,77 @@ auto eval_point(const DpfKey & dpf, InputT && x, PathMemoizer && path)
     return internal::eval_point_exterior<I>(dpf, path);
 }
 
+// number of root-to-leaf paths that `eval_points` advances together
+static constexpr std::size_t eval_points_batch = 32;
+
+/// @brief evaluates `points[0..count)`, in any order, writing the output
+///        for `points[i]` to `outputs[i]`
+/// @details The paths to a batch of points are walked in lockstep. At each
+///          level the batch is partitioned by direction so that each half
+///          can be handed to the batched `traverse_interior`, which keeps
+///          the PRG pipeline full, and the children are then scattered back
+///          into their lanes.
+template <std::size_t I,
+          typename DpfKey,
+          typename InputT,
+          typename Outputs>
+void eval_points(const DpfKey & dpf, const InputT * points, std::size_t count,
+    Outputs && outputs)
+{
+    using dpf_type = DpfKey;
+    using node_type = typename DpfKey::interior_node;
+    using output_type = typename DpfKey::concrete_output_type<I>;
+    using x_type = std::decay_t<decltype(dpf.offset_x(std::declval<InputT &>()))>;
+
+    x_type xs[eval_points_batch];
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    node_type nodes[eval_points_batch], halves[2][eval_points_batch];
+HEDLEY_PRAGMA(GCC diagnostic pop)
+    std::size_t lanes[2][eval_points_batch];
+
+    for (std::size_t i = 0; i < count; i += eval_points_batch)
+    {
+        std::size_t n = std::min(eval_points_batch, count - i);
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            InputT x = points[i+k];
+            xs[k] = dpf.offset_x(x);
+            utils::flip_msb_if_signed_integral(xs[k]);
+            nodes[k] = dpf.root();
+        }
+
+        auto mask = dpf.msb_mask;
+        for (std::size_t level_index = 1; level_index <= dpf.depth;
+            ++level_index, mask>>=1)
+        {
+            std::size_t m[2] = {0, 0};
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                bool bit = !!(mask & xs[k]);
+                lanes[bit][m[bit]] = k;
+                halves[bit][m[bit]++] = nodes[k];
+            }
+            for (bool dir : { false, true })
+            {
+                dpf_type::traverse_interior(halves[dir],
+                    dpf.correction_word(level_index-1, dir), dir,
+                    halves[dir], m[dir]);
+                for (std::size_t j = 0; j < m[dir]; ++j)
+                {
+                    nodes[lanes[dir][j]] = halves[dir][j];
+                }
+            }
+        }
+
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            outputs[i+k] = static_cast<output_type>(make_dpf_output<output_type>(
+                dpf.template traverse_exterior<I>(nodes[k]), xs[k]));
+        }
+    }
+}
+
 }  // namespace internal
 
 template <std::size_t I = 0,
@@ -99,6 +175,57 @@ auto eval_point(const DpfKey & dpf, InputT && x, PathMemoizer && path = PathMemo
         *eval_point<Is>(dpf, x, path)...);
 }
 
+/// @brief evaluates output `I` of `dpf` at each of `points[0..count)`,
+///        which need not be sorted or distinct
+/// @return `outputs`, with `outputs[i]` set to the output at `points[i]`
+template <std::size_t I = 0,
+          typename DpfKey,
+          typename InputT,
+          typename Outputs>
+HEDLEY_ALWAYS_INLINE
+auto & eval_points(const DpfKey & dpf, const InputT * points, std::size_t count,
+    Outputs & outputs)  // NOLINT(runtime/references)
+{
+    assert_not_wildcard_output<I>(dpf);
+
+    internal::eval_points<I>(dpf, points, count, outputs);
+    return outputs;
+}
+
+/// @brief evaluates output `I` of `dpf` at each point of the contiguous
+///        range `points`
+template <std::size_t I = 0,
+          typename DpfKey,
+          typename Points,
+          typename Outputs,
+          std::enable_if_t<!std::is_pointer_v<std::decay_t<Points>>, bool> = true>
+HEDLEY_ALWAYS_INLINE
+auto & eval_points(const DpfKey & dpf, const Points & points,
+    Outputs & outputs)  // NOLINT(runtime/references)
+{
+    if (HEDLEY_UNLIKELY(std::size(outputs) < std::size(points)))
+    {
+        throw std::length_error("outputs is smaller than points");
+    }
+    return eval_points<I>(dpf, std::data(points), std::size(points), outputs);
+}
+
+/// @brief evaluates output `I` of `dpf` at each point of the contiguous
+///        range `points`
+/// @return a `dpf::output_buffer` whose `i`th element is the output at
+///         `points[i]`
+template <std::size_t I = 0,
+          typename DpfKey,
+          typename Points>
+auto eval_points(const DpfKey & dpf, const Points & points)
+{
+    using output_type = typename DpfKey::concrete_output_type<I>;
+
+    auto outputs = dpf::output_buffer<output_type>(std::size(points));
+    eval_points<I>(dpf, std::data(points), std::size(points), outputs);
+    return outputs;
+}
+
 }  // namespace dpf
 
 #endif  // LIBDPF_INCLUDE_DPF_EVAL_POINT_HPP__
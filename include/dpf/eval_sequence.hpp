@@ -21,13 +21,13 @@
 #include <algorithm>
 #include <iterator>
 #include <stdexcept>
-#include <list>
 
 #include "dpf/dpf_key.hpp"
 #include "dpf/eval_common.hpp"
 #include "dpf/eval_point.hpp"
 #include "dpf/path_memoizer.hpp"
 #include "dpf/sequence_memoizer.hpp"
+#include "dpf/sequence_recipe.hpp"
 #include "dpf/sequence_utils.hpp"
 #include "dpf/subsequence_iterable.hpp"
 #include "dpf/subinterval_iterable.hpp"
@@ -164,69 +164,47 @@ HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
 HEDLEY_PRAGMA(GCC diagnostic pop)
     allocator alloc = allocator{};
 
-    if (!std::is_sorted(begin, end))
-    {
-        throw std::runtime_error("list must be sorted");
-    }
+    // throws if the list is not sorted
+    auto recipe = make_sequence_recipe<dpf_type>(begin, end);
+    const auto & level_endpoints = recipe.level_endpoints();
 
-    auto mask = dpf_type::msb_mask;
     std::size_t nodes_in_sequence = std::distance(begin, end);
     unique_ptr memo{alloc.allocate_unique_ptr(nodes_in_sequence*2)};
 
     bool curhalf = (dpf_type::depth ^ 1) & 1;
     memo[!curhalf*nodes_in_sequence + 0] = dpf.root();
 
-    std::list<ForwardIterator> splits{begin, end};
-
-    std::size_t level_index = 1;
-    auto func = [&](const bool flip = false)
+    for (std::size_t level_index = 1; level_index <= dpf_type::depth; ++level_index, curhalf=!curhalf)
     {
         std::size_t i = 0, j = 0;
         const node_type cw[2] = {
             dpf.correction_word(level_index-1, 0),
             dpf.correction_word(level_index-1, 1)
         };
-        // `lower` and `upper` are always adjacent elements of `splits` with `lower` < `upper`
-        // [lower, upper) = "block"
-        for (auto upper = std::begin(splits), lower = upper++; upper != std::end(splits); lower = upper++)
+        for (std::size_t r = level_endpoints[level_index-1]; r < level_endpoints[level_index]; ++r)
         {
-            // `upper_bound()` returns iterator to first element where the relevant bit (based on `mask`) is set
-            auto it = std::upper_bound(*lower, *upper, mask,
-                [&flip](auto a, auto b){ return static_cast<bool>(a&b) ^ flip; });
-            if (it == *lower)       // right only since first element in "block" requires right traversal
+            if (recipe.step(r) == -1)        // right only
             {
                 memo[curhalf*nodes_in_sequence + i++] = dpf_type::traverse_interior(memo[!curhalf*nodes_in_sequence + j++], cw[1], 1);
             }
-            else if (it == *upper)  // left only since no element in "block" requires right traversal
+            else if (recipe.step(r) == +1)   // left only
             {
                 memo[curhalf*nodes_in_sequence + i++] = dpf_type::traverse_interior(memo[!curhalf*nodes_in_sequence + j++], cw[0], 0);
             }
-            else                    // both ways since some (non-lower) element within "block" requires right traversal
+            else                             // both ways
             {
                 auto cur_node = memo[!curhalf*nodes_in_sequence + j++];
                 memo[curhalf*nodes_in_sequence + i++] = dpf_type::traverse_interior(cur_node, cw[0], 0);
                 memo[curhalf*nodes_in_sequence + i++] = dpf_type::traverse_interior(cur_node, cw[1], 1);
-                splits.insert(upper, it);
             }
         }
-    };
-    if (dpf_type::depth >= level_index)
-    {
-        func(utils::is_signed_integral_v<input_type>);
-        ++level_index;
-        mask >>= 1;
-        curhalf =! curhalf;
-    }
-    for (; level_index <= dpf_type::depth; ++level_index, mask>>=1, curhalf=!curhalf)
-    {
-        func();
     }
 
 HEDLEY_PRAGMA(GCC diagnostic push)
 HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
     using leaf_node_type = std::tuple_element_t<I, typename DpfKey::leaf_tuple>;
     auto rawbuf = reinterpret_cast<leaf_node_type *>(utils::data(outbuf));
-    auto cw = dpf.template leaf<I>();
+    auto cw = std::get<I>(dpf.leaf_nodes).get();
     auto buf = memo.get();
 
     constexpr auto clz = utils::countl_zero_symmetric_difference<input_type>{};
@@ -275,6 +253,7 @@ inline auto eval_sequence_interior(const DpfKey & dpf, const sequence_recipe & r
 {
     using dpf_type = DpfKey;
     using node_type = typename DpfKey::interior_node;
+    constexpr std::size_t batch_size = 32;
 
     // level_index represents the current level being built
     // level_index = 0 => root
@@ -293,18 +272,38 @@ inline auto eval_sequence_interior(const DpfKey & dpf, const sequence_recipe & r
         auto prevbuf = memoizer[level_index-1];
         auto currbuf = memoizer[level_index];
 
-        DPF_UNROLL_LOOP
-        for (std::size_t input_index = 0, output_index = 0; input_index < nodes_at_level; ++input_index, ++recipe_index)
+        // traversals are gathered by direction for a batch of parents at a
+        // time so that the PRG can evaluate several of them together; the
+        // whole batch is read before any child is written, so in-place
+        // memoizers see the same access order as a node-by-node traversal
+        node_type nodes[2][batch_size];
+        std::size_t slots[2][batch_size];
+        for (std::size_t input_index = 0, output_index = 0; input_index < nodes_at_level;)
         {
-            if (memoizer.traverse_first(recipe_index) == true)
+            std::size_t count[2] = { 0, 0 };
+            for (std::size_t end = std::min(nodes_at_level, input_index + batch_size);
+                input_index < end; ++input_index, ++recipe_index)
             {
-                bool dir = memoizer.get_direction(0);
-                currbuf[output_index++] = dpf_type::traverse_interior(prevbuf[input_index], cw[dir], dir);
+                if (memoizer.traverse_first(recipe_index) == true)
+                {
+                    bool dir = memoizer.get_direction(0);
+                    nodes[dir][count[dir]] = prevbuf[input_index];
+                    slots[dir][count[dir]++] = output_index++;
+                }
+                if (memoizer.traverse_second(recipe_index) == true)
+                {
+                    bool dir = memoizer.get_direction(1);
+                    nodes[dir][count[dir]] = prevbuf[input_index];
+                    slots[dir][count[dir]++] = output_index++;
+                }
             }
-            if (memoizer.traverse_second(recipe_index) == true)
+            for (bool dir : { false, true })
             {
-                bool dir = memoizer.get_direction(1);
-                currbuf[output_index++] = dpf_type::traverse_interior(prevbuf[input_index], cw[dir], dir);
+                dpf_type::traverse_interior(nodes[dir], cw[dir], dir, nodes[dir], count[dir]);
+                for (std::size_t k = 0; k < count[dir]; ++k)
+                {
+                    currbuf[slots[dir][k]] = nodes[dir][k];
+                }
             }
         }
     }
@@ -315,7 +314,7 @@ template <std::size_t I,
           typename OutputBuffer,
           typename SequenceMemoizer>
 inline auto eval_sequence_exterior_entire_node(const DpfKey & dpf, const sequence_recipe & recipe,
-    OutputBuffer && outbuf, SequenceMemoizer && memoizer)
+    OutputBuffer && outbuf, SequenceMemoizer && memoizer, std::size_t start_leaf = 0)
 {
     assert_not_wildcard_output<I>(dpf);
 
@@ -335,11 +334,11 @@ HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
         auto leaf = dpf.template traverse_exterior<I>(buf[j]);
         if constexpr (std::is_same_v<output_type, dpf::bit>)
         {
-            std::memcpy(&rawbuf[j], &leaf, sizeof(leaf));
+            std::memcpy(&rawbuf[start_leaf+j], &leaf, sizeof(leaf));
         }
         else
         {
-            std::memcpy(&outbuf[j*dpf_type::outputs_per_leaf], &leaf, sizeof(output_type)*dpf_type::outputs_per_leaf);
+            std::memcpy(&outbuf[(start_leaf+j)*dpf_type::outputs_per_leaf], &leaf, sizeof(output_type)*dpf_type::outputs_per_leaf);
         }
     }
 HEDLEY_PRAGMA(GCC diagnostic pop)
@@ -350,7 +349,7 @@ template <std::size_t I,
           typename OutputBuffer,
           typename SequenceMemoizer>
 inline auto eval_sequence_exterior_output_only(const DpfKey & dpf, const sequence_recipe & recipe,
-    OutputBuffer && outbuf, SequenceMemoizer && memoizer)
+    OutputBuffer && outbuf, SequenceMemoizer && memoizer, std::size_t start = 0)
 {
     assert_not_wildcard_output<I>(dpf);
 
@@ -359,7 +358,7 @@ inline auto eval_sequence_exterior_output_only(const DpfKey & dpf, const sequenc
 
 HEDLEY_PRAGMA(GCC diagnostic push)
 HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
-    auto cw = dpf.template leaf<I>();
+    auto cw = std::get<I>(dpf.leaf_nodes).get();
     using node_type = typename DpfKey::exterior_node;
     using leaf_node_type = std::tuple_element_t<I, typename DpfKey::leaf_tuple>;
     auto buf = memoizer[dpf.depth];
@@ -376,7 +375,7 @@ HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
             ++j;
             node = dpf_type::template traverse_exterior<I>(buf[j], get_if_lo_bit(cw, buf[j]));
         }
-        outbuf[i] = extract_leaf<node_type, output_type>(node, recipe.output_indices()[i] % dpf_type::outputs_per_leaf);
+        outbuf[start+i] = extract_leaf<node_type, output_type>(node, recipe.output_indices()[i] % dpf_type::outputs_per_leaf);
     }
 HEDLEY_PRAGMA(GCC diagnostic pop)
 }
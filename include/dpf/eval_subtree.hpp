@@ -0,0 +1,194 @@
+/// @file dpf/eval_subtree.hpp
+/// @brief delegating the evaluation of whole subtrees
+/// @details `dpf::export_frontier` expands a key down to some level `L` and
+///          returns the `2^L` interior nodes found there. Each such node,
+///          whose low bit is its advice bit, is a complete seed for its
+///          subtree: `dpf::eval_subtree` finishes the expansion below it
+///          using only the correction words and leaves below `L`, which
+///          are the same for every subtree. A coordinator can therefore
+///          ship the (common part of the) key to its workers once, and
+///          then hand out 16-byte seeds as units of work.
+///
+///          The outputs of the subtree below node `k` on level `L` are
+///          exactly those that `dpf::eval_full` writes to positions
+///          `[k * n, (k+1) * n)` of its output buffer, where
+///          `n = outputs_per_leaf * 2^(depth-L)`.
+/// @author Ryan Henry <ryan.henry@ucalgary.ca>
+/// @copyright Copyright (c) 2019-2024 Ryan Henry and [others](@ref authors)
+/// @license Released under a GNU General Public v2.0 (GPLv2) license;
+///          see [LICENSE.md](@ref license) for details.
+
+#ifndef LIBDPF_INCLUDE_DPF_EVAL_SUBTREE_HPP__
+#define LIBDPF_INCLUDE_DPF_EVAL_SUBTREE_HPP__
+
+#include <hedley/hedley.h>
+
+#include <cstddef>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "dpf/dpf_key.hpp"
+#include "dpf/eval_common.hpp"
+#include "dpf/output_buffer.hpp"
+#include "dpf/interval_memoizer.hpp"
+#include "dpf/eval_interval.hpp"
+
+namespace dpf
+{
+
+namespace internal
+{
+
+/// @brief computes the nodes at `level` that are ancestors of the leaves
+///        `[from_node, to_node)`, in order
+template <typename DpfKey,
+          typename IntegralT = typename DpfKey::integral_type>
+auto expand_frontier(const DpfKey & dpf, IntegralT from_node,
+    IntegralT to_node, std::size_t level)
+{
+    using dpf_type = DpfKey;
+    using node_type = typename DpfKey::interior_node;
+    constexpr auto depth = dpf_type::depth;
+
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    std::vector<node_type> frontier{dpf.root()}, children;
+HEDLEY_PRAGMA(GCC diagnostic pop)
+    for (std::size_t level_index = 1; level_index <= level; ++level_index)
+    {
+        std::size_t shift = depth - level_index;
+        // on level 1, `shift + 1 == depth`, which may be the full bitlength
+        // of `IntegralT`; the children then start at node 0
+        IntegralT lo = from_node >> shift,
+            hi = (to_node - 1) >> shift,
+            first_child = shift + 1 < utils::bitlength_of_v<IntegralT>
+                ? IntegralT((from_node >> (shift + 1)) << 1) : IntegralT{0};
+        const node_type cw[2] = {
+            dpf.correction_word(level_index-1, 0),
+            dpf.correction_word(level_index-1, 1)
+        };
+
+        children.resize(2 * frontier.size());
+        dpf_type::traverse_interior(frontier.data(), cw, children.data(),
+            frontier.size());
+        auto first = std::begin(children) + (lo - first_child);
+        frontier.assign(first, first + (hi - lo + 1));
+    }
+    return frontier;
+}
+
+template <std::size_t ...Is,
+          typename DpfKey,
+          typename OutputBuffers,
+          std::size_t ...IIs>
+auto eval_subtree(const DpfKey & dpf, std::size_t level,
+    typename DpfKey::integral_type node_index,
+    const typename DpfKey::interior_node & seed, OutputBuffers && outbufs,
+    std::index_sequence<IIs...>)
+{
+    using dpf_type = DpfKey;
+    using integral_type = typename DpfKey::integral_type;
+    constexpr auto depth = dpf_type::depth;
+
+    if (HEDLEY_UNLIKELY(level > depth))
+    {
+        throw std::invalid_argument("level exceeds the depth of the dpf");
+    }
+    if (HEDLEY_UNLIKELY(level < utils::bitlength_of_v<integral_type>
+        && node_index >= (integral_type{1} << level)))
+    {
+        throw std::invalid_argument("node_index is not on the given level");
+    }
+
+    const std::size_t shift = depth - level;
+    // `integral_type` is at least as wide as `std::size_t`
+    if (HEDLEY_UNLIKELY(shift >= utils::bitlength_of_v<std::size_t>))
+    {
+        throw std::length_error("subtree has too many leaves to evaluate");
+    }
+    integral_type from_node = node_index << shift,
+        to_node = (node_index + 1) << shift;
+    auto memoizer = dpf::basic_interval_memoizer<dpf_type>(std::size_t(1) << shift);
+    eval_subtree_interior(dpf, level, seed, from_node, to_node, memoizer);
+    (eval_interval_exterior<Is>(dpf, from_node, to_node,
+        utils::get<IIs>(outbufs), memoizer), ...);
+
+    return utils::make_tuple(std::ref(utils::get<IIs>(outbufs))...);
+}
+
+}  // namespace internal
+
+/// @brief returns the `2^level` interior nodes on `level` of `dpf`, from
+///        left to right
+/// @throws std::invalid_argument if `level` exceeds the depth of `dpf`
+template <typename DpfKey>
+auto export_frontier(const DpfKey & dpf, std::size_t level)
+{
+    using integral_type = typename DpfKey::integral_type;
+    constexpr auto depth = DpfKey::depth;
+
+    if (HEDLEY_UNLIKELY(level > depth))
+    {
+        throw std::invalid_argument("level exceeds the depth of the dpf");
+    }
+    // `expand_frontier` only uses `to_node - 1`, so a domain that spans all
+    // of `integral_type` can end at the (wrapped-around) node 0
+    const integral_type to_node = depth < utils::bitlength_of_v<integral_type>
+        ? integral_type(integral_type{1} << depth) : integral_type{0};
+    return internal::expand_frontier(dpf, integral_type{0}, to_node, level);
+}
+
+/// @brief evaluates the leaves below node `node_index` on `level`, whose
+///        value is `seed`, writing `outputs_per_leaf * 2^(depth-level)`
+///        outputs to the start of each of `outbufs`
+/// @details Only the correction words below `level` and the leaves of
+///          `dpf` are used; its root is ignored.
+/// @throws std::invalid_argument if `level` exceeds the depth of `dpf` or
+///         `node_index` is not on `level`
+/// @throws std::length_error if the subtree has too many leaves to count
+///         in a `std::size_t`
+template <std::size_t I = 0,
+          std::size_t ...Is,
+          typename DpfKey,
+          typename OutputBuffers>
+HEDLEY_ALWAYS_INLINE
+auto eval_subtree(const DpfKey & dpf, std::size_t level,
+    typename DpfKey::integral_type node_index,
+    const typename DpfKey::interior_node & seed,
+    OutputBuffers & outbufs)  // NOLINT(runtime/references)
+{
+    assert_not_wildcard_output<I, Is...>(dpf);
+
+    return internal::eval_subtree<I, Is...>(dpf, level, node_index, seed,
+        outbufs, std::make_index_sequence<1+sizeof...(Is)>());
+}
+
+template <std::size_t I = 0,
+          std::size_t ...Is,
+          typename DpfKey>
+HEDLEY_ALWAYS_INLINE
+auto eval_subtree(const DpfKey & dpf, std::size_t level,
+    typename DpfKey::integral_type node_index,
+    const typename DpfKey::interior_node & seed)
+{
+    // `internal::eval_subtree` throws before using `outputs` if `shift` is
+    // out of range
+    const std::size_t shift = DpfKey::depth - std::min(level, DpfKey::depth);
+    const std::size_t outputs = shift < utils::bitlength_of_v<std::size_t>
+        ? DpfKey::outputs_per_leaf << shift : 0;
+    auto outbufs = utils::make_tuple(
+        dpf::output_buffer<typename DpfKey::concrete_output_type<I>>(outputs),
+        dpf::output_buffer<typename DpfKey::concrete_output_type<Is>>(outputs)...);
+
+    // see the comment in `dpf::eval_full` on moving `outbufs`
+    auto iterable = eval_subtree<I, Is...>(dpf, level, node_index, seed, outbufs);
+    return std::make_pair(std::move(outbufs), std::move(iterable));
+}
+
+}  // namespace dpf
+
+#endif  // LIBDPF_INCLUDE_DPF_EVAL_SUBTREE_HPP__
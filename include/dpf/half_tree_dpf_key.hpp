@@ -0,0 +1,345 @@
+/// @file dpf/half_tree_dpf_key.hpp
+/// @brief DPF keys using the half-tree construction
+/// @details A `dpf::half_tree_dpf_key` expands each interior node with a
+///          single evaluation of the circular correlation-robust hash
+///          `H(x) = pi(sigma(x)) ^ sigma(x)`, where `pi` is the fixed-key
+///          `InteriorPRG` and `sigma(xL||xR) = (xL^xR)||xL`. The left child
+///          of `s` is `H(s) ^ t*CW` and the right child is the left child
+///          xored with `s` itself, where `t` is the low bit of `s`. The two
+///          roots differ by a global offset whose low bit is set, so that
+///          nodes on the special path always differ in their control bits.
+///
+///          The key type derives from `dpf::dpf_key` and only overrides the
+///          interior traversal, so it works unchanged with `eval_point`,
+///          `eval_interval`, `eval_full`, `eval_sequence` and their
+///          memoizers. Compared to `dpf::dpf_key`, full-domain evaluation
+///          and key generation each need half as many PRG calls.
+/// @author Ryan Henry <ryan.henry@ucalgary.ca>
+/// @copyright Copyright (c) 2019-2024 Ryan Henry and [others](@ref authors)
+/// @license Released under a GNU General Public v2.0 (GPLv2) license;
+///          see [LICENSE.md](@ref license) for details.
+
+#ifndef LIBDPF_INCLUDE_DPF_HALF_TREE_DPF_KEY_HPP__
+#define LIBDPF_INCLUDE_DPF_HALF_TREE_DPF_KEY_HPP__
+
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+#include <tuple>
+#include <type_traits>
+
+#include "dpf/dpf_key.hpp"
+
+namespace dpf
+{
+
+template <typename InteriorPRG,
+          typename ExteriorPRG,
+          typename InputT,
+          typename OutputT,
+          typename ...OutputTs>
+struct half_tree_dpf_key
+    : public dpf_key<InteriorPRG, ExteriorPRG, InputT, OutputT, OutputTs...>
+{
+  public:
+    using base_type = dpf_key<InteriorPRG, ExteriorPRG, InputT, OutputT, OutputTs...>;
+    using typename base_type::interior_prg;
+    using typename base_type::interior_node;
+    using typename base_type::input_type;
+    using typename base_type::leaf_tuple;
+    using typename base_type::beaver_tuple;
+    using typename base_type::correction_words_array;
+    using typename base_type::correction_advice_array;
+
+    static_assert(std::is_same_v<interior_node, simde__m128i>,
+        "half-tree keys require 128-bit interior nodes");
+
+    using base_type::base_type;
+    half_tree_dpf_key(const half_tree_dpf_key &) = delete;
+    half_tree_dpf_key(half_tree_dpf_key &&) = default;
+
+    template <typename Emplaceable>
+    HEDLEY_ALWAYS_INLINE
+    static void emplace(Emplaceable & output,
+                   const interior_node & root,
+                   const correction_words_array & correction_words,
+                   const correction_advice_array & correction_advice,
+                   const leaf_tuple & leaves,
+                   const beaver_tuple & beavers,
+                   const input_type & offset_share)
+    {
+        utils::dpf_emplacer<half_tree_dpf_key, Emplaceable>::emplace(output, root, correction_words, correction_advice, leaves, beavers, offset_share);
+    }
+
+    template <typename EmplaceableContainer>
+    HEDLEY_ALWAYS_INLINE
+    static void emplace_back(EmplaceableContainer & output,
+                       const interior_node & root,
+                       const correction_words_array & correction_words,
+                       const correction_advice_array & correction_advice,
+                       const leaf_tuple & leaves,
+                       const beaver_tuple & beavers,
+                       const input_type & offset_share)
+    {
+        utils::dpf_back_emplacer<half_tree_dpf_key, EmplaceableContainer>::emplace_back(output, root, correction_words, correction_advice, leaves, beavers, offset_share);
+    }
+
+    using base_type::correction_word;
+
+    /// @brief both children use the same correction word
+    HEDLEY_ALWAYS_INLINE
+    const interior_node & correction_word(std::size_t level, bool) const
+    {
+        return this->correction_word(level);
+    }
+
+    HEDLEY_NO_THROW
+    HEDLEY_ALWAYS_INLINE
+    HEDLEY_CONST
+    static interior_node sigma(const interior_node & node) noexcept
+    {
+        return simde_mm_xor_si128(simde_mm_shuffle_epi32(node, 0x4e),
+            simde_mm_and_si128(node, simde_mm_set_epi64x(-1, 0)));
+    }
+
+    HEDLEY_NO_THROW
+    HEDLEY_ALWAYS_INLINE
+    HEDLEY_CONST
+    static interior_node hash(const interior_node & node) noexcept
+    {
+        return interior_prg::eval(sigma(node), 0);
+    }
+
+    HEDLEY_NO_THROW
+    HEDLEY_ALWAYS_INLINE
+    HEDLEY_CONST
+    static auto traverse_interior(const interior_node & node,
+        const interior_node & cw, bool dir) noexcept
+    {
+        return dpf::xor_if(dpf::xor_if_lo_bit(hash(node), cw, node), node, dir);
+    }
+
+    /// @brief traverses `count` nodes in the same direction
+    /// @details Writes the `dir`-child of `nodes[i]` to `out[i]`. `nodes`
+    ///          and `out` may alias.
+    HEDLEY_NO_THROW
+    static void traverse_interior(const interior_node * nodes,
+        const interior_node & cw, bool dir, interior_node * out,
+        std::size_t count) noexcept
+    {
+        interior_node parents[traversal_batch], hashes[traversal_batch];
+        for (std::size_t i = 0; i < count; i += traversal_batch)
+        {
+            std::size_t n = std::min(traversal_batch, count - i);
+            hash_batch(nodes + i, parents, hashes, n);
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                out[i+k] = dpf::xor_if(dpf::xor_if_lo_bit(hashes[k], cw,
+                    parents[k]), parents[k], dir);
+            }
+        }
+    }
+
+    /// @brief traverses `count` nodes in both directions
+    /// @details Writes the left and right children of `nodes[i]` to
+    ///          `out[2*i]` and `out[2*i+1]`, respectively, using a single
+    ///          hash evaluation per parent. `nodes` and `out` may alias,
+    ///          provided that no child overwrites a node that comes after
+    ///          its parent.
+    HEDLEY_NO_THROW
+    HEDLEY_ALWAYS_INLINE
+    static void traverse_interior(const interior_node * nodes,
+        const interior_node (&cw)[2], interior_node * out,
+        std::size_t count) noexcept
+    {
+        traverse_interior(nodes, cw, count, out, count);
+    }
+
+    /// @brief traverses `count` nodes in both directions, with a separate
+    ///        correction word for each group of `nodes_per_cw` nodes
+    /// @details See `dpf::dpf_key::traverse_interior`; only `cws[2*g]` is
+    ///          read, since both children share a correction word.
+    HEDLEY_NO_THROW
+    static void traverse_interior(const interior_node * nodes,
+        const interior_node * cws, std::size_t nodes_per_cw,
+        interior_node * out, std::size_t count) noexcept
+    {
+        interior_node parents[traversal_batch], hashes[traversal_batch];
+        const interior_node * cw = cws;
+        std::size_t left_in_group = nodes_per_cw;
+        for (std::size_t i = 0; i < count; i += traversal_batch)
+        {
+            std::size_t n = std::min(traversal_batch, count - i);
+            hash_batch(nodes + i, parents, hashes, n);
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                auto left = dpf::xor_if_lo_bit(hashes[k], *cw, parents[k]);
+                out[2*(i+k)] = left;
+                out[2*(i+k)+1] = simde_mm_xor_si128(left, parents[k]);
+                if (--left_in_group == 0)
+                {
+                    cw += 2;
+                    left_in_group = nodes_per_cw;
+                }
+            }
+        }
+    }
+
+  private:
+    static constexpr std::size_t traversal_batch = 32;
+
+    HEDLEY_ALWAYS_INLINE
+    static void hash_batch(const interior_node * nodes, interior_node * parents,
+        interior_node * hashes, std::size_t n) noexcept
+    {
+        interior_node sigmas[traversal_batch];
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            parents[k] = nodes[k];
+            sigmas[k] = sigma(parents[k]);
+        }
+        interior_prg::eval_many(sigmas, 0, hashes, n);
+    }
+};  // struct half_tree_dpf_key
+
+namespace utils
+{
+
+template <typename InteriorPRG,
+          typename ExteriorPRG,
+          typename InputT,
+          typename OutputT,
+          typename ...OutputTs>
+struct half_tree_dpf_type
+{
+    using type = half_tree_dpf_key<InteriorPRG, ExteriorPRG,
+        std::decay_t<InputT>,
+        std::decay_t<OutputT>,
+        std::decay_t<OutputTs>...>;
+};
+
+template <typename InteriorPRG,
+          typename ExteriorPRG,
+          typename InputT,
+          typename OutputT,
+          typename ...OutputTs>
+using half_tree_dpf_type_t = typename half_tree_dpf_type<InteriorPRG, ExteriorPRG, InputT, OutputT, OutputTs...>::type;
+
+}  // namespace utils
+
+namespace detail
+{
+
+template <typename InteriorPRG,
+          typename ExteriorPRG,
+          typename InputT,
+          typename OutputT,
+          typename ...OutputTs>
+auto make_half_tree_dpf_impl(dpfargs<InputT, OutputT, OutputTs...> args, root_sampler_t<InteriorPRG> && root_sampler = dpf::uniform_sample<typename InteriorPRG::block_type>)
+{
+    using dpf_type = utils::half_tree_dpf_type_t<InteriorPRG, ExteriorPRG,
+                                                 InputT, OutputT, OutputTs...>;
+    using interior_node = typename dpf_type::interior_node;
+    using input_type = typename dpf_type::input_type;
+    using correction_words_array = typename dpf_type::correction_words_array;
+    using correction_advice_array = typename dpf_type::correction_advice_array;
+
+    constexpr auto depth = dpf_type::depth;
+    auto mask = dpf_type::msb_mask;
+
+    input_type x, x0{}, x1{};
+    if constexpr (dpf::is_wildcard_v<InputT>)
+    {
+        std::tie(x, x0, x1) = args.x();
+    }
+    else
+    {
+        x = args.x;
+    }
+
+    utils::flip_msb_if_signed_integral(x);
+
+    // the roots differ by `delta`, whose low bit is set
+    const interior_node delta = dpf::set_lo_bit(root_sampler());
+    const interior_node root0 = dpf::unset_lo_bit(root_sampler());
+    const interior_node root[2] = {
+        root0,
+        simde_mm_xor_si128(root0, delta)
+    };
+
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    correction_words_array correction_words;
+HEDLEY_PRAGMA(GCC diagnostic pop)
+    correction_advice_array correction_advice{};
+
+    interior_node parent[2] = { root[0], root[1] };
+
+    for (std::size_t level = 0; level < depth; ++level, mask >>= 1)
+    {
+        bool bit = !!(mask & x);
+
+        // the children on the path must differ by `delta`, and those off
+        // of it must agree; the right children differ by whatever the
+        // left children differ by, xored with `parent[0]^parent[1]=delta`
+        auto cw = dpf::xor_if(simde_mm_xor_si128(dpf_type::hash(parent[0]),
+            dpf_type::hash(parent[1])), delta, !bit);
+        parent[0] = dpf_type::traverse_interior(parent[0], cw, bit);
+        parent[1] = dpf_type::traverse_interior(parent[1], cw, bit);
+
+        correction_words[level] = cw;
+    }
+
+    bool sign0 = dpf::get_lo_bit(parent[0]);
+
+    auto [pair0, pair1] = std::apply([&x, &parent, &sign0](auto && ...ys)
+        {
+            return dpf::make_leaves<ExteriorPRG>(x,
+                                                 dpf::unset_lo_2bits(parent[0]),
+                                                 dpf::unset_lo_2bits(parent[1]),
+                                                 sign0, ys...); }, args.y);
+    auto && [leaves0, beavers0] = pair0;
+    auto && [leaves1, beavers1] = pair1;
+
+    return std::make_tuple(correction_words, correction_advice,
+        std::make_tuple(root[0], leaves0, beavers0, x0),
+        std::make_tuple(root[1], leaves1, beavers1, x1));
+}  // make_half_tree_dpf_impl
+
+}  // namespace detail
+
+template <typename InteriorPRG = dpf::prg::aes128,
+          typename ExteriorPRG = InteriorPRG,
+          typename InputT,
+          typename OutputT = dpf::bit,
+          typename ...OutputTs>
+auto make_half_tree_dpf(dpfargs<InputT, OutputT, OutputTs...> args, root_sampler_t<InteriorPRG> && root_sampler = dpf::uniform_sample<typename InteriorPRG::block_type>)
+{
+    using dpf_type = utils::half_tree_dpf_type_t<InteriorPRG, ExteriorPRG,
+                                                 InputT, OutputT, OutputTs...>;
+
+    auto [correction_words, correction_advice,
+          tuple0, tuple1] = detail::make_half_tree_dpf_impl<InteriorPRG, ExteriorPRG>(args,
+            std::forward<root_sampler_t<InteriorPRG>>(root_sampler));
+    auto & [root0, leaves0, beavers0, offset0] = tuple0;
+    auto & [root1, leaves1, beavers1, offset1] = tuple1;
+
+    return std::make_pair(
+        dpf_type{root0, correction_words, correction_advice,
+            leaves0, beavers0, offset0},
+        dpf_type{root1, correction_words, correction_advice,
+            leaves1, beavers1, offset1});
+}  // make_half_tree_dpf
+
+template <typename InteriorPRG = dpf::prg::aes128,
+          typename ExteriorPRG = InteriorPRG,
+          typename InputT,
+          typename ...OutputTs>
+auto make_half_tree_dpf(InputT && x, OutputTs && ...ys)
+{
+    return make_half_tree_dpf<InteriorPRG, ExteriorPRG>(dpf::make_dpfargs(x, ys...));
+}
+
+}  // namespace dpf
+
+#endif  // LIBDPF_INCLUDE_DPF_HALF_TREE_DPF_KEY_HPP__
@@ -17,18 +17,31 @@
 #include <algorithm>
 #include <new>
 #include <limits>
+#include <memory>
 #include <stdexcept>
 #include <optional>
 #include <array>
+#include <utility>
 
 #include "dpf/dpf_key.hpp"
 
 namespace dpf
 {
 
+/// @brief common base of every interval memoizer; lets the evaluation
+///        functions tell a memoizer apart from an output buffer
+struct interval_memoizer_tag_ {};
+
+/// @brief type-erased interface to an interval memoizer
+/// @details The evaluation functions are templated on the memoizer type and
+///          call the concrete memoizers (which derive from
+///          `dpf::static_interval_memoizer_base`) directly, so that indexing
+///          into the buffer inlines into the per-node loops. This interface
+///          exists only for callers that need to choose a memoizer at
+///          runtime; see `dpf::type_erased_interval_memoizer`.
 template <typename DpfKey,
           typename ReturnT = typename DpfKey::interior_node *>
-struct interval_memoizer_base
+struct interval_memoizer_base : public interval_memoizer_tag_
 {
   public:
     using dpf_type = DpfKey;
@@ -37,6 +50,8 @@ struct interval_memoizer_base
     using iterator_type = return_type;
     using node_type = typename DpfKey::interior_node;
 
+    virtual ~interval_memoizer_base() = default;
+
     // level 0 should access the root
     // level goes up to (and including) depth
     virtual return_type operator[](std::size_t) const noexcept = 0;
@@ -45,12 +60,50 @@ struct interval_memoizer_base
     virtual return_type begin() const noexcept = 0;
     virtual return_type end() const noexcept = 0;
 
-    virtual std::size_t assign_interval(const dpf_type & dpf, integral_type new_from, integral_type new_to)
+    virtual std::size_t assign_interval(const dpf_type & dpf, integral_type new_from, integral_type new_to) = 0;
+    virtual std::size_t assign_subtree(const dpf_type & dpf, std::size_t level,
+        const node_type & node, integral_type new_from, integral_type new_to) = 0;
+    virtual std::size_t advance_level() = 0;
+    virtual std::size_t get_nodes_at_level() const = 0;
+    virtual std::size_t get_nodes_at_level(std::size_t level) const = 0;
+};
+
+/// @brief static-dispatch base of the concrete interval memoizers
+/// @details `Derived` supplies only `operator[](level)`, which returns the
+///          (aligned) start of the buffer for `level`; everything else is
+///          implemented here without any virtual calls.
+template <typename Derived,
+          typename DpfKey>
+struct static_interval_memoizer_base : public interval_memoizer_tag_
+{
+  public:
+    using dpf_type = DpfKey;
+    using integral_type = typename DpfKey::integral_type;
+    using return_type = typename DpfKey::interior_node *;
+    using iterator_type = return_type;
+    using node_type = typename DpfKey::interior_node;
+
+    // iterators should access most recently completed level
+    HEDLEY_ALWAYS_INLINE
+    HEDLEY_NO_THROW
+    return_type begin() const noexcept
+    {
+        return derived()[level_index - 1];
+    }
+
+    HEDLEY_ALWAYS_INLINE
+    HEDLEY_NO_THROW
+    return_type end() const noexcept
+    {
+        return derived()[level_index - 1] + get_nodes_at_level(level_index - 1);
+    }
+
+    std::size_t assign_interval(const dpf_type & dpf, integral_type new_from, integral_type new_to)
     {
         static constexpr auto complement_of = std::bit_not{};
         if (dpf_.has_value() == false
             || std::memcmp(&dpf_root_, &dpf.root(), sizeof(node_type)) != 0
-            || std::memcmp(&dpf_common_part_hash_, &dpf.common_part_hash(), sizeof(digest_type)) != 0
+            || std::memcmp(&dpf_interior_hash_, &dpf.interior_hash(), sizeof(digest_type)) != 0
             || from_.value_or(complement_of(new_from)) != new_from
             || to_.value_or(complement_of(new_to)) != new_to)
         {
@@ -59,10 +112,10 @@ struct interval_memoizer_base
                 throw std::length_error("size of new interval is too large for memoizer");
             }
 
-            this->operator[](0)[0] = dpf.root();
+            derived()[0][0] = dpf.root();
             dpf_ = std::cref(dpf);
             dpf_root_ = dpf.root();
-            dpf_common_part_hash_ = dpf.common_part_hash();
+            dpf_interior_hash_ = dpf.interior_hash();
             from_ = new_from;
             to_ = new_to;
             level_index = 1;
@@ -71,6 +124,31 @@ struct interval_memoizer_base
         return level_index;
     }
 
+    /// @brief prepares to evaluate the leaves `[new_from, new_to)` beneath
+    ///        `node`, the (already computed) ancestor of all of them at
+    ///        `level`; levels above `level` are left unset
+    /// @details `node` may be a seed handed out by a coordinator (see
+    ///          `dpf::eval_subtree`) rather than one derived from the key's
+    ///          own root, so the key is not remembered as the owner of the
+    ///          levels built here.
+    std::size_t assign_subtree(const dpf_type & /*dpf*/, std::size_t level,
+        const node_type & node, integral_type new_from, integral_type new_to)
+    {
+        if (new_to - new_from > output_length)
+        {
+            throw std::length_error("size of new interval is too large for memoizer");
+        }
+
+        derived()[level][0] = node;
+        // forget the cached key so that a later `assign_interval` starts over
+        dpf_ = std::nullopt;
+        from_ = new_from;
+        to_ = new_to;
+        level_index = level + 1;
+
+        return level_index;
+    }
+
     std::size_t advance_level()
     {
         return ++level_index;
@@ -118,7 +196,7 @@ struct interval_memoizer_base
     std::size_t output_length;
     std::size_t level_index;  // indicates current level being built
 
-    explicit interval_memoizer_base(std::size_t output_len)
+    explicit static_interval_memoizer_base(std::size_t output_len)
       : dpf_{std::nullopt},
         from_{std::nullopt},
         to_{std::nullopt},
@@ -127,21 +205,28 @@ struct interval_memoizer_base
     { }
 
   private:
+    HEDLEY_ALWAYS_INLINE
+    const Derived & derived() const noexcept
+    {
+        return static_cast<const Derived &>(*this);
+    }
+
     std::optional<std::reference_wrapper<const dpf_type>> dpf_;
     node_type dpf_root_;
-    digest_type dpf_common_part_hash_;
+    digest_type dpf_interior_hash_;
     std::optional<integral_type> from_;
     std::optional<integral_type> to_;
 };
 
 template <typename DpfKey,
           typename Allocator = aligned_allocator<typename DpfKey::interior_node>>
-struct basic_interval_memoizer final : public interval_memoizer_base<DpfKey>
+struct basic_interval_memoizer final
+  : public static_interval_memoizer_base<basic_interval_memoizer<DpfKey, Allocator>, DpfKey>
 {
   private:
 HEDLEY_PRAGMA(GCC diagnostic push)
 HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
-    using parent = interval_memoizer_base<DpfKey>;
+    using parent = static_interval_memoizer_base<basic_interval_memoizer<DpfKey, Allocator>, DpfKey>;
 HEDLEY_PRAGMA(GCC diagnostic pop)
   public:
     using unique_ptr = typename Allocator::unique_ptr;
@@ -172,7 +257,7 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
 HEDLEY_PRAGMA(GCC diagnostic push)
 HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
     explicit basic_interval_memoizer(std::size_t output_len, Allocator alloc = Allocator{})
-      : parent::interval_memoizer_base(output_len),
+      : parent::static_interval_memoizer_base(output_len),
         pivot{std::max((output_len>>1)+(output_len&1)-1, output_len+6>>2)},
         buf{alloc.allocate_unique_ptr(pivot+((output_len+2)>>1))}
     {
@@ -182,26 +267,12 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
 
     HEDLEY_ALWAYS_INLINE
     HEDLEY_NO_THROW
-    return_type operator[](std::size_t level) const noexcept override
+    return_type operator[](std::size_t level) const noexcept
     {
         bool b = (depth ^ level) & 1;
         return Allocator::assume_aligned(&buf[b*pivot]);
     }
 
-    HEDLEY_ALWAYS_INLINE
-    HEDLEY_NO_THROW
-    return_type begin() const noexcept override
-    {
-        return this->operator[](level_index - 1);
-    }
-
-    HEDLEY_ALWAYS_INLINE
-    HEDLEY_NO_THROW
-    return_type end() const noexcept override
-    {
-        return this->operator[](level_index - 1) + get_nodes_at_level(level_index - 1);
-    }
-
   private:
     static constexpr auto clz = utils::countl_zero<std::size_t>{};
     std::size_t pivot;
@@ -210,12 +281,13 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
 
 template <typename DpfKey,
           typename Allocator = aligned_allocator<typename DpfKey::interior_node>>
-struct full_tree_interval_memoizer final : public interval_memoizer_base<DpfKey>
+struct full_tree_interval_memoizer final
+  : public static_interval_memoizer_base<full_tree_interval_memoizer<DpfKey, Allocator>, DpfKey>
 {
   private:
 HEDLEY_PRAGMA(GCC diagnostic push)
 HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
-    using parent = interval_memoizer_base<DpfKey>;
+    using parent = static_interval_memoizer_base<full_tree_interval_memoizer<DpfKey, Allocator>, DpfKey>;
 HEDLEY_PRAGMA(GCC diagnostic pop)
   public:
     using node_type = typename DpfKey::interior_node;
@@ -233,7 +305,7 @@ HEDLEY_PRAGMA(GCC diagnostic push)
 HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
     explicit full_tree_interval_memoizer(std::size_t output_len,
         Allocator alloc = Allocator{})
-      : parent::interval_memoizer_base(output_len),
+      : parent::static_interval_memoizer_base(output_len),
         level_endpoints{initialize_endpoints(output_len)},
         buf{alloc.allocate_unique_ptr(level_endpoints[depth] + output_len)}
     {
@@ -243,25 +315,11 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
 
     HEDLEY_ALWAYS_INLINE
     HEDLEY_NO_THROW
-    return_type operator[](std::size_t level) const noexcept override
+    return_type operator[](std::size_t level) const noexcept
     {
         return Allocator::assume_aligned(&buf[level_endpoints[level]]);
     }
 
-    HEDLEY_ALWAYS_INLINE
-    HEDLEY_NO_THROW
-    return_type begin() const noexcept override
-    {
-        return this->operator[](level_index - 1);
-    }
-
-    HEDLEY_ALWAYS_INLINE
-    HEDLEY_NO_THROW
-    return_type end() const noexcept override
-    {
-        return this->operator[](level_index - 1) + get_nodes_at_level(level_index - 1);
-    }
-
   private:
     const std::array<std::size_t, depth+1> level_endpoints;
     unique_ptr buf;
@@ -297,6 +355,93 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
     }
 };
 
+/// @brief adapts a concrete interval memoizer to the virtual
+///        `dpf::interval_memoizer_base` interface
+template <typename IntervalMemoizer>
+struct type_erased_interval_memoizer final
+  : public interval_memoizer_base<typename IntervalMemoizer::dpf_type>
+{
+  private:
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    using parent = interval_memoizer_base<typename IntervalMemoizer::dpf_type>;
+HEDLEY_PRAGMA(GCC diagnostic pop)
+  public:
+    using typename parent::dpf_type;
+    using typename parent::integral_type;
+    using typename parent::return_type;
+    using typename parent::node_type;
+
+    explicit type_erased_interval_memoizer(IntervalMemoizer memoizer)
+      : memoizer_{std::move(memoizer)} { }
+
+    return_type operator[](std::size_t level) const noexcept override
+    {
+        return memoizer_[level];
+    }
+
+    return_type begin() const noexcept override
+    {
+        return memoizer_.begin();
+    }
+
+    return_type end() const noexcept override
+    {
+        return memoizer_.end();
+    }
+
+    std::size_t assign_interval(const dpf_type & dpf, integral_type new_from, integral_type new_to) override
+    {
+        return memoizer_.assign_interval(dpf, new_from, new_to);
+    }
+
+    std::size_t assign_subtree(const dpf_type & dpf, std::size_t level,
+        const node_type & node, integral_type new_from, integral_type new_to) override
+    {
+        return memoizer_.assign_subtree(dpf, level, node, new_from, new_to);
+    }
+
+    std::size_t advance_level() override
+    {
+        return memoizer_.advance_level();
+    }
+
+    std::size_t get_nodes_at_level() const override
+    {
+        return memoizer_.get_nodes_at_level();
+    }
+
+    std::size_t get_nodes_at_level(std::size_t level) const override
+    {
+        return memoizer_.get_nodes_at_level(level);
+    }
+
+    /// @brief the wrapped memoizer
+    IntervalMemoizer & get() noexcept { return memoizer_; }
+
+  private:
+    IntervalMemoizer memoizer_;
+};
+
+/// @brief places `memoizer` behind the virtual `dpf::interval_memoizer_base`
+///        interface
+/// @details `memoizer` is moved into the adapter, so it must be passed as
+///          an rvalue: the interval memoizers own their buffers and are
+///          move-only.
+template <typename IntervalMemoizer>
+auto make_type_erased_interval_memoizer(IntervalMemoizer && memoizer)
+{
+    using memoizer_type = std::decay_t<IntervalMemoizer>;
+    using dpf_type = typename memoizer_type::dpf_type;
+    static_assert(std::is_rvalue_reference_v<IntervalMemoizer &&>
+        || std::is_copy_constructible_v<memoizer_type>,
+        "interval memoizers are move-only; pass std::move(memoizer)");
+
+    return std::unique_ptr<interval_memoizer_base<dpf_type>>(
+        std::make_unique<type_erased_interval_memoizer<memoizer_type>>(
+            std::forward<IntervalMemoizer>(memoizer)));
+}
+
 namespace detail
 {
 
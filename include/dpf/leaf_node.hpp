@@ -20,6 +20,7 @@
 #include <tuple>
 #include <atomic>
 #include <array>
+#include <vector>
 
 #include "simde/simde/x86/avx2.h"
 
@@ -232,29 +233,90 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
 }
 
 template <typename ExteriorPRG,
-          std::size_t I,
           typename OutputsTuple,
+          typename InteriorBlock,
+          std::size_t ...Is>
+auto make_leaf_masks_impl(const InteriorBlock & seed, std::index_sequence<Is...>)
+{
+    return std::make_tuple(make_leaf_mask_inner<ExteriorPRG, Is, OutputsTuple>(seed)...);
+}
+
+/// @brief the `ExteriorPRG` expansion of `seed` into one leaf per output
+template <typename ExteriorPRG,
+          typename ...OutputTs,
           typename InteriorBlock>
-auto make_leaf_mask(const InteriorBlock & seed0, const InteriorBlock & seed1)
+auto make_leaf_masks(const InteriorBlock & seed)
 {
-HEDLEY_PRAGMA(GCC diagnostic push)
-HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
-    using output_type = concrete_type_t<std::tuple_element_t<I, OutputsTuple>>;
+    return make_leaf_masks_impl<ExteriorPRG, std::tuple<OutputTs...>>(seed,
+        std::index_sequence_for<OutputTs...>{});
+}
+
+template <typename ExteriorPRG,
+          std::size_t I,
+          typename OutputsTuple,
+          typename LeafTuple>
+void make_leaf_mask_column(const typename ExteriorPRG::block_type * seeds,
+    typename ExteriorPRG::block_type * blocks, std::size_t count,
+    LeafTuple * masks)
+{
+    using node_type = typename ExteriorPRG::block_type;
+    using output_type = std::tuple_element_t<I, OutputsTuple>;
 
-    auto mask0 = make_leaf_mask_inner<ExteriorPRG, I, OutputsTuple>(seed0);
-    auto mask1 = make_leaf_mask_inner<ExteriorPRG, I, OutputsTuple>(seed1);
+    constexpr auto block_len = dpf::block_length_of_leaf_v<output_type, node_type>;
+    constexpr auto pos = dpf::block_offset_of_leaf_v<I, node_type, OutputsTuple>;
+    for (std::size_t b = 0; b < block_len; ++b)
+    {
+        ExteriorPRG::eval_many(seeds, pos + b, blocks, count);
+        for (std::size_t j = 0; j < count; ++j)
+        {
+            reinterpret_cast<node_type *>(&std::get<I>(masks[j]))[b] = blocks[j];
+        }
+    }
+}
 
-    return dpf::subtract_leaf<output_type>(mask1, mask0);
-HEDLEY_PRAGMA(GCC diagnostic pop)
+template <typename ExteriorPRG,
+          typename OutputsTuple,
+          typename LeafTuple,
+          std::size_t ...Is>
+void make_leaf_masks_many_impl(const typename ExteriorPRG::block_type * seeds,
+    typename ExteriorPRG::block_type * blocks, std::size_t count,
+    LeafTuple * masks, std::index_sequence<Is...>)
+{
+    (make_leaf_mask_column<ExteriorPRG, Is, OutputsTuple>(seeds, blocks, count, masks), ...);
 }
 
+/// @brief sets `masks[j] = make_leaf_masks<ExteriorPRG, OutputTs...>(seeds[j])`
+///        for each `j < count`
+/// @details Issues one `ExteriorPRG::eval_many` over all of `seeds` per leaf
+///          block, rather than a separate bulk `eval` per seed and output.
 template <typename ExteriorPRG,
+          typename ...OutputTs,
+          typename InteriorBlock,
+          typename LeafTuple>
+void make_leaf_masks_many(const InteriorBlock * seeds, std::size_t count,
+    LeafTuple * masks)
+{
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    using node_type = typename ExteriorPRG::block_type;
+    std::vector<node_type> exterior_seeds(count), blocks(count);
+HEDLEY_PRAGMA(GCC diagnostic pop)
+    for (std::size_t j = 0; j < count; ++j)
+    {
+        exterior_seeds[j] = utils::to_exterior_node<node_type>(seeds[j]);
+    }
+    make_leaf_masks_many_impl<ExteriorPRG, std::tuple<OutputTs...>>(
+        exterior_seeds.data(), blocks.data(), count, masks,
+        std::index_sequence_for<OutputTs...>{});
+}
+
+template <typename NodeT,
           std::size_t I,
           typename InputT,
-          typename ExteriorBlock,
+          typename LeafTuple,
           typename ...OutputTs>
-auto make_leaf(InputT x, const ExteriorBlock & seed0, const ExteriorBlock & seed1, bool sign,
-    OutputTs ...ys)
+auto make_leaf(InputT x, const LeafTuple & masks0, const LeafTuple & masks1,
+    bool sign, OutputTs ...ys)
 {
     using output_tuple_type = std::tuple<OutputTs...>;
     output_tuple_type output_tuple = std::make_tuple(ys...);
@@ -263,45 +325,48 @@ auto make_leaf(InputT x, const ExteriorBlock & seed0, const ExteriorBlock & seed
 
 HEDLEY_PRAGMA(GCC diagnostic push)
 HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
-    using node_type = typename ExteriorPRG::block_type;
+    auto mask = dpf::subtract_leaf<concrete_type_t<output_type>>(
+        std::get<I>(masks1), std::get<I>(masks0));
 
     return sign ? dpf::subtract_leaf<output_type>(
-                    make_naked_leaf<node_type>(x, Y),
-                    make_leaf_mask<ExteriorPRG, I, output_tuple_type>(seed0, seed1))
+                    make_naked_leaf<NodeT>(x, Y), mask)
                 : dpf::subtract_leaf<output_type>(
-                    make_leaf_mask<ExteriorPRG, I, output_tuple_type>(seed0, seed1),
-                    make_naked_leaf<node_type>(x, Y));
+                    mask, make_naked_leaf<NodeT>(x, Y));
 HEDLEY_PRAGMA(GCC diagnostic pop)
 }
 
-template <typename ExteriorPRG,
+template <typename NodeT,
           typename InputT,
-          typename ExteriorBlock,
+          typename LeafTuple,
           typename ...OutputTs,
           std::size_t ...Is>
-auto make_leaves_impl(InputT x, const ExteriorBlock & seed0, const ExteriorBlock & seed1,
+auto make_leaves_impl(InputT x, const LeafTuple & masks0, const LeafTuple & masks1,
     bool sign, std::index_sequence<Is...>, OutputTs ...ys)
 {
-    return std::make_tuple(make_leaf<ExteriorPRG, Is>(x, seed0, seed1, sign, ys...)...);
+    return std::make_tuple(make_leaf<NodeT, Is>(x, masks0, masks1, sign, ys...)...);
 }
 
-template <typename ExteriorPRG,
+/// @brief builds the leaves (and beavers) of both keys from the
+///        `make_leaf_masks` of their final seeds
+/// @details `make_dpfs` computes the masks of many keys at once (via
+///          `make_leaf_masks_many`) and then calls this for each key.
+template <typename NodeT,
           typename InputT,
-          typename ExteriorBlock,
+          typename LeafTuple,
           typename OutputT,
           typename ...OutputTs,
           typename Indices = std::make_index_sequence<1+sizeof...(OutputTs)>>
-auto make_leaves(InputT x, const ExteriorBlock & seed0, const ExteriorBlock & seed1,
-    bool sign, OutputT y, OutputTs ...ys)
+auto make_leaves_from_masks(InputT x, const LeafTuple & masks0,
+    const LeafTuple & masks1, bool sign, OutputT y, OutputTs ...ys)
 {
 HEDLEY_PRAGMA(GCC diagnostic push)
 HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
-    using node_type = typename ExteriorPRG::block_type;
+    using node_type = NodeT;
     using leaf_type = dpf::leaf_tuple_t<node_type, OutputT, OutputTs...>;
     using beaver_type = dpf::beaver_tuple_t<node_type, OutputT, OutputTs...>;
 HEDLEY_PRAGMA(GCC diagnostic pop)
 
-    leaf_type leaves = make_leaves_impl<ExteriorPRG>(x, seed0, seed1, sign, Indices{}, y, ys...);
+    leaf_type leaves = make_leaves_impl<node_type>(x, masks0, masks1, sign, Indices{}, y, ys...);
 
     // post-processing to secret-share any wildcard leaves
     // that is, after the call to `make_leaves_impl`, any values that were
@@ -397,6 +462,21 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
     return return_tuple;
 }
 
+template <typename ExteriorPRG,
+          typename InputT,
+          typename ExteriorBlock,
+          typename OutputT,
+          typename ...OutputTs>
+auto make_leaves(InputT x, const ExteriorBlock & seed0, const ExteriorBlock & seed1,
+    bool sign, OutputT y, OutputTs ...ys)
+{
+    using node_type = typename ExteriorPRG::block_type;
+    return make_leaves_from_masks<node_type>(x,
+        make_leaf_masks<ExteriorPRG, OutputT, OutputTs...>(seed0),
+        make_leaf_masks<ExteriorPRG, OutputT, OutputTs...>(seed1),
+        sign, y, ys...);
+}
+
 }  // namespace dpf
 
 #endif  // LIBDPF_INCLUDE_DPF_LEAF_NODE_HPP__
@@ -0,0 +1,121 @@
+/// @file dpf/mapped_database.hpp
+/// @brief read-only, memory-mapped array of fixed-size records
+/// @details Lets a database file be passed directly to
+///          `dpf::eval_full_dot` (or anything else expecting a contiguous
+///          range) without first reading it into memory; pages are faulted
+///          in on demand as the evaluation streams over them. POSIX only.
+/// @author Ryan Henry <ryan.henry@ucalgary.ca>
+/// @copyright Copyright (c) 2019-2024 Ryan Henry and [others](@ref authors)
+/// @license Released under a GNU General Public v2.0 (GPLv2) license;
+///          see [LICENSE.md](@ref license) for details.
+
+#ifndef LIBDPF_INCLUDE_DPF_MAPPED_DATABASE_HPP__
+#define LIBDPF_INCLUDE_DPF_MAPPED_DATABASE_HPP__
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace dpf
+{
+
+/// @brief a file of `Record`s, mapped read-only into memory
+/// @details Any trailing bytes that do not form a whole record are ignored.
+template <typename Record>
+class mapped_database final
+{
+  public:
+    static_assert(std::is_trivially_copyable_v<Record>,
+        "records must be trivially copyable");
+
+    using value_type = Record;
+    using size_type = std::size_t;
+    using const_iterator = const Record *;
+
+    explicit mapped_database(const std::string & path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), path);
+        }
+        bytes_ = static_cast<std::size_t>(st.st_size);
+        size_ = bytes_ / sizeof(Record);
+        if (bytes_ != 0)
+        {
+            void * addr = ::mmap(nullptr, bytes_, PROT_READ, MAP_SHARED, fd, 0);
+            if (addr == MAP_FAILED)
+            {
+                int err = errno;
+                ::close(fd);
+                throw std::system_error(err, std::generic_category(), path);
+            }
+            // evaluation streams over the records exactly once, in order
+            ::madvise(addr, bytes_, MADV_SEQUENTIAL);
+            data_ = static_cast<const Record *>(addr);
+        }
+        ::close(fd);  // the mapping keeps the file alive
+    }
+
+    mapped_database(mapped_database && other) noexcept
+      : data_{std::exchange(other.data_, nullptr)},
+        size_{std::exchange(other.size_, 0)},
+        bytes_{std::exchange(other.bytes_, 0)}
+    { }
+
+    mapped_database & operator=(mapped_database && other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            bytes_ = std::exchange(other.bytes_, 0);
+        }
+        return *this;
+    }
+
+    mapped_database(const mapped_database &) = delete;
+    mapped_database & operator=(const mapped_database &) = delete;
+
+    ~mapped_database() { unmap(); }
+
+    const Record * data() const noexcept { return data_; }
+    size_type size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    const Record & operator[](size_type i) const noexcept { return data_[i]; }
+    const_iterator begin() const noexcept { return data_; }
+    const_iterator end() const noexcept { return data_ + size_; }
+
+  private:
+    void unmap() noexcept
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(const_cast<Record *>(data_), bytes_);
+        }
+    }
+
+    const Record * data_ = nullptr;
+    size_type size_ = 0;
+    std::size_t bytes_ = 0;
+};
+
+}  // namespace dpf
+
+#endif  // LIBDPF_INCLUDE_DPF_MAPPED_DATABASE_HPP__
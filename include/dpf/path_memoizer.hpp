@@ -11,16 +11,27 @@
 #define LIBDPF_INCLUDE_DPF_PATH_MEMOIZER_HPP__
 
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <algorithm>
 #include <type_traits>
 #include <functional>
 #include <memory>
 #include <array>
 #include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace dpf
 {
 
+/// @brief type-erased interface to a path memoizer
+/// @details `dpf::eval_point` and friends are templated on the memoizer type
+///          and call the concrete memoizers below directly, so that
+///          `operator[]` inlines into the per-level loop. This interface
+///          exists only for callers that need to choose a memoizer at
+///          runtime; see `dpf::type_erased_path_memoizer`.
 template <typename DpfKey,
           typename ReturnT = const typename DpfKey::interior_node *>
 struct path_memoizer_base
@@ -32,6 +43,8 @@ struct path_memoizer_base
     using return_type = ReturnT;
     using iterator_type = return_type;
 
+    virtual ~path_memoizer_base() = default;
+
     virtual std::size_t assign_x(const dpf_type &, input_type) noexcept = 0;
     virtual node_type & operator[](std::size_t) noexcept = 0;
 
@@ -42,7 +55,6 @@ struct path_memoizer_base
 template <typename DpfKey>
 struct alignas(alignof(typename DpfKey::interior_node))
 basic_path_memoizer final
-    : public path_memoizer_base<DpfKey>
 {
   public:
     using dpf_type = DpfKey;
@@ -63,11 +75,11 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
     basic_path_memoizer & operator=(const basic_path_memoizer &) = default;
     ~basic_path_memoizer() = default;
 
-    std::size_t assign_x(const dpf_type & dpf, input_type new_x) noexcept override
+    std::size_t assign_x(const dpf_type & dpf, input_type new_x) noexcept
     {
         static constexpr auto clz_xor = utils::countl_zero_symmetric_difference<input_type>{};
         if (dpf_.has_value() == true && std::memcmp(&dpf_root_, &dpf.root(), sizeof(node_type)) == 0
-            && std::memcmp(&dpf_common_part_hash_, &dpf.common_part_hash(), sizeof(digest_type)) == 0)
+            && std::memcmp(&dpf_interior_hash_, &dpf.interior_hash(), sizeof(digest_type)) == 0)
         {
             static constexpr auto complement_of = std::bit_not{};
             input_type old_x = x_.value_or(complement_of(new_x));
@@ -78,17 +90,19 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
         this->operator[](0) = dpf.root();
         dpf_ = std::cref(dpf);
         dpf_root_ = dpf.root();
-        dpf_common_part_hash_ = dpf.common_part_hash();
+        dpf_interior_hash_ = dpf.interior_hash();
         x_ = new_x;
         return 1;
     }
 
-    node_type & operator[](std::size_t i) noexcept override
+    HEDLEY_NO_THROW
+    HEDLEY_ALWAYS_INLINE
+    node_type & operator[](std::size_t i) noexcept
     {
         return arr_[i];
     }
 
-    return_type begin() const noexcept override
+    return_type begin() const noexcept
     {
         if (x_.has_value() == true)
         {
@@ -100,7 +114,7 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
         }
     }
 
-    return_type end() const noexcept override
+    return_type end() const noexcept
     {
         return std::addressof(arr_[depth+1]);
     }
@@ -108,7 +122,7 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
   private:
     std::optional<std::reference_wrapper<const dpf_type>> dpf_;
     node_type dpf_root_;
-    digest_type dpf_common_part_hash_;
+    digest_type dpf_interior_hash_;
     std::optional<input_type> x_;
 HEDLEY_PRAGMA(GCC diagnostic push)
 HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
@@ -117,7 +131,7 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
 };
 
 template <typename DpfKey>
-struct nonmemoizing_path_memoizer final : public path_memoizer_base<DpfKey>
+struct nonmemoizing_path_memoizer final
 {
   public:
     using dpf_type = DpfKey;
@@ -140,7 +154,7 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
     HEDLEY_NO_THROW
     HEDLEY_ALWAYS_INLINE
     HEDLEY_CONST
-    std::size_t assign_x(const dpf_type & dpf, input_type) noexcept override
+    std::size_t assign_x(const dpf_type & dpf, input_type) noexcept
     {
         dpf_ = dpf;
         v = dpf.root();
@@ -149,17 +163,17 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
 
     HEDLEY_NO_THROW
     HEDLEY_ALWAYS_INLINE
-    node_type & operator[](std::size_t) noexcept override
+    node_type & operator[](std::size_t) noexcept
     {
         return v;
     }
 
-    return_type begin() const noexcept override
+    return_type begin() const noexcept
     {
         return std::addressof(v);
     }
 
-    return_type end() const noexcept override
+    return_type end() const noexcept
     {
         return reinterpret_cast<return_type>(std::addressof(v)) + 1;
     }
@@ -169,6 +183,347 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
     node_type v;
 };
 
+/// @brief path memoizer that starts every query at a precomputed level
+/// @details On the first query against a key, all `2^level` nodes on
+///          `level` of its tree are computed at once; thereafter every
+///          query picks its ancestor on `level` out of that table and only
+///          walks the `depth - level` levels below it. Queries that share a
+///          longer prefix with the previous query reuse the path below
+///          `level` too, as in `dpf::basic_path_memoizer`. This trades
+///          `2^level` interior nodes of memory per key (1 MiB at
+///          `level == 16` for 128-bit nodes) for `level` fewer PRG calls
+///          per query; choose `level` so that the table stays in L2 or L3.
+template <typename DpfKey>
+struct frontier_path_memoizer final
+{
+  public:
+    using dpf_type = DpfKey;
+    using input_type = typename DpfKey::input_type;
+    using node_type = typename DpfKey::interior_node;
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    using return_type = std::add_pointer_t<std::add_const_t<node_type>>;
+HEDLEY_PRAGMA(GCC diagnostic pop)
+    using iterator_type = return_type;
+    static constexpr auto depth = DpfKey::depth;
+
+    /// @throws std::invalid_argument if `level` exceeds `depth`
+    /// @throws std::length_error if `2^level` does not fit in a `std::size_t`
+    explicit frontier_path_memoizer(std::size_t level)
+      : dpf_{std::nullopt},
+        x_{std::nullopt},
+        level_{checked_level(level)},
+        frontier_(std::size_t(1) << level_)
+    { }
+    frontier_path_memoizer(frontier_path_memoizer &&) noexcept = default;
+    frontier_path_memoizer(const frontier_path_memoizer &) = default;
+    frontier_path_memoizer & operator=(frontier_path_memoizer &&) noexcept = default;
+    frontier_path_memoizer & operator=(const frontier_path_memoizer &) = default;
+    ~frontier_path_memoizer() = default;
+
+    std::size_t assign_x(const dpf_type & dpf, input_type new_x) noexcept
+    {
+        static constexpr auto clz_xor = utils::countl_zero_symmetric_difference<input_type>{};
+        if (dpf_.has_value() == true && std::memcmp(&dpf_root_, &dpf.root(), sizeof(node_type)) == 0
+            && std::memcmp(&dpf_interior_hash_, &dpf.interior_hash(), sizeof(digest_type)) == 0)
+        {
+            static constexpr auto complement_of = std::bit_not{};
+            input_type old_x = x_.value_or(complement_of(new_x));
+            std::size_t shared = clz_xor(old_x, new_x);
+            x_ = new_x;
+            if (shared >= level_) return shared+1;
+        }
+        else
+        {
+            assign_dpf(dpf);
+            x_ = new_x;
+        }
+
+        // the first `level_` bits of `new_x` index the frontier
+        std::size_t index = 0;
+        auto mask = dpf_type::msb_mask;
+        for (std::size_t i = 0; i < level_; ++i, mask >>= 1)
+        {
+            index = (index << 1) | !!(mask & new_x);
+        }
+        arr_[level_] = frontier_[index];
+        return level_+1;
+    }
+
+    HEDLEY_NO_THROW
+    HEDLEY_ALWAYS_INLINE
+    node_type & operator[](std::size_t i) noexcept
+    {
+        return arr_[i];
+    }
+
+    return_type begin() const noexcept
+    {
+        if (x_.has_value() == true)
+        {
+            return std::addressof(arr_[depth]);
+        }
+        else
+        {
+            return end();
+        }
+    }
+
+    return_type end() const noexcept
+    {
+        return std::addressof(arr_[depth+1]);
+    }
+
+    /// @brief the level at which queries start
+    std::size_t level() const noexcept { return level_; }
+
+  private:
+    static constexpr std::size_t frontier_batch = 32;
+
+    static std::size_t checked_level(std::size_t level)
+    {
+        if (HEDLEY_UNLIKELY(level > depth))
+        {
+            throw std::invalid_argument("level exceeds the depth of the dpf");
+        }
+        if (HEDLEY_UNLIKELY(level >= utils::bitlength_of_v<std::size_t>))
+        {
+            throw std::length_error("frontier is too large");
+        }
+        return level;
+    }
+
+    /// @brief recomputes the frontier for `dpf`
+    void assign_dpf(const dpf_type & dpf) noexcept
+    {
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+        node_type parents[frontier_batch];
+HEDLEY_PRAGMA(GCC diagnostic pop)
+
+        // expand in place, back to front, so that the children of a batch
+        // only ever overwrite parents that have already been expanded
+        frontier_[0] = dpf.root();
+        for (std::size_t level_index = 1; level_index <= level_; ++level_index)
+        {
+            const node_type cw[2] = {
+                dpf.correction_word(level_index-1, 0),
+                dpf.correction_word(level_index-1, 1)
+            };
+            for (std::size_t end = std::size_t(1) << (level_index-1); end > 0;)
+            {
+                std::size_t count = std::min(end, frontier_batch),
+                    begin = end - count;
+                std::copy_n(&frontier_[begin], count, parents);
+                dpf_type::traverse_interior(parents, cw, &frontier_[2*begin], count);
+                end = begin;
+            }
+        }
+
+        arr_[0] = dpf.root();
+        dpf_ = std::cref(dpf);
+        dpf_root_ = dpf.root();
+        dpf_interior_hash_ = dpf.interior_hash();
+    }
+
+    std::optional<std::reference_wrapper<const dpf_type>> dpf_;
+    node_type dpf_root_;
+    digest_type dpf_interior_hash_;
+    std::optional<input_type> x_;
+    std::size_t level_;
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    std::vector<node_type> frontier_;
+    std::array<node_type, depth+1> arr_;
+HEDLEY_PRAGMA(GCC diagnostic pop)
+};
+
+/// @brief path memoizer that remembers several recently used paths
+/// @details Keeps up to `ways` root-to-leaf paths, each tagged with the
+///          input that produced it. `assign_x` resumes from whichever cached
+///          path shares the longest prefix with the new input; if that path
+///          is not the least recently used one, its shared prefix is copied
+///          over the least recently used path, which then becomes the
+///          current path. Queries that alternate between a few hot regions
+///          thus keep their deep prefixes instead of evicting each other as
+///          they would in `dpf::basic_path_memoizer`. Copying a prefix costs
+///          at most `depth` node copies, far less than one PRG call.
+template <typename DpfKey>
+struct lru_path_memoizer final
+{
+  public:
+    using dpf_type = DpfKey;
+    using input_type = typename DpfKey::input_type;
+    using node_type = typename DpfKey::interior_node;
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    using return_type = std::add_pointer_t<std::add_const_t<node_type>>;
+HEDLEY_PRAGMA(GCC diagnostic pop)
+    using iterator_type = return_type;
+    static constexpr auto depth = DpfKey::depth;
+    static constexpr std::size_t default_ways = 64;
+
+    /// @throws std::invalid_argument if `ways` is `0`
+    explicit lru_path_memoizer(std::size_t ways = default_ways)
+      : dpf_{std::nullopt},
+        xs_(ways > 0 ? ways : throw std::invalid_argument("ways must be positive")),
+        stamps_(ways, 0),
+        paths_(ways * (depth+1))
+    { }
+    lru_path_memoizer(lru_path_memoizer &&) noexcept = default;
+    lru_path_memoizer(const lru_path_memoizer &) = default;
+    lru_path_memoizer & operator=(lru_path_memoizer &&) noexcept = default;
+    lru_path_memoizer & operator=(const lru_path_memoizer &) = default;
+    ~lru_path_memoizer() = default;
+
+    std::size_t assign_x(const dpf_type & dpf, input_type new_x) noexcept
+    {
+        static constexpr auto clz_xor = utils::countl_zero_symmetric_difference<input_type>{};
+        if (dpf_.has_value() == false || std::memcmp(&dpf_root_, &dpf.root(), sizeof(node_type)) != 0
+            || std::memcmp(&dpf_interior_hash_, &dpf.interior_hash(), sizeof(digest_type)) != 0)
+        {
+            std::fill(std::begin(stamps_), std::end(stamps_), 0);
+            dpf_ = std::cref(dpf);
+            dpf_root_ = dpf.root();
+            dpf_interior_hash_ = dpf.interior_hash();
+            current_ = 0;
+            paths_[0] = dpf.root();
+            xs_[0] = new_x;
+            stamps_[0] = ++clock_;
+            return 1;
+        }
+
+        // a stamp of 0 marks a path that is not in use
+        std::size_t best = 0, victim = 0, shared = 0;
+        bool found = false;
+        for (std::size_t i = 0; i < std::size(stamps_); ++i)
+        {
+            if (stamps_[i] < stamps_[victim]) victim = i;
+            if (stamps_[i] == 0) continue;
+            std::size_t len = clz_xor(xs_[i], new_x);
+            if (found == false || len > shared)
+            {
+                best = i;
+                shared = len;
+                found = true;
+            }
+        }
+
+        // the path to the same leaf node is still complete
+        if (shared >= depth) victim = best;
+        if (victim != best)
+        {
+            std::copy_n(&paths_[best * (depth+1)], std::min(shared, depth) + 1,
+                &paths_[victim * (depth+1)]);
+        }
+        current_ = victim;
+        xs_[victim] = new_x;
+        stamps_[victim] = ++clock_;
+        return shared+1;
+    }
+
+    HEDLEY_NO_THROW
+    HEDLEY_ALWAYS_INLINE
+    node_type & operator[](std::size_t i) noexcept
+    {
+        return paths_[current_ * (depth+1) + i];
+    }
+
+    return_type begin() const noexcept
+    {
+        if (dpf_.has_value() == true)
+        {
+            return std::addressof(paths_[current_ * (depth+1) + depth]);
+        }
+        else
+        {
+            return end();
+        }
+    }
+
+    return_type end() const noexcept
+    {
+        return std::addressof(paths_[current_ * (depth+1) + depth]) + 1;
+    }
+
+    /// @brief the maximum number of paths remembered
+    std::size_t ways() const noexcept { return std::size(stamps_); }
+
+  private:
+    std::optional<std::reference_wrapper<const dpf_type>> dpf_;
+    node_type dpf_root_;
+    digest_type dpf_interior_hash_;
+    std::vector<input_type> xs_;
+    std::vector<std::uint64_t> stamps_;
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+    std::vector<node_type> paths_;
+HEDLEY_PRAGMA(GCC diagnostic pop)
+    std::uint64_t clock_ = 0;
+    std::size_t current_ = 0;
+};
+
+/// @brief adapts a concrete path memoizer to the virtual
+///        `dpf::path_memoizer_base` interface
+template <typename PathMemoizer>
+struct type_erased_path_memoizer final
+  : public path_memoizer_base<typename PathMemoizer::dpf_type>
+{
+  private:
+    using parent = path_memoizer_base<typename PathMemoizer::dpf_type>;
+  public:
+    using typename parent::dpf_type;
+    using typename parent::input_type;
+    using typename parent::node_type;
+    using typename parent::return_type;
+
+    type_erased_path_memoizer() = default;
+
+    explicit type_erased_path_memoizer(PathMemoizer memoizer)
+      : memoizer_{std::move(memoizer)} { }
+
+    std::size_t assign_x(const dpf_type & dpf, input_type x) noexcept override
+    {
+        return memoizer_.assign_x(dpf, x);
+    }
+
+    node_type & operator[](std::size_t i) noexcept override
+    {
+        return memoizer_[i];
+    }
+
+    return_type begin() const noexcept override
+    {
+        return memoizer_.begin();
+    }
+
+    return_type end() const noexcept override
+    {
+        return memoizer_.end();
+    }
+
+    /// @brief the wrapped memoizer
+    PathMemoizer & get() noexcept { return memoizer_; }
+
+  private:
+    PathMemoizer memoizer_;
+};
+
+/// @brief places `memoizer` behind the virtual `dpf::path_memoizer_base`
+///        interface
+/// @details Forwards `memoizer`, so rvalues are moved into the adapter and
+///          lvalues are copied, leaving the caller's memoizer usable.
+template <typename PathMemoizer>
+auto make_type_erased_path_memoizer(PathMemoizer && memoizer)
+{
+    using memoizer_type = std::decay_t<PathMemoizer>;
+    using dpf_type = typename memoizer_type::dpf_type;
+
+    return std::unique_ptr<path_memoizer_base<dpf_type>>(
+        std::make_unique<type_erased_path_memoizer<memoizer_type>>(
+            std::forward<PathMemoizer>(memoizer)));
+}
+
 namespace detail
 {
 
@@ -205,6 +560,31 @@ auto make_nonmemoizing_path_memoizer(const DpfKey &)
     return make_nonmemoizing_path_memoizer<DpfKey>();
 }
 
+template <typename DpfKey>
+auto make_frontier_path_memoizer(std::size_t level)
+{
+    return frontier_path_memoizer<DpfKey>(level);
+}
+
+template <typename DpfKey>
+auto make_frontier_path_memoizer(const DpfKey &, std::size_t level)
+{
+    return make_frontier_path_memoizer<DpfKey>(level);
+}
+
+template <typename DpfKey>
+auto make_lru_path_memoizer(std::size_t ways = lru_path_memoizer<DpfKey>::default_ways)
+{
+    return lru_path_memoizer<DpfKey>(ways);
+}
+
+template <typename DpfKey>
+auto make_lru_path_memoizer(const DpfKey &,
+    std::size_t ways = lru_path_memoizer<DpfKey>::default_ways)
+{
+    return make_lru_path_memoizer<DpfKey>(ways);
+}
+
 }  // namespace dpf
 
 #endif  // LIBDPF_INCLUDE_DPF_PATH_MEMOIZER_HPP__
@@ -12,6 +12,8 @@
 #include <atomic>
 
 #include "dpf/prg_aes.hpp"
+#include "dpf/prg_aes_bitsliced.hpp"
+#include "dpf/prg_chacha.hpp"
 #include "dpf/prg_dummy.hpp"
 
 namespace dpf
@@ -44,6 +46,14 @@ struct counter_wrapper final
         prg_.eval(seed, output, count, pos);
     }
 
+    static void eval_many(const block_type * HEDLEY_RESTRICT seeds,
+        psnip_uint32_t pos, block_type * HEDLEY_RESTRICT output,
+        std::size_t count)
+    {
+        count_.fetch_add(count, std::memory_order::memory_order_relaxed);
+        prg_.eval_many(seeds, pos, output, count);
+    }
+
     static std::size_t count()
     {
         return count_;
@@ -17,6 +17,8 @@
 #include "portable-snippets/exact-int/exact-int.h"
 
 #include "dpf/utils.hpp"
+#include "dpf/prg_aes_bitsliced.hpp"
+#include "dpf/prg_vaes.hpp"
 
 namespace dpf
 {
@@ -29,7 +31,6 @@ namespace prg
 #else
 #define simde_mm_aesenc_si128(a, RoundKey) _mm_aesenc_si128(a, RoundKey);
 #define simde_mm_aesenclast_si128(a, RoundKey) _mm_aesenclast_si128(a, RoundKey);
-#define simde_mm_aeskeygenassist_si128(a, inn8) _mm_aeskeygenassist_si128(a, inn8);
 #endif
 
 template <typename AesKey>
@@ -86,6 +87,24 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
     static void eval(block_type seed, block_type * HEDLEY_RESTRICT output,
         psnip_uint32_t count, psnip_uint32_t pos = 0) noexcept
     {
+#ifdef LIBDPF_HAVE_VAES
+        if (count >= 4)
+        {
+            switch (get_aes_backend())
+            {
+                case aes_backend::vaes512:
+                    detail::vaes512_eval_ctr<AesKey::rounds>(key.rd_key.data(),
+                        seed, output, count, pos);
+                    return;
+                case aes_backend::vaes256:
+                    detail::vaes256_eval_ctr<AesKey::rounds>(key.rd_key.data(),
+                        seed, output, count, pos);
+                    return;
+                default:
+                    break;
+            }
+        }
+#endif
         static constexpr block_type one{1, 0};
         auto pos_ = simde_mm_set_epi64x(0, pos);
         block_type * HEDLEY_RESTRICT out =
@@ -107,22 +126,103 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
         }
     }
 
+    HEDLEY_NO_THROW
+    static void eval_many(const block_type * HEDLEY_RESTRICT seeds,
+        psnip_uint32_t pos,
+        block_type * HEDLEY_RESTRICT output, std::size_t count) noexcept
+    {
+#ifdef LIBDPF_HAVE_VAES
+        switch (get_aes_backend())
+        {
+            case aes_backend::vaes512:
+                detail::vaes512_eval_many<AesKey::rounds>(key.rd_key.data(),
+                    seeds, pos, output, count);
+                return;
+            case aes_backend::vaes256:
+                detail::vaes256_eval_many<AesKey::rounds>(key.rd_key.data(),
+                    seeds, pos, output, count);
+                return;
+            default:
+                break;
+        }
+#endif
+        block_type rd_key0 = simde_mm_xor_si128(key.rd_key[0],
+            simde_mm_set_epi64x(0, pos));
+
+        std::size_t i = 0;
+        // interleave `lanes` independent blocks per round so that the
+        // AES unit's pipeline stays full instead of waiting on each
+        // block's dependency chain
+        for (; i + lanes <= count; i += lanes)
+        {
+            block_type out[lanes];
+            DPF_UNROLL_LOOP
+            for (std::size_t k = 0; k < lanes; ++k)
+            {
+                out[k] = simde_mm_xor_si128(seeds[i+k], rd_key0);
+            }
+            DPF_UNROLL_LOOP
+            for (std::size_t j = 1; j < key.rounds; ++j)
+            {
+                DPF_UNROLL_LOOP
+                for (std::size_t k = 0; k < lanes; ++k)
+                {
+                    out[k] = simde_mm_aesenc_si128(out[k], key.rd_key[j]);
+                }
+            }
+            DPF_UNROLL_LOOP
+            for (std::size_t k = 0; k < lanes; ++k)
+            {
+                out[k] = simde_mm_aesenclast_si128(out[k],
+                    key.rd_key[key.rounds]);
+                output[i+k] = simde_mm_xor_si128(out[k], seeds[i+k]);
+            }
+        }
+        for (; i < count; ++i)
+        {
+            output[i] = eval(seeds[i], pos);
+        }
+    }
+
   private:
+    static constexpr std::size_t lanes = 8;
     static const AesKey key;
 };  // struct aes
 
-#define EXPAND_ASSIST(v1, v2, v3, v4, shuff_const, aes_const)  \
-  v2 = simde_mm_aeskeygenassist_si128(v4, aes_const);          \
-  v3 = simde_mm_castps_si128(_mm_shuffle_ps(                   \
-            simde_mm_castsi128_ps(v3),                         \
-            simde_mm_castsi128_ps(v1), 16));                   \
-  v1 = simde_mm_xor_si128(v1, v3);                             \
-  v3 = simde_mm_castps_si128(simde_mm_shuffle_ps(              \
-            simde_mm_castsi128_ps(v3),                         \
-            simde_mm_castsi128_ps(v1), 140));                  \
-  v1 = simde_mm_xor_si128(v1, v3);                             \
-  v2 = simde_mm_shuffle_epi32(v2, shuff_const);                \
-  v1 = simde_mm_xor_si128(v1, v2)
+namespace detail
+{
+
+template <typename RoundKeys, std::size_t KeyBits>
+RoundKeys load_round_keys(const bitsliced_key_schedule<KeyBits> & schedule) noexcept
+{
+    RoundKeys rd_key;
+    for (std::size_t r = 0; r < rd_key.size(); ++r)
+    {
+        rd_key[r] = simde_mm_loadu_si128(
+            reinterpret_cast<const simde__m128i *>(schedule.round_keys[r]));
+    }
+    return rd_key;
+}
+
+// loads the round keys of the all-zero key from the schedule that
+// `dpf::prg::aes_bitsliced` expands at compile time, so that initializing
+// `dpf::prg::aes128::key` (and `aes256::key`) does not itself need AES-NI
+template <std::size_t KeyBits, typename RoundKeys>
+RoundKeys zero_key_round_keys() noexcept
+{
+    static constexpr bitsliced_key_schedule<KeyBits> schedule{};
+    return load_round_keys<RoundKeys>(schedule);
+}
+
+// expands `key` in software at runtime (no `aeskeygenassist`)
+template <std::size_t KeyBits, typename RoundKeys>
+RoundKeys user_key_round_keys(const psnip_uint8_t * key) noexcept
+{
+    const bitsliced_key_schedule<KeyBits> schedule{key};
+    return load_round_keys<RoundKeys>(schedule);
+}
+
+}  // namespace detail
 
 struct aes128_key
 {
@@ -134,38 +234,18 @@ struct aes128_key
     HEDLEY_PRAGMA(GCC diagnostic pop)
     const rd_key_array rd_key;
 
+    aes128_key()
+      : rd_key{detail::zero_key_round_keys<128, rd_key_array>()} { }
+
     explicit aes128_key(const simde__m128i & userkey)
       : rd_key{compute_round_keys(userkey)} { }
 
   private:
-    rd_key_array compute_round_keys(const simde__m128i & userkey)
+    static rd_key_array compute_round_keys(const simde__m128i & userkey)
     {
-        rd_key_array rd_key;
-        simde__m128i x0, x1, x2;
-        rd_key[0] = x0 = userkey;
-        x2 = simde_mm_setzero_si128();
-        EXPAND_ASSIST(x0, x1, x2, x0, 255, 1);
-        rd_key[1] = x0;
-        EXPAND_ASSIST(x0, x1, x2, x0, 255, 2);
-        rd_key[2] = x0;
-        EXPAND_ASSIST(x0, x1, x2, x0, 255, 4);
-        rd_key[3] = x0;
-        EXPAND_ASSIST(x0, x1, x2, x0, 255, 8);
-        rd_key[4] = x0;
-        EXPAND_ASSIST(x0, x1, x2, x0, 255, 16);
-        rd_key[5] = x0;
-        EXPAND_ASSIST(x0, x1, x2, x0, 255, 32);
-        rd_key[6] = x0;
-        EXPAND_ASSIST(x0, x1, x2, x0, 255, 64);
-        rd_key[7] = x0;
-        EXPAND_ASSIST(x0, x1, x2, x0, 255, 128);
-        rd_key[8] = x0;
-        EXPAND_ASSIST(x0, x1, x2, x0, 255, 27);
-        rd_key[9] = x0;
-        EXPAND_ASSIST(x0, x1, x2, x0, 255, 54);
-        rd_key[10] = x0;
-
-        return rd_key;
+        psnip_uint8_t key[16];
+        simde_mm_storeu_si128(reinterpret_cast<simde__m128i *>(key), userkey);
+        return detail::user_key_round_keys<128, rd_key_array>(key);
     }
 };  // struct aes128_key
 
@@ -180,46 +260,18 @@ struct aes256_key
   HEDLEY_PRAGMA(GCC diagnostic pop)
     const rd_key_array rd_key;
 
+    aes256_key()
+      : rd_key{detail::zero_key_round_keys<256, rd_key_array>()} { }
+
     explicit aes256_key(const simde__m256i & userkey)
       : rd_key{compute_round_keys(userkey)} { }
 
   private:
-    rd_key_array compute_round_keys(const simde__m256i & userkey)
+    static rd_key_array compute_round_keys(const simde__m256i & userkey)
     {
-        rd_key_array rd_key;
-        simde__m128i x0, x1, x2, x3;
-        rd_key[0] = x0 = simde_mm256_extracti128_si256(userkey, 0);
-        rd_key[1] = x3 = simde_mm256_extracti128_si256(userkey, 0);
-        x2 = simde_mm_setzero_si128();
-
-        EXPAND_ASSIST(x0, x1, x2, x3, 255, 1);
-        rd_key[2] = x0;
-        EXPAND_ASSIST(x3, x1, x2, x0, 170, 1);
-        rd_key[3] = x3;
-        EXPAND_ASSIST(x0, x1, x2, x3, 255, 2);
-        rd_key[4] = x0;
-        EXPAND_ASSIST(x3, x1, x2, x0, 170, 2);
-        rd_key[5] = x3;
-        EXPAND_ASSIST(x0, x1, x2, x3, 255, 4);
-        rd_key[6] = x0;
-        EXPAND_ASSIST(x3, x1, x2, x0, 170, 4);
-        rd_key[7] = x3;
-        EXPAND_ASSIST(x0, x1, x2, x3, 255, 8);
-        rd_key[8] = x0;
-        EXPAND_ASSIST(x3, x1, x2, x0, 170, 8);
-        rd_key[9] = x3;
-        EXPAND_ASSIST(x0, x1, x2, x3, 255, 16);
-        rd_key[10] = x0;
-        EXPAND_ASSIST(x3, x1, x2, x0, 170, 16);
-        rd_key[11] = x3;
-        EXPAND_ASSIST(x0, x1, x2, x3, 255, 32);
-        rd_key[12] = x0;
-        EXPAND_ASSIST(x3, x1, x2, x0, 170, 32);
-        rd_key[13] = x3;
-        EXPAND_ASSIST(x0, x1, x2, x3, 255, 64);
-        rd_key[14] = x0;
-
-        return rd_key;
+        psnip_uint8_t key[32];
+        simde_mm256_storeu_si256(reinterpret_cast<simde__m256i *>(key), userkey);
+        return detail::user_key_round_keys<256, rd_key_array>(key);
     }
 };  // struct aes256_key
 
@@ -227,10 +279,10 @@ using aes128 = aes<aes128_key>;
 using aes256 = aes<aes256_key>;
 
 template <>
-const aes128_key aes128::key = aes128_key(simde__m128i{0, 0});
+const aes128_key aes128::key{};
 
 template <>
-const aes256_key aes256::key = aes256_key(simde__m256i{0, 0, 0, 0});
+const aes256_key aes256::key{};
 
 }  // namespace prg
 
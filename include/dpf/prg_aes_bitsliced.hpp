@@ -0,0 +1,500 @@
+/// @file dpf/prg_aes_bitsliced.hpp
+/// @brief constant-time bitsliced AES for hosts without AES-NI
+/// @details `dpf::prg::aes128_bitsliced` (and `aes256_bitsliced`) produce
+///          exactly the same output as `dpf::prg::aes128` (resp. `aes256`),
+///          but are built solely from SSE/AVX2 logic and byte shuffles: the
+///          state of 8 blocks (16 with AVX2) is transposed into 8 bit-planes,
+///          SubBytes is evaluated as the Boyar-Peralta circuit, and ShiftRows
+///          and MixColumns become byte shuffles within each plane. There are
+///          no secret-dependent memory accesses or branches, and the key
+///          schedule is computed at compile time, so nothing here requires
+///          AES-NI at runtime (or at static-initialization time).
+///          Every call encrypts at least one full 8-block batch, so a lone
+///          `eval` or `eval01` costs about as much as 8 (resp. 4) blocks;
+///          callers that expand many nodes should prefer `eval_many`.
+/// @author Ryan Henry <ryan.henry@ucalgary.ca>
+/// @copyright Copyright (c) 2019-2024 Ryan Henry and [others](@ref authors)
+/// @license Released under a GNU General Public v2.0 (GPLv2) license;
+///          see [LICENSE.md](@ref license) for details.
+
+#ifndef LIBDPF_INCLUDE_DPF_PRG_AES_BITSLICED_HPP__
+#define LIBDPF_INCLUDE_DPF_PRG_AES_BITSLICED_HPP__
+
+#include <cstddef>
+#include <array>
+#include <algorithm>
+
+#include "hedley/hedley.h"
+#include "simde/simde/x86/avx2.h"
+#include "portable-snippets/exact-int/exact-int.h"
+
+#include "dpf/utils.hpp"
+
+namespace dpf
+{
+
+namespace prg
+{
+
+namespace detail
+{
+
+HEDLEY_CONST
+constexpr psnip_uint8_t gf256_mul(psnip_uint8_t a, psnip_uint8_t b) noexcept
+{
+    psnip_uint8_t p = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        if (b & 1) p ^= a;
+        bool carry = a & 0x80;
+        a = static_cast<psnip_uint8_t>(a << 1);
+        if (carry) a ^= 0x1b;
+        b >>= 1;
+    }
+    return p;
+}
+
+// only used to build the (public) key schedule at compile time; the data
+// path evaluates the S-box as a circuit
+HEDLEY_CONST
+constexpr psnip_uint8_t aes_sbox(psnip_uint8_t x) noexcept
+{
+    // x^254 = x^-1 in GF(2^8), with 0 mapping to 0
+    psnip_uint8_t inv = 1;
+    for (int i = 0; i < 254; ++i) inv = gf256_mul(inv, x);
+    psnip_uint8_t s = 0x63;
+    for (int i = 0; i < 5; ++i)
+    {
+        s ^= static_cast<psnip_uint8_t>((inv << i) | (inv >> ((8 - i) & 7)));
+    }
+    return s;
+}
+
+template <std::size_t KeyBits>
+struct bitsliced_key_schedule
+{
+    static constexpr std::size_t key_words = KeyBits / 32;
+    static constexpr std::size_t rounds = key_words + 6;
+
+    // the fixed key is all-zero, matching `dpf::prg::aes128` and `aes256`
+    constexpr bitsliced_key_schedule() : round_keys{}, planes{}
+    {
+        psnip_uint8_t key[4*key_words]{};
+        expand(key);
+    }
+
+    // expands an arbitrary `KeyBits`-bit key; this is `constexpr` but is
+    // also how `aes128_key` and `aes256_key` expand user keys at runtime
+    constexpr explicit bitsliced_key_schedule(const psnip_uint8_t * key)
+      : round_keys{}, planes{}
+    {
+        expand(key);
+    }
+
+    psnip_uint8_t round_keys[rounds+1][16];
+    // planes[r][b] has byte i set to 0xff iff bit b of round key r's byte i
+    // is set; in the bitsliced state each byte holds one bit from 8 blocks
+    psnip_uint8_t planes[rounds+1][8][16];
+
+  private:
+    constexpr void expand(const psnip_uint8_t * key)
+    {
+        psnip_uint8_t w[4*(rounds+1)][4]{};
+        for (std::size_t i = 0; i < key_words; ++i)
+        {
+            for (std::size_t j = 0; j < 4; ++j) w[i][j] = key[4*i + j];
+        }
+        psnip_uint8_t rcon = 1;
+        for (std::size_t i = key_words; i < 4*(rounds+1); ++i)
+        {
+            psnip_uint8_t t[4] = { w[i-1][0], w[i-1][1], w[i-1][2], w[i-1][3] };
+            if (i % key_words == 0)
+            {
+                psnip_uint8_t t0 = t[0];
+                t[0] = static_cast<psnip_uint8_t>(aes_sbox(t[1]) ^ rcon);
+                t[1] = aes_sbox(t[2]);
+                t[2] = aes_sbox(t[3]);
+                t[3] = aes_sbox(t0);
+                rcon = gf256_mul(rcon, 2);
+            }
+            else if (key_words > 6 && i % key_words == 4)
+            {
+                for (auto & b : t) b = aes_sbox(b);
+            }
+            for (std::size_t j = 0; j < 4; ++j)
+            {
+                w[i][j] = static_cast<psnip_uint8_t>(w[i-key_words][j] ^ t[j]);
+            }
+        }
+        for (std::size_t r = 0; r <= rounds; ++r)
+        {
+            for (std::size_t i = 0; i < 16; ++i)
+            {
+                round_keys[r][i] = w[4*r + i/4][i%4];
+                for (std::size_t b = 0; b < 8; ++b)
+                {
+                    planes[r][b][i] = ((round_keys[r][i] >> b) & 1) ? 0xff : 0x00;
+                }
+            }
+        }
+    }
+};
+
+template <typename V>
+struct bitslice_ops;
+
+template <>
+struct bitslice_ops<simde__m128i>
+{
+    using vector_type = simde__m128i;
+    static constexpr std::size_t blocks = 8;
+
+    static vector_type load(const psnip_uint8_t * p) { return simde_mm_loadu_si128(reinterpret_cast<const simde__m128i *>(p)); }
+    static vector_type xor_(vector_type a, vector_type b) { return simde_mm_xor_si128(a, b); }
+    static vector_type and_(vector_type a, vector_type b) { return simde_mm_and_si128(a, b); }
+    static vector_type not_(vector_type a) { return simde_mm_xor_si128(a, simde_mm_set1_epi8(-1)); }
+    static vector_type shuffle(vector_type a, vector_type idx) { return simde_mm_shuffle_epi8(a, idx); }
+    static vector_type set1(psnip_uint8_t b) { return simde_mm_set1_epi8(static_cast<char>(b)); }
+    template <int S> static vector_type srli(vector_type a) { return simde_mm_srli_epi64(a, S); }
+    template <int S> static vector_type slli(vector_type a) { return simde_mm_slli_epi64(a, S); }
+
+    static void load_blocks(vector_type (&q)[8], const simde__m128i * in)
+    {
+        for (std::size_t k = 0; k < 8; ++k) q[k] = in[k];
+    }
+
+    static void store_blocks(simde__m128i * out, const vector_type (&q)[8])
+    {
+        for (std::size_t k = 0; k < 8; ++k) out[k] = q[k];
+    }
+};
+
+template <>
+struct bitslice_ops<simde__m256i>
+{
+    using vector_type = simde__m256i;
+    static constexpr std::size_t blocks = 16;
+
+    static vector_type load(const psnip_uint8_t * p)
+    {
+        return simde_mm256_broadcastsi128_si256(
+            simde_mm_loadu_si128(reinterpret_cast<const simde__m128i *>(p)));
+    }
+    static vector_type xor_(vector_type a, vector_type b) { return simde_mm256_xor_si256(a, b); }
+    static vector_type and_(vector_type a, vector_type b) { return simde_mm256_and_si256(a, b); }
+    static vector_type not_(vector_type a) { return simde_mm256_xor_si256(a, simde_mm256_set1_epi8(-1)); }
+    static vector_type shuffle(vector_type a, vector_type idx) { return simde_mm256_shuffle_epi8(a, idx); }
+    static vector_type set1(psnip_uint8_t b) { return simde_mm256_set1_epi8(static_cast<char>(b)); }
+    template <int S> static vector_type srli(vector_type a) { return simde_mm256_srli_epi64(a, S); }
+    template <int S> static vector_type slli(vector_type a) { return simde_mm256_slli_epi64(a, S); }
+
+    // lane 0 of q[k] holds block k, lane 1 holds block k+8
+    static void load_blocks(vector_type (&q)[8], const simde__m128i * in)
+    {
+        for (std::size_t k = 0; k < 8; ++k)
+        {
+            q[k] = simde_mm256_inserti128_si256(
+                simde_mm256_castsi128_si256(in[k]), in[k+8], 1);
+        }
+    }
+
+    static void store_blocks(simde__m128i * out, const vector_type (&q)[8])
+    {
+        for (std::size_t k = 0; k < 8; ++k)
+        {
+            out[k] = simde_mm256_castsi256_si128(q[k]);
+            out[k+8] = simde_mm256_extracti128_si256(q[k], 1);
+        }
+    }
+};
+
+template <typename Ops, int S>
+HEDLEY_ALWAYS_INLINE
+void swapmove(typename Ops::vector_type & a, typename Ops::vector_type & b,
+    typename Ops::vector_type mask)
+{
+    auto t = Ops::and_(Ops::xor_(Ops::template srli<S>(a), b), mask);
+    b = Ops::xor_(b, t);
+    a = Ops::xor_(a, Ops::template slli<S>(t));
+}
+
+// 8x8 bit-matrix transpose within every byte position: afterwards bit k
+// of byte i of q[b] is bit b of byte i of (input) q[k]; an involution
+template <typename Ops>
+HEDLEY_ALWAYS_INLINE
+void bitslice(typename Ops::vector_type (&q)[8])
+{
+    auto m1 = Ops::set1(0x55), m2 = Ops::set1(0x33), m4 = Ops::set1(0x0f);
+    swapmove<Ops, 1>(q[0], q[1], m1);
+    swapmove<Ops, 1>(q[2], q[3], m1);
+    swapmove<Ops, 1>(q[4], q[5], m1);
+    swapmove<Ops, 1>(q[6], q[7], m1);
+    swapmove<Ops, 2>(q[0], q[2], m2);
+    swapmove<Ops, 2>(q[1], q[3], m2);
+    swapmove<Ops, 2>(q[4], q[6], m2);
+    swapmove<Ops, 2>(q[5], q[7], m2);
+    swapmove<Ops, 4>(q[0], q[4], m4);
+    swapmove<Ops, 4>(q[1], q[5], m4);
+    swapmove<Ops, 4>(q[2], q[6], m4);
+    swapmove<Ops, 4>(q[3], q[7], m4);
+}
+
+// SubBytes on all bytes of the bitsliced state, using the circuit of Boyar
+// and Peralta, "A new combinational logic minimization technique with
+// applications to cryptology" (https://eprint.iacr.org/2009/191);
+// x0 is the most significant bit (i.e., plane 7)
+template <typename Ops>
+HEDLEY_ALWAYS_INLINE
+void sub_bytes(typename Ops::vector_type (&q)[8])
+{
+    using V = typename Ops::vector_type;
+    auto X = [](V a, V b) { return Ops::xor_(a, b); };
+    auto A = [](V a, V b) { return Ops::and_(a, b); };
+    auto XN = [](V a, V b) { return Ops::not_(Ops::xor_(a, b)); };
+
+    V x0 = q[7], x1 = q[6], x2 = q[5], x3 = q[4],
+      x4 = q[3], x5 = q[2], x6 = q[1], x7 = q[0];
+
+    // top linear transformation
+    V y14 = X(x3, x5), y13 = X(x0, x6), y9 = X(x0, x3), y8 = X(x0, x5);
+    V t0 = X(x1, x2), y1 = X(t0, x7), y4 = X(y1, x3), y12 = X(y13, y14);
+    V y2 = X(y1, x0), y5 = X(y1, x6), y3 = X(y5, y8), t1 = X(x4, y12);
+    V y15 = X(t1, x5), y20 = X(t1, x1), y6 = X(y15, x7), y10 = X(y15, t0);
+    V y11 = X(y20, y9), y7 = X(x7, y11), y17 = X(y10, y11), y19 = X(y10, y8);
+    V y16 = X(t0, y11), y21 = X(y13, y16), y18 = X(x0, y16);
+
+    // non-linear section
+    V t2 = A(y12, y15), t3 = A(y3, y6), t4 = X(t3, t2), t5 = A(y4, x7);
+    V t6 = X(t5, t2), t7 = A(y13, y16), t8 = A(y5, y1), t9 = X(t8, t7);
+    V t10 = A(y2, y7), t11 = X(t10, t7), t12 = A(y9, y11), t13 = A(y14, y17);
+    V t14 = X(t13, t12), t15 = A(y8, y10), t16 = X(t15, t12), t17 = X(t4, t14);
+    V t18 = X(t6, t16), t19 = X(t9, t14), t20 = X(t11, t16), t21 = X(t17, y20);
+    V t22 = X(t18, y19), t23 = X(t19, y21), t24 = X(t20, y18);
+
+    V t25 = X(t21, t22), t26 = A(t21, t23), t27 = X(t24, t26), t28 = A(t25, t27);
+    V t29 = X(t28, t22), t30 = X(t23, t24), t31 = X(t22, t26), t32 = A(t31, t30);
+    V t33 = X(t32, t24), t34 = X(t23, t33), t35 = X(t27, t33), t36 = A(t24, t35);
+    V t37 = X(t36, t34), t38 = X(t27, t36), t39 = A(t29, t38), t40 = X(t25, t39);
+
+    V t41 = X(t40, t37), t42 = X(t29, t33), t43 = X(t29, t40), t44 = X(t33, t37);
+    V t45 = X(t42, t41);
+    V z0 = A(t44, y15), z1 = A(t37, y6), z2 = A(t33, x7), z3 = A(t43, y16);
+    V z4 = A(t40, y1), z5 = A(t29, y7), z6 = A(t42, y11), z7 = A(t45, y17);
+    V z8 = A(t41, y10), z9 = A(t44, y12), z10 = A(t37, y3), z11 = A(t33, y4);
+    V z12 = A(t43, y13), z13 = A(t40, y5), z14 = A(t29, y2), z15 = A(t42, y9);
+    V z16 = A(t45, y14), z17 = A(t41, y8);
+
+    // bottom linear transformation
+    V t46 = X(z15, z16), t47 = X(z10, z11), t48 = X(z5, z13), t49 = X(z9, z10);
+    V t50 = X(z2, z12), t51 = X(z2, z5), t52 = X(z7, z8), t53 = X(z0, z3);
+    V t54 = X(z6, z7), t55 = X(z16, z17), t56 = X(z12, t48), t57 = X(t50, t53);
+    V t58 = X(z4, t46), t59 = X(z3, t54), t60 = X(t46, t57), t61 = X(z14, t57);
+    V t62 = X(t52, t58), t63 = X(t49, t58), t64 = X(z4, t59), t65 = X(t61, t62);
+    V t66 = X(z1, t63);
+    V s0 = X(t59, t63), s6 = XN(t56, t62), s7 = XN(t48, t60), t67 = X(t64, t65);
+    V s3 = X(t53, t66), s4 = X(t51, t66), s5 = X(t47, t65), s1 = XN(t64, s3);
+    V s2 = XN(t55, t67);
+
+    q[7] = s0; q[6] = s1; q[5] = s2; q[4] = s3;
+    q[3] = s4; q[2] = s5; q[1] = s6; q[0] = s7;
+}
+
+// byte i of the output of `shuffle` is byte idx[i] of its input
+alignas(16) inline constexpr psnip_uint8_t shift_rows_index[16] =
+    { 0, 5, 10, 15, 4, 9, 14, 3, 8, 13, 2, 7, 12, 1, 6, 11 };
+alignas(16) inline constexpr psnip_uint8_t rotate_column_index[2][16] = {
+    { 1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12 },
+    { 2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13 }
+};
+
+template <typename Ops>
+HEDLEY_ALWAYS_INLINE
+void shift_rows(typename Ops::vector_type (&q)[8])
+{
+    const auto idx = Ops::load(shift_rows_index);
+    for (auto & p : q) p = Ops::shuffle(p, idx);
+}
+
+template <typename Ops>
+HEDLEY_ALWAYS_INLINE
+void mix_columns(typename Ops::vector_type (&q)[8])
+{
+    using V = typename Ops::vector_type;
+    const auto r1 = Ops::load(rotate_column_index[0]),
+               r2 = Ops::load(rotate_column_index[1]);
+
+    V a1[8], t[8];
+    for (std::size_t b = 0; b < 8; ++b)
+    {
+        a1[b] = Ops::shuffle(q[b], r1);
+        t[b] = Ops::xor_(q[b], a1[b]);
+    }
+    // xtime(t): multiply each byte by 2 modulo x^8+x^4+x^3+x+1
+    V x[8] = { t[7], Ops::xor_(t[0], t[7]), t[1], Ops::xor_(t[2], t[7]),
+               Ops::xor_(t[3], t[7]), t[4], t[5], t[6] };
+    for (std::size_t b = 0; b < 8; ++b)
+    {
+        q[b] = Ops::xor_(Ops::xor_(x[b], a1[b]), Ops::shuffle(t[b], r2));
+    }
+}
+
+template <typename Ops, std::size_t KeyBits>
+HEDLEY_ALWAYS_INLINE
+void add_round_key(typename Ops::vector_type (&q)[8],
+    const bitsliced_key_schedule<KeyBits> & schedule, std::size_t round)
+{
+    for (std::size_t b = 0; b < 8; ++b)
+    {
+        q[b] = Ops::xor_(q[b], Ops::load(schedule.planes[round][b]));
+    }
+}
+
+// encrypts Ops::blocks blocks that have already been whitened with round
+// key 0; i.e., applies rounds 1 through `rounds`, like a chain of
+// `aesenc`s followed by one `aesenclast`
+template <typename Ops, std::size_t KeyBits>
+void bitsliced_rounds(simde__m128i * blocks,
+    const bitsliced_key_schedule<KeyBits> & schedule)
+{
+    typename Ops::vector_type q[8];
+    Ops::load_blocks(q, blocks);
+    bitslice<Ops>(q);
+    for (std::size_t r = 1; r < schedule.rounds; ++r)
+    {
+        sub_bytes<Ops>(q);
+        shift_rows<Ops>(q);
+        mix_columns<Ops>(q);
+        add_round_key<Ops>(q, schedule, r);
+    }
+    sub_bytes<Ops>(q);
+    shift_rows<Ops>(q);
+    add_round_key<Ops>(q, schedule, schedule.rounds);
+    bitslice<Ops>(q);
+    Ops::store_blocks(blocks, q);
+}
+
+}  // namespace detail
+
+template <std::size_t KeyBits>
+struct aes_bitsliced final
+{
+    using block_type = simde__m128i;
+
+    // N.B.: this runs a whole 8-block batch for one block; see `process`
+    HEDLEY_NO_THROW
+    static block_type eval(block_type seed, psnip_uint32_t pos) noexcept
+    {
+        block_type output;
+        eval_blocks(&seed, &output, 1, simde_mm_set_epi64x(0, pos));
+        return output;
+    }
+
+    HEDLEY_NO_THROW
+    static auto eval01(block_type seed) noexcept
+    {
+        block_type seeds[2] = { seed, seed }, output[2];
+        block_type whitening[2] = { simde_mm_setzero_si128(),
+                                    simde_mm_set_epi64x(0, 1) };
+        process(seeds, output, 2, [&whitening](std::size_t i)
+            { return simde_mm_xor_si128(round_key0(), whitening[i]); });
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+        return std::array<block_type, 2>{output[0], output[1]};
+HEDLEY_PRAGMA(GCC diagnostic pop)
+    }
+
+    // N.B.: like `dpf::prg::aes`, counter mode does not apply round key 0
+    HEDLEY_NO_THROW
+    static void eval(block_type seed, block_type * HEDLEY_RESTRICT output,
+        psnip_uint32_t count, psnip_uint32_t pos = 0) noexcept
+    {
+        for (psnip_uint32_t i = 0; i < count; i += batch)
+        {
+            std::size_t n = std::min<std::size_t>(batch, count - i);
+            block_type seeds[batch];
+            std::fill_n(seeds, n, seed);
+            process(seeds, &output[i], n, [pos, i](std::size_t k)
+                { return simde_mm_set_epi64x(0, pos + i + k); });
+        }
+    }
+
+    HEDLEY_NO_THROW
+    static void eval_many(const block_type * HEDLEY_RESTRICT seeds,
+        psnip_uint32_t pos, block_type * HEDLEY_RESTRICT output,
+        std::size_t count) noexcept
+    {
+        eval_blocks(seeds, output, count, simde_mm_set_epi64x(0, pos));
+    }
+
+  private:
+    // batches of at most `narrow_ops::blocks` blocks (in particular, the
+    // single-block `eval` and `eval01`) use 128-bit bit-planes even when
+    // AVX2 is available, so they never pay for 16 lanes
+    using narrow_ops = detail::bitslice_ops<simde__m128i>;
+#if defined(__AVX2__)
+    using ops = detail::bitslice_ops<simde__m256i>;
+#else
+    using ops = narrow_ops;
+#endif
+    static constexpr std::size_t batch = ops::blocks;
+    static constexpr detail::bitsliced_key_schedule<KeyBits> schedule{};
+
+    static block_type round_key0() noexcept
+    {
+        return simde_mm_loadu_si128(
+            reinterpret_cast<const simde__m128i *>(schedule.round_keys[0]));
+    }
+
+    static void eval_blocks(const block_type * seeds, block_type * output,
+        std::size_t count, block_type pos) noexcept
+    {
+        auto rd_key0 = simde_mm_xor_si128(round_key0(), pos);
+        for (std::size_t i = 0; i < count; i += batch)
+        {
+            process(&seeds[i], &output[i], std::min(batch, count - i),
+                [&rd_key0](std::size_t) { return rd_key0; });
+        }
+    }
+
+    // computes output[k] = AES(seeds[k] ^ whitening(k)) ^ seeds[k] for
+    // k < n <= batch; unused lanes are encrypted too, and then discarded
+    template <typename Whitening>
+    static void process(const block_type * seeds, block_type * output,
+        std::size_t n, Whitening && whitening) noexcept
+    {
+        if (n <= narrow_ops::blocks)
+        {
+            process_with<narrow_ops>(seeds, output, n, whitening);
+        }
+        else
+        {
+            process_with<ops>(seeds, output, n, whitening);
+        }
+    }
+
+    template <typename Ops, typename Whitening>
+    static void process_with(const block_type * seeds, block_type * output,
+        std::size_t n, Whitening & whitening) noexcept
+    {
+        block_type blocks[Ops::blocks];
+        for (std::size_t k = 0; k < Ops::blocks; ++k)
+        {
+            blocks[k] = k < n ? simde_mm_xor_si128(seeds[k], whitening(k))
+                              : simde_mm_setzero_si128();
+        }
+        detail::bitsliced_rounds<Ops>(blocks, schedule);
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            output[k] = simde_mm_xor_si128(blocks[k], seeds[k]);
+        }
+    }
+};  // struct aes_bitsliced
+
+using aes128_bitsliced = aes_bitsliced<128>;
+using aes256_bitsliced = aes_bitsliced<256>;
+
+}  // namespace prg
+
+}  // namespace dpf
+
+#endif  // LIBDPF_INCLUDE_DPF_PRG_AES_BITSLICED_HPP__
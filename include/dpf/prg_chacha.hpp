@@ -0,0 +1,273 @@
+/// @file dpf/prg_chacha.hpp
+/// @brief ChaCha-based PRG for interior and exterior expansion
+/// @details `dpf::prg::chacha<Rounds>` keys ChaCha with the 128-bit seed
+///          (using the "expand 16-byte k" constants) and takes the block at
+///          position `pos` from words `4*(pos%4)` through `4*(pos%4)+3` of
+///          keystream block `pos/4`. Thus `eval01` costs a single ChaCha
+///          block, while `eval_many` and the bulk `eval` compute eight
+///          ChaCha blocks per pass, one per 32-bit lane of an AVX2 register.
+///          Only ARX operations are used, so no AES hardware is required.
+/// @author Ryan Henry <ryan.henry@ucalgary.ca>
+/// @copyright Copyright (c) 2019-2024 Ryan Henry and [others](@ref authors)
+/// @license Released under a GNU General Public v2.0 (GPLv2) license;
+///          see [LICENSE.md](@ref license) for details.
+
+#ifndef LIBDPF_INCLUDE_DPF_PRG_CHACHA_HPP__
+#define LIBDPF_INCLUDE_DPF_PRG_CHACHA_HPP__
+
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <algorithm>
+
+#include "hedley/hedley.h"
+#include "simde/simde/x86/avx2.h"
+#include "portable-snippets/exact-int/exact-int.h"
+
+#include "dpf/utils.hpp"
+#include "dpf/chacha_block.hpp"
+
+namespace dpf
+{
+
+namespace prg
+{
+
+namespace detail
+{
+
+static constexpr psnip_uint32_t chacha_constants[4] = {
+    0x61707865, 0x3120646e, 0x79622d36, 0x6b206574 };  // "expand 16-byte k"
+
+HEDLEY_ALWAYS_INLINE
+simde__m256i chacha_rotl16(simde__m256i x) noexcept
+{
+    const simde__m256i rot16 = simde_mm256_set_epi8(
+        13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+        13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+    return simde_mm256_shuffle_epi8(x, rot16);
+}
+
+HEDLEY_ALWAYS_INLINE
+simde__m256i chacha_rotl8(simde__m256i x) noexcept
+{
+    const simde__m256i rot8 = simde_mm256_set_epi8(
+        14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3,
+        14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3);
+    return simde_mm256_shuffle_epi8(x, rot8);
+}
+
+template <int R>
+HEDLEY_ALWAYS_INLINE
+simde__m256i chacha_rotl(simde__m256i x) noexcept
+{
+    return simde_mm256_or_si256(simde_mm256_slli_epi32(x, R),
+        simde_mm256_srli_epi32(x, 32 - R));
+}
+
+HEDLEY_ALWAYS_INLINE
+void chacha_quarter_round(simde__m256i & a, simde__m256i & b,
+    simde__m256i & c, simde__m256i & d) noexcept
+{
+    a = simde_mm256_add_epi32(a, b); d = chacha_rotl16(simde_mm256_xor_si256(d, a));
+    c = simde_mm256_add_epi32(c, d); b = chacha_rotl<12>(simde_mm256_xor_si256(b, c));
+    a = simde_mm256_add_epi32(a, b); d = chacha_rotl8(simde_mm256_xor_si256(d, a));
+    c = simde_mm256_add_epi32(c, d); b = chacha_rotl<7>(simde_mm256_xor_si256(b, c));
+}
+
+/// @brief eight ChaCha block functions at once; lane `k` of `x[w]` holds
+///        word `w` of the `k`th input state and is overwritten with word
+///        `w` of the corresponding output
+template <std::size_t Rounds>
+HEDLEY_NO_THROW
+void chacha_block8(simde__m256i (&x)[16]) noexcept
+{
+    static_assert(Rounds % 2 == 0, "ChaCha requires an even round count");
+    simde__m256i in[16];
+    std::copy_n(x, 16, in);
+    for (std::size_t r = 0; r < Rounds; r += 2)
+    {
+        chacha_quarter_round(x[0], x[4], x[8], x[12]);
+        chacha_quarter_round(x[1], x[5], x[9], x[13]);
+        chacha_quarter_round(x[2], x[6], x[10], x[14]);
+        chacha_quarter_round(x[3], x[7], x[11], x[15]);
+        chacha_quarter_round(x[0], x[5], x[10], x[15]);
+        chacha_quarter_round(x[1], x[6], x[11], x[12]);
+        chacha_quarter_round(x[2], x[7], x[8], x[13]);
+        chacha_quarter_round(x[3], x[4], x[9], x[14]);
+    }
+    DPF_UNROLL_LOOP
+    for (std::size_t w = 0; w < 16; ++w) x[w] = simde_mm256_add_epi32(x[w], in[w]);
+}
+
+}  // namespace detail
+
+template <std::size_t Rounds>
+struct chacha final
+{
+    using block_type = simde__m128i;
+
+    HEDLEY_NO_THROW
+    static block_type eval(block_type seed, psnip_uint32_t pos) noexcept
+    {
+        psnip_uint32_t state[16], out[16];
+        init_state(seed, pos / blocks_per_chacha, state);
+        detail::chacha_block<Rounds>(state, out);
+        return to_block(&out[4 * (pos % blocks_per_chacha)]);
+    }
+
+    HEDLEY_NO_THROW
+    static auto eval01(block_type seed) noexcept
+    {
+        psnip_uint32_t state[16], out[16];
+        init_state(seed, 0, state);
+        detail::chacha_block<Rounds>(state, out);
+HEDLEY_PRAGMA(GCC diagnostic push)
+HEDLEY_PRAGMA(GCC diagnostic ignored "-Wignored-attributes")
+        return std::array<block_type, 2>{to_block(&out[0]), to_block(&out[4])};
+HEDLEY_PRAGMA(GCC diagnostic pop)
+    }
+
+    HEDLEY_NO_THROW
+    static void eval(block_type seed, block_type * HEDLEY_RESTRICT output,
+        psnip_uint32_t count, psnip_uint32_t pos = 0) noexcept
+    {
+        psnip_uint32_t key[4];
+        std::memcpy(key, &seed, sizeof(key));
+
+        psnip_uint32_t counter = pos / blocks_per_chacha;
+        std::size_t skip = pos % blocks_per_chacha;
+        std::size_t i = 0;
+        // a single ChaCha block covers the common short-output case
+        if (skip + count <= blocks_per_chacha)
+        {
+            psnip_uint32_t state[16], out[16];
+            init_state(seed, counter, state);
+            detail::chacha_block<Rounds>(state, out);
+            for (; i < count; ++i) output[i] = to_block(&out[4 * (skip + i)]);
+            return;
+        }
+        while (i < count)
+        {
+            simde__m256i x[16];
+            set_constants_and_nonce(x);
+            for (std::size_t w = 0; w < 4; ++w)
+            {
+                x[4+w] = x[8+w] = simde_mm256_set1_epi32(static_cast<int>(key[w]));
+            }
+            x[12] = simde_mm256_add_epi32(
+                simde_mm256_set1_epi32(static_cast<int>(counter)),
+                simde_mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+            detail::chacha_block8<Rounds>(x);
+
+            alignas(simde__m256i) psnip_uint32_t words[16][lanes];
+            for (std::size_t w = 0; w < 16; ++w)
+            {
+                simde_mm256_store_si256(reinterpret_cast<simde__m256i *>(words[w]), x[w]);
+            }
+            for (std::size_t k = 0; k < lanes && i < count; ++k)
+            {
+                for (std::size_t b = skip; b < blocks_per_chacha && i < count; ++b, ++i)
+                {
+                    output[i] = gather_block(words, 4 * b, k);
+                }
+                skip = 0;
+            }
+            counter += lanes;
+        }
+    }
+
+    HEDLEY_NO_THROW
+    static void eval_many(const block_type * HEDLEY_RESTRICT seeds,
+        psnip_uint32_t pos, block_type * HEDLEY_RESTRICT output,
+        std::size_t count) noexcept
+    {
+        // one seed per 32-bit lane; a short final batch is padded with the
+        // last seed and its surplus outputs are discarded
+        for (std::size_t i = 0; i < count; i += lanes)
+        {
+            std::size_t n = std::min(lanes, count - i);
+            alignas(simde__m256i) psnip_uint32_t words[16][lanes];
+            for (std::size_t k = 0; k < lanes; ++k)
+            {
+                psnip_uint32_t key[4];
+                std::memcpy(key, &seeds[i + std::min(k, n-1)], sizeof(key));
+                for (std::size_t w = 0; w < 4; ++w) words[w][k] = key[w];
+            }
+
+            simde__m256i x[16];
+            set_constants_and_nonce(x);
+            for (std::size_t w = 0; w < 4; ++w)
+            {
+                x[4+w] = x[8+w] = simde_mm256_load_si256(
+                    reinterpret_cast<const simde__m256i *>(words[w]));
+            }
+            x[12] = simde_mm256_set1_epi32(
+                static_cast<int>(pos / blocks_per_chacha));
+            detail::chacha_block8<Rounds>(x);
+
+            for (std::size_t w = 0; w < 4; ++w)
+            {
+                simde_mm256_store_si256(reinterpret_cast<simde__m256i *>(words[w]),
+                    x[4*(pos % blocks_per_chacha) + w]);
+            }
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                output[i+k] = gather_block(words, 0, k);
+            }
+        }
+    }
+
+  private:
+    static constexpr std::size_t lanes = 8;
+    static constexpr psnip_uint32_t blocks_per_chacha = 4;
+
+    HEDLEY_ALWAYS_INLINE
+    static void init_state(block_type seed, psnip_uint32_t counter,
+        psnip_uint32_t (&state)[16]) noexcept
+    {
+        std::copy_n(detail::chacha_constants, 4, state);
+        std::memcpy(&state[4], &seed, sizeof(seed));
+        std::memcpy(&state[8], &seed, sizeof(seed));
+        state[12] = counter;
+        state[13] = state[14] = state[15] = 0;
+    }
+
+    HEDLEY_ALWAYS_INLINE
+    static void set_constants_and_nonce(simde__m256i (&x)[16]) noexcept
+    {
+        for (std::size_t w = 0; w < 4; ++w)
+        {
+            x[w] = simde_mm256_set1_epi32(static_cast<int>(detail::chacha_constants[w]));
+        }
+        x[13] = x[14] = x[15] = simde_mm256_setzero_si256();
+    }
+
+    HEDLEY_ALWAYS_INLINE
+    static block_type to_block(const psnip_uint32_t * words) noexcept
+    {
+        block_type block;
+        std::memcpy(&block, words, sizeof(block));
+        return block;
+    }
+
+    HEDLEY_ALWAYS_INLINE
+    static block_type gather_block(const psnip_uint32_t (&words)[16][lanes],
+        std::size_t first_word, std::size_t lane) noexcept
+    {
+        return simde_mm_set_epi32(
+            static_cast<int>(words[first_word+3][lane]),
+            static_cast<int>(words[first_word+2][lane]),
+            static_cast<int>(words[first_word+1][lane]),
+            static_cast<int>(words[first_word+0][lane]));
+    }
+};  // struct chacha
+
+using chacha8 = chacha<8>;
+using chacha12 = chacha<12>;
+
+}  // namespace prg
+
+}  // namespace dpf
+
+#endif  // LIBDPF_INCLUDE_DPF_PRG_CHACHA_HPP__
@@ -45,6 +45,12 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
     {
         std::fill_n(output, count_, seed);
     }
+
+    static void eval_many(const block_type * HEDLEY_RESTRICT seeds, psnip_uint32_t,
+        block_type * HEDLEY_RESTRICT output, std::size_t count_)
+    {
+        std::copy_n(seeds, count_, output);
+    }
 };  // struct dummy
 
 }  // namespace prg
@@ -0,0 +1,344 @@
+/// @file dpf/prg_vaes.hpp
+/// @brief VAES kernels and runtime backend selection for `dpf::prg::aes`
+/// @details The kernels in this file are compiled with per-function
+///          `target` attributes rather than global `-m` flags, so a binary
+///          built for a baseline AES-NI target still uses 256- or 512-bit
+///          VAES on hosts that support it. The backend is picked once
+///          (from CPUID) during static initialization; until then, and on
+///          hosts without VAES, `dpf::prg::aes` uses its AES-NI code path.
+///          Define `LIBDPF_DISABLE_VAES` to compile the kernels out.
+/// @author Ryan Henry <ryan.henry@ucalgary.ca>
+/// @copyright Copyright (c) 2019-2024 Ryan Henry and [others](@ref authors)
+/// @license Released under a GNU General Public v2.0 (GPLv2) license;
+///          see [LICENSE.md](@ref license) for details.
+
+#ifndef LIBDPF_INCLUDE_DPF_PRG_VAES_HPP__
+#define LIBDPF_INCLUDE_DPF_PRG_VAES_HPP__
+
+#include <cstddef>
+#include <atomic>
+#include <stdexcept>
+
+#include "hedley/hedley.h"
+#include "simde/simde/x86/avx2.h"
+#include "portable-snippets/exact-int/exact-int.h"
+
+#if !defined(LIBDPF_DISABLE_VAES) && (defined(__x86_64__) || defined(__i386__))
+#if HEDLEY_GCC_VERSION_CHECK(9, 0, 0) || (defined(__clang__) && HEDLEY_HAS_ATTRIBUTE(target))
+#define LIBDPF_HAVE_VAES
+#include <immintrin.h>
+#endif
+#endif
+
+#ifdef LIBDPF_HAVE_VAES
+#define LIBDPF_TARGET_VAES256 __attribute__((target("aes,avx2,vaes")))
+#define LIBDPF_TARGET_VAES512 __attribute__((target("aes,avx2,avx512f,vaes")))
+#endif
+
+namespace dpf
+{
+
+namespace prg
+{
+
+/// @brief instruction set used by `dpf::prg::aes` for batched evaluation
+enum class aes_backend : int
+{
+    aesni = 0,  ///< one block per instruction (always available)
+    vaes256,    ///< two blocks per instruction (VAES + AVX2)
+    vaes512     ///< four blocks per instruction (VAES + AVX-512F)
+};
+
+namespace detail
+{
+
+inline bool aes_backend_supported(aes_backend backend) noexcept
+{
+#ifdef LIBDPF_HAVE_VAES
+    __builtin_cpu_init();
+    switch (backend)
+    {
+        case aes_backend::vaes512:
+            return __builtin_cpu_supports("vaes")
+                && __builtin_cpu_supports("avx512f");
+        case aes_backend::vaes256:
+            return __builtin_cpu_supports("vaes")
+                && __builtin_cpu_supports("avx2");
+        default:
+            return true;
+    }
+#else
+    return backend == aes_backend::aesni;
+#endif
+}
+
+inline aes_backend detect_aes_backend() noexcept
+{
+    if (aes_backend_supported(aes_backend::vaes512)) return aes_backend::vaes512;
+    if (aes_backend_supported(aes_backend::vaes256)) return aes_backend::vaes256;
+    return aes_backend::aesni;
+}
+
+// zero-initialized (i.e., `aes_backend::aesni`) before dynamic
+// initialization, so calls from other static initializers are safe
+inline std::atomic<aes_backend> aes_backend_in_use{detect_aes_backend()};
+
+#ifdef LIBDPF_HAVE_VAES
+
+template <std::size_t Rounds>
+LIBDPF_TARGET_VAES512
+void vaes512_eval_many(const simde__m128i * rd_key,
+    const simde__m128i * seeds, psnip_uint32_t pos, simde__m128i * output,
+    std::size_t count) noexcept
+{
+    constexpr std::size_t lanes = 4;
+    __m512i rk[Rounds+1];
+    for (std::size_t j = 0; j <= Rounds; ++j)
+    {
+        rk[j] = _mm512_broadcast_i32x4(_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(&rd_key[j])));
+    }
+    rk[0] = _mm512_xor_si512(rk[0],
+        _mm512_broadcast_i32x4(_mm_set_epi64x(0, pos)));
+
+    auto in = reinterpret_cast<const psnip_uint64_t *>(seeds);
+    auto out = reinterpret_cast<psnip_uint64_t *>(output);
+
+    std::size_t i = 0;
+    for (; i + 4*lanes <= count; i += 4*lanes)
+    {
+        __m512i s[lanes], x[lanes];
+        for (std::size_t k = 0; k < lanes; ++k)
+        {
+            s[k] = _mm512_loadu_si512(&in[2*(i+4*k)]);
+            x[k] = _mm512_xor_si512(s[k], rk[0]);
+        }
+        for (std::size_t j = 1; j < Rounds; ++j)
+        {
+            for (std::size_t k = 0; k < lanes; ++k)
+            {
+                x[k] = _mm512_aesenc_epi128(x[k], rk[j]);
+            }
+        }
+        for (std::size_t k = 0; k < lanes; ++k)
+        {
+            x[k] = _mm512_aesenclast_epi128(x[k], rk[Rounds]);
+            _mm512_storeu_si512(&out[2*(i+4*k)], _mm512_xor_si512(x[k], s[k]));
+        }
+    }
+    for (; i < count; i += 4)
+    {
+        // 2 qwords per block; the mask covers the remaining (up to 4) blocks
+        std::size_t n = count - i < 4 ? count - i : 4;
+        __mmask8 m = static_cast<__mmask8>((1u << (2*n)) - 1);
+        __m512i s = _mm512_maskz_loadu_epi64(m, &in[2*i]);
+        __m512i x = _mm512_xor_si512(s, rk[0]);
+        for (std::size_t j = 1; j < Rounds; ++j)
+        {
+            x = _mm512_aesenc_epi128(x, rk[j]);
+        }
+        x = _mm512_aesenclast_epi128(x, rk[Rounds]);
+        _mm512_mask_storeu_epi64(&out[2*i], m, _mm512_xor_si512(x, s));
+    }
+}
+
+template <std::size_t Rounds>
+LIBDPF_TARGET_VAES256
+void vaes256_eval_many(const simde__m128i * rd_key,
+    const simde__m128i * seeds, psnip_uint32_t pos, simde__m128i * output,
+    std::size_t count) noexcept
+{
+    constexpr std::size_t lanes = 4;
+    __m256i rk[Rounds+1];
+    for (std::size_t j = 0; j <= Rounds; ++j)
+    {
+        rk[j] = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(&rd_key[j])));
+    }
+    rk[0] = _mm256_xor_si256(rk[0],
+        _mm256_broadcastsi128_si256(_mm_set_epi64x(0, pos)));
+
+    auto in = reinterpret_cast<const __m128i *>(seeds);
+    auto out = reinterpret_cast<__m128i *>(output);
+
+    std::size_t i = 0;
+    for (; i + 2*lanes <= count; i += 2*lanes)
+    {
+        __m256i s[lanes], x[lanes];
+        for (std::size_t k = 0; k < lanes; ++k)
+        {
+            s[k] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&in[i+2*k]));
+            x[k] = _mm256_xor_si256(s[k], rk[0]);
+        }
+        for (std::size_t j = 1; j < Rounds; ++j)
+        {
+            for (std::size_t k = 0; k < lanes; ++k)
+            {
+                x[k] = _mm256_aesenc_epi128(x[k], rk[j]);
+            }
+        }
+        for (std::size_t k = 0; k < lanes; ++k)
+        {
+            x[k] = _mm256_aesenclast_epi128(x[k], rk[Rounds]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(&out[i+2*k]),
+                _mm256_xor_si256(x[k], s[k]));
+        }
+    }
+    for (; i < count; ++i)
+    {
+        __m128i s = _mm_loadu_si128(&in[i]);
+        __m128i x = _mm_xor_si128(s, _mm256_castsi256_si128(rk[0]));
+        for (std::size_t j = 1; j < Rounds; ++j)
+        {
+            x = _mm_aesenc_si128(x, _mm256_castsi256_si128(rk[j]));
+        }
+        x = _mm_aesenclast_si128(x, _mm256_castsi256_si128(rk[Rounds]));
+        _mm_storeu_si128(&out[i], _mm_xor_si128(x, s));
+    }
+}
+
+template <std::size_t Rounds>
+LIBDPF_TARGET_VAES512
+void vaes512_eval_ctr(const simde__m128i * rd_key, simde__m128i seed,
+    simde__m128i * output, std::size_t count, psnip_uint64_t pos) noexcept
+{
+    constexpr std::size_t lanes = 4;
+    __m512i rk[Rounds+1];
+    for (std::size_t j = 1; j <= Rounds; ++j)
+    {
+        rk[j] = _mm512_broadcast_i32x4(_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(&rd_key[j])));
+    }
+    const __m512i s = _mm512_broadcast_i32x4(_mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(&seed)));
+    const __m512i step = _mm512_set_epi64(0, 4, 0, 4, 0, 4, 0, 4);
+    __m512i ctr = _mm512_set_epi64(0, pos+3, 0, pos+2, 0, pos+1, 0, pos);
+
+    auto out = reinterpret_cast<psnip_uint64_t *>(output);
+
+    std::size_t i = 0;
+    for (; i + 4*lanes <= count; i += 4*lanes)
+    {
+        __m512i x[lanes];
+        for (std::size_t k = 0; k < lanes; ++k)
+        {
+            x[k] = _mm512_xor_si512(s, ctr);
+            ctr = _mm512_add_epi64(ctr, step);
+        }
+        for (std::size_t j = 1; j < Rounds; ++j)
+        {
+            for (std::size_t k = 0; k < lanes; ++k)
+            {
+                x[k] = _mm512_aesenc_epi128(x[k], rk[j]);
+            }
+        }
+        for (std::size_t k = 0; k < lanes; ++k)
+        {
+            x[k] = _mm512_aesenclast_epi128(x[k], rk[Rounds]);
+            _mm512_storeu_si512(&out[2*(i+4*k)], _mm512_xor_si512(x[k], s));
+        }
+    }
+    for (; i < count; i += 4)
+    {
+        std::size_t n = count - i < 4 ? count - i : 4;
+        __mmask8 m = static_cast<__mmask8>((1u << (2*n)) - 1);
+        __m512i x = _mm512_xor_si512(s, ctr);
+        ctr = _mm512_add_epi64(ctr, step);
+        for (std::size_t j = 1; j < Rounds; ++j)
+        {
+            x = _mm512_aesenc_epi128(x, rk[j]);
+        }
+        x = _mm512_aesenclast_epi128(x, rk[Rounds]);
+        _mm512_mask_storeu_epi64(&out[2*i], m, _mm512_xor_si512(x, s));
+    }
+}
+
+template <std::size_t Rounds>
+LIBDPF_TARGET_VAES256
+void vaes256_eval_ctr(const simde__m128i * rd_key, simde__m128i seed,
+    simde__m128i * output, std::size_t count, psnip_uint64_t pos) noexcept
+{
+    constexpr std::size_t lanes = 4;
+    __m256i rk[Rounds+1];
+    for (std::size_t j = 1; j <= Rounds; ++j)
+    {
+        rk[j] = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(&rd_key[j])));
+    }
+    const __m256i s = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(&seed)));
+    const __m256i step = _mm256_set_epi64x(0, 2, 0, 2);
+    __m256i ctr = _mm256_set_epi64x(0, pos+1, 0, pos);
+
+    auto out = reinterpret_cast<__m128i *>(output);
+
+    std::size_t i = 0;
+    for (; i + 2*lanes <= count; i += 2*lanes)
+    {
+        __m256i x[lanes];
+        for (std::size_t k = 0; k < lanes; ++k)
+        {
+            x[k] = _mm256_xor_si256(s, ctr);
+            ctr = _mm256_add_epi64(ctr, step);
+        }
+        for (std::size_t j = 1; j < Rounds; ++j)
+        {
+            for (std::size_t k = 0; k < lanes; ++k)
+            {
+                x[k] = _mm256_aesenc_epi128(x[k], rk[j]);
+            }
+        }
+        for (std::size_t k = 0; k < lanes; ++k)
+        {
+            x[k] = _mm256_aesenclast_epi128(x[k], rk[Rounds]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(&out[i+2*k]),
+                _mm256_xor_si256(x[k], s));
+        }
+    }
+    for (psnip_uint64_t p = pos + i; i < count; ++i, ++p)
+    {
+        __m128i x = _mm_xor_si128(_mm256_castsi256_si128(s),
+            _mm_set_epi64x(0, static_cast<long long>(p)));
+        for (std::size_t j = 1; j < Rounds; ++j)
+        {
+            x = _mm_aesenc_si128(x, _mm256_castsi256_si128(rk[j]));
+        }
+        x = _mm_aesenclast_si128(x, _mm256_castsi256_si128(rk[Rounds]));
+        _mm_storeu_si128(&out[i], _mm_xor_si128(x, _mm256_castsi256_si128(s)));
+    }
+}
+
+#endif  // LIBDPF_HAVE_VAES
+
+}  // namespace detail
+
+/// @brief returns the backend currently used by `dpf::prg::aes`
+inline aes_backend get_aes_backend() noexcept
+{
+    return detail::aes_backend_in_use.load(std::memory_order_relaxed);
+}
+
+/// @brief overrides the backend chosen at startup
+/// @details Intended for testing and benchmarking; it should not be called
+///          while other threads are evaluating.
+/// @throws std::domain_error if `backend` is not supported by this host
+inline void set_aes_backend(aes_backend backend)
+{
+    if (detail::aes_backend_supported(backend) == false)
+    {
+        throw std::domain_error("aes backend not supported by this host");
+    }
+    detail::aes_backend_in_use.store(backend, std::memory_order_relaxed);
+}
+
+/// @brief checks whether `backend` can be used on this host
+inline bool aes_backend_supported(aes_backend backend) noexcept
+{
+    return detail::aes_backend_supported(backend);
+}
+
+}  // namespace prg
+
+}  // namespace dpf
+
+#endif  // LIBDPF_INCLUDE_DPF_PRG_VAES_HPP__
@@ -1,6 +1,10 @@
 /// @file dpf/random.hpp
-/// @brief
-/// @details
+/// @brief uniform random sampling for key generation
+/// @details By default, randomness comes from a per-thread ChaCha20 DRBG
+///          seeded by `getrandom`, so that concurrent key generation does
+///          not contend on a shared device handle. Define
+///          `LIBDPF_USE_DEV_URANDOM`, `LIBDPF_USE_DEV_RANDOM`, or
+///          `LIBDPF_USE_ARC4RANDOM` to read from those sources instead.
 /// @author Ryan Henry <ryan.henry@ucalgary.ca>
 /// @copyright Copyright (c) 2019-2024 Ryan Henry and [others](@ref authors)
 /// @license Released under a GNU General Public v2.0 (GPLv2) license;
@@ -10,14 +14,29 @@
 #define LIBDPF_INCLUDE_DPF_RANDOM_HPP__
 
 #include <bsd/stdlib.h>
+#include <pthread.h>
+#if __has_include(<sys/random.h>)
+#include <sys/random.h>
+#endif
 
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
 #include <utility>
 
 #include "hedley/hedley.h"
+#include "portable-snippets/exact-int/exact-int.h"
+
+#include "dpf/chacha_block.hpp"
 
 namespace dpf
 {
 
+namespace detail
+{
+
 #if   defined(LIBDPF_USE_DEV_RANDOM)
     #define RANDOM_DEVICE "/dev/random"
     static FILE * random_device;
@@ -31,24 +50,20 @@ namespace dpf
         fclose(random_device);
     }
 
-    template <typename T>
     HEDLEY_ALWAYS_INLINE
     HEDLEY_NO_THROW
-    auto & uniform_fill(T & buf) noexcept  // NOLINT(runtime/references)
+    void fill_random_bytes(void * buf, std::size_t len) noexcept
     {
-        while (fread(&buf, sizeof(buf), 1, random_device) != 1) continue;
-        return buf;
+        while (fread(buf, len, 1, random_device) != 1) continue;
     }
 #elif defined(LIBDPF_USE_ARC4RANDOM)
-    template <typename T>
     HEDLEY_ALWAYS_INLINE
     HEDLEY_NO_THROW
-    auto & uniform_fill(T & buf) noexcept  // NOLINT(runtime/references)
+    void fill_random_bytes(void * buf, std::size_t len) noexcept
     {
-        arc4random_buf(&buf, sizeof(buf));
-        return buf;
+        arc4random_buf(buf, len);
     }
-#else
+#elif defined(LIBDPF_USE_DEV_URANDOM)
     #define URANDOM_DEVICE "/dev/urandom"
     static FILE * urandom_device;
     void check_urandom_device() __attribute__((constructor));
@@ -63,16 +78,175 @@ namespace dpf
         fclose(urandom_device);
     }
 
-    template <typename T>
     HEDLEY_ALWAYS_INLINE
     HEDLEY_NO_THROW
-    auto & uniform_fill(T & buf) noexcept  // NOLINT(runtime/references)
+    void fill_random_bytes(void * buf, std::size_t len) noexcept
+    {
+        while (fread(buf, len, 1, urandom_device) != 1) continue;
+    }
+#else
+    /// @brief fills `buf` with `len` bytes from the OS entropy pool
+    /// @details Falls back to `arc4random_buf` if `getrandom` fails for any
+    ///          reason other than being interrupted (e.g., `ENOSYS` on
+    ///          kernels that predate it).
+    HEDLEY_NO_THROW
+    inline void fill_os_random_bytes(void * buf, std::size_t len) noexcept
+    {
+    #if __has_include(<sys/random.h>)
+        auto * out = static_cast<unsigned char *>(buf);
+        while (len > 0)
+        {
+            ssize_t got = getrandom(out, len, 0);
+            if (got < 0)
+            {
+                if (errno == EINTR) continue;
+                arc4random_buf(out, len);
+                return;
+            }
+            out += got;
+            len -= static_cast<std::size_t>(got);
+        }
+    #else
+        arc4random_buf(buf, len);
+    #endif
+    }
+
+    /// @brief counts `fork`s of this process, so that a child can tell
+    ///        that it must not reuse its parent's DRBG state
+    inline std::atomic_uint & fork_generation() noexcept
     {
-        while (fread(&buf, sizeof(buf), 1, urandom_device) != 1) continue;
-        return buf;
+        static std::atomic_uint generation{0};
+        static const bool registered = (pthread_atfork(nullptr, nullptr,
+            []() { generation.fetch_add(1, std::memory_order_relaxed); }), true);
+        static_cast<void>(registered);
+        return generation;
+    }
+
+    /// @brief a ChaCha20-based DRBG with fast key erasure
+    /// @details Each refill generates `buffer_blocks` keystream blocks
+    ///          under the current key and immediately rekeys from the first
+    ///          32 bytes of output, so earlier outputs cannot be recovered
+    ///          from the state (as in OpenBSD's `arc4random`). The key is
+    ///          reseeded from `getrandom` every `reseed_interval` refills and
+    ///          after a `fork`.
+    class chacha20_drbg final
+    {
+      public:
+        static constexpr std::size_t block_size = 64;
+        static constexpr std::size_t buffer_blocks = 64;
+        static constexpr std::size_t key_size = 32;
+        static constexpr std::size_t reseed_interval = 1024;
+
+        chacha20_drbg() noexcept { reseed(); }
+
+        HEDLEY_NO_THROW
+        void fill(void * buf, std::size_t len) noexcept
+        {
+            if (HEDLEY_UNLIKELY(generation_
+                != fork_generation().load(std::memory_order_relaxed)))
+            {
+                reseed();
+            }
+            auto * out = static_cast<unsigned char *>(buf);
+            while (len > 0)
+            {
+                if (pos_ == sizeof(buffer_)) refill();
+                std::size_t n = std::min(len, sizeof(buffer_) - pos_);
+                std::memcpy(out, buffer_ + pos_, n);
+                std::memset(buffer_ + pos_, 0, n);
+                pos_ += n;
+                out += n;
+                len -= n;
+            }
+        }
+
+        /// @brief writes the ChaCha20 keystream block at position `counter`
+        ///        under `key` (with an all-zero nonce) to `out[0..64)`
+        /// @details Uses the same block function as `dpf::prg::chacha`, but
+        ///          with a 256-bit key and the "expand 32-byte k" constants.
+        static void chacha20_block(const psnip_uint32_t (&key)[8],
+            psnip_uint64_t counter, unsigned char * out) noexcept
+        {
+            const psnip_uint32_t in[16] = {
+                0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+                key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+                static_cast<psnip_uint32_t>(counter),
+                static_cast<psnip_uint32_t>(counter >> 32), 0, 0
+            };
+            psnip_uint32_t x[16];
+            dpf::prg::detail::chacha_block<20>(in, x);
+            std::memcpy(out, x, sizeof(x));
+        }
+
+      private:
+        void reseed() noexcept
+        {
+            generation_ = fork_generation().load(std::memory_order_relaxed);
+            fill_os_random_bytes(key_, sizeof(key_));
+            refills_ = 0;
+            refill();
+        }
+
+        void refill() noexcept
+        {
+            if (refills_++ == reseed_interval)
+            {
+                reseed();
+                return;
+            }
+            for (std::size_t i = 0; i < buffer_blocks; ++i)
+            {
+                chacha20_block(key_, i, buffer_ + i * block_size);
+            }
+            std::memcpy(key_, buffer_, sizeof(key_));
+            std::memset(buffer_, 0, sizeof(key_));
+            pos_ = sizeof(key_);
+        }
+
+        psnip_uint32_t key_[key_size / sizeof(psnip_uint32_t)];
+        unsigned char buffer_[buffer_blocks * block_size];
+        std::size_t pos_ = 0;
+        std::size_t refills_ = 0;
+        unsigned generation_ = 0;
+    };
+
+    /// @brief the calling thread's DRBG
+    inline chacha20_drbg & thread_drbg() noexcept
+    {
+        static thread_local chacha20_drbg drbg;
+        return drbg;
+    }
+
+    HEDLEY_ALWAYS_INLINE
+    HEDLEY_NO_THROW
+    void fill_random_bytes(void * buf, std::size_t len) noexcept
+    {
+        thread_drbg().fill(buf, len);
     }
 #endif
 
+}  // namespace detail
+
+/// @brief overwrites `buf` with uniformly random bytes
+template <typename T>
+HEDLEY_ALWAYS_INLINE
+HEDLEY_NO_THROW
+auto & uniform_fill(T & buf) noexcept  // NOLINT(runtime/references)
+{
+    detail::fill_random_bytes(&buf, sizeof(buf));
+    return buf;
+}
+
+/// @brief overwrites `buf[0..count)` with uniformly random bytes
+template <typename T>
+HEDLEY_ALWAYS_INLINE
+HEDLEY_NO_THROW
+T * uniform_fill(T * buf, std::size_t count) noexcept
+{
+    detail::fill_random_bytes(buf, count * sizeof(T));
+    return buf;
+}
+
 template <typename T>
 HEDLEY_ALWAYS_INLINE
 HEDLEY_NO_THROW
@@ -53,18 +53,22 @@ struct sequence_recipe_memoizer_base : public sequence_memoizer_tag_
         }
 
         if (dpf_.has_value() == false || std::memcmp(&dpf_root_, &dpf.root(), sizeof(node_type)) != 0
-            || std::memcmp(&dpf_common_part_hash_, &dpf.common_part_hash(), sizeof(digest_type)) != 0)
+            || std::memcmp(&dpf_interior_hash_, &dpf.interior_hash(), sizeof(digest_type)) != 0)
         {
-            if (dpf_.depth != recipe.depth())
+            if (dpf_type::depth != recipe.depth())
             {
                 throw std::logic_error("incorrect dpf depth");
             }
+            if (dpf_type::lg_outputs_per_leaf != recipe.lg_outputs_per_leaf())
+            {
+                throw std::logic_error("incorrect dpf outputs per leaf");
+            }
             this->operator[](0)[0] = dpf.root();
             dpf_ = std::cref(dpf);
             dpf_root_ = dpf.root();
-            dpf_common_part_hash_ = dpf.common_part_hash();
+            dpf_interior_hash_ = dpf.interior_hash();
             dpf_root_ = dpf.root();
-            dpf_common_part_hash_ = dpf.common_part_hash();
+            dpf_interior_hash_ = dpf.interior_hash();
             level_index = 1;
         }
 
@@ -101,7 +105,7 @@ struct sequence_recipe_memoizer_base : public sequence_memoizer_tag_
     // if it is working in reverse, this could be a right traversal
     virtual bool traverse_first(std::size_t step) const
     {
-        return recipe.recipe_steps()[step] > int8_t(-1);
+        return recipe.step(step) > int8_t(-1);
     }
 
     // returns true if second traversal should be taken
@@ -109,7 +113,7 @@ struct sequence_recipe_memoizer_base : public sequence_memoizer_tag_
     // if it is working in reverse, this could be a left traversal
     virtual bool traverse_second(std::size_t step) const
     {
-        return recipe.recipe_steps()[step] < int8_t(1);
+        return recipe.step(step) < int8_t(1);
     }
 
     // returns true if traversal should be done to the right
@@ -135,7 +139,7 @@ struct sequence_recipe_memoizer_base : public sequence_memoizer_tag_
   private:
     std::optional<std::reference_wrapper<const dpf_type>> dpf_;
     node_type dpf_root_;
-    digest_type dpf_common_part_hash_;
+    digest_type dpf_interior_hash_;
 };
 
 namespace detail
@@ -348,7 +352,7 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
         // flip false => forward traversal
         bool flip = (depth ^ level_index) & 1;
         step = !flip ? step : recipe.level_endpoints()[level_index] - step - 1 + recipe.level_endpoints()[level_index-1];
-        return !flip ? (recipe.recipe_steps()[step] > int8_t(-1)) : (recipe.recipe_steps()[step] < int8_t(1));
+        return !flip ? (recipe.step(step) > int8_t(-1)) : (recipe.step(step) < int8_t(1));
     }
 
     bool traverse_second(std::size_t step) const override
@@ -356,7 +360,7 @@ HEDLEY_PRAGMA(GCC diagnostic pop)
         // flip false => forward traversal
         bool flip = (depth ^ level_index) & 1;
         step = !flip ? step : recipe.level_endpoints()[level_index] - step - 1 + recipe.level_endpoints()[level_index-1];
-        return !flip ? (recipe.recipe_steps()[step] < int8_t(1)) : (recipe.recipe_steps()[step] > int8_t(-1));
+        return !flip ? (recipe.step(step) < int8_t(1)) : (recipe.step(step) > int8_t(-1));
     }
 
     bool get_direction(bool right) const override
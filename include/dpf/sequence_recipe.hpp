@@ -10,125 +10,615 @@
 #ifndef LIBDPF_INCLUDE_DPF_SEQUENCE_RECIPE_HPP__
 #define LIBDPF_INCLUDE_DPF_SEQUENCE_RECIPE_HPP__
 
+#include <hedley/hedley.h>
+
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <type_traits>
 #include <algorithm>
+#include <exception>
+#include <numeric>
 #include <vector>
 #include <stdexcept>
-#include <list>
 #include <iterator>
+#include <limits>
+#include <istream>
+#include <ostream>
+#include <thread>
+#include <utility>
 
 namespace dpf
 {
 
+/// @brief the steps needed to walk from the root to the leaves that cover a
+///        sorted sequence of points
+/// @details Each node on a level is expanded according to one step: `-1`
+///          (right child only), `+1` (left child only), or `0` (both
+///          children). Steps are stored packed, four to a byte, as the
+///          two's-complement low bits of the step (`0b00`, `0b01`, or
+///          `0b11`). Output `i` is output `output_indices()[i] %
+///          2^lg_outputs_per_leaf()` of leaf `output_indices()[i] >>
+///          lg_outputs_per_leaf()`. A recipe depends only on the points and
+///          the shape of the DPF (its depth and `lg_outputs_per_leaf`), so
+///          one recipe can be shared by every key evaluated on the same
+///          points (see `dpf::sequence_recipe_cache`).
 struct sequence_recipe
 {
   public:
     sequence_recipe(const std::vector<int8_t> & steps,
                 const std::vector<std::size_t> & subsequence_indexes,
                 std::size_t leaf_index,
-                const std::vector<std::size_t> & level_endpoints)
-      : recipe_steps_{steps},
+                const std::vector<std::size_t> & level_endpoints,
+                std::size_t lg_outputs_per_leaf = 0)
+      : recipe_steps_{pack(steps)},
+        num_steps_{steps.size()},
         output_indices_{subsequence_indexes},
         num_leaf_nodes_{leaf_index},
-        level_endpoints_{level_endpoints}
+        level_endpoints_{level_endpoints},
+        lg_outputs_per_leaf_{lg_outputs_per_leaf}
     { }
 
-    const std::vector<int8_t> & recipe_steps() const { return recipe_steps_; }
+    sequence_recipe(std::vector<uint8_t> && packed_steps,
+                std::size_t num_steps,
+                std::vector<std::size_t> && subsequence_indexes,
+                std::size_t leaf_index,
+                std::vector<std::size_t> && level_endpoints,
+                std::size_t lg_outputs_per_leaf = 0)
+      : recipe_steps_{std::move(packed_steps)},
+        num_steps_{num_steps},
+        output_indices_{std::move(subsequence_indexes)},
+        num_leaf_nodes_{leaf_index},
+        level_endpoints_{std::move(level_endpoints)},
+        lg_outputs_per_leaf_{lg_outputs_per_leaf}
+    {
+        if (recipe_steps_.size() != packed_size(num_steps_))
+        {
+            throw std::invalid_argument("packed_steps has the wrong size");
+        }
+    }
+
+    /// @brief returns step `i`, which is `-1`, `0`, or `+1`
+    HEDLEY_ALWAYS_INLINE
+    int8_t step(std::size_t i) const noexcept
+    {
+        auto bits = static_cast<uint8_t>(recipe_steps_[i / steps_per_byte] << (6 - 2 * (i % steps_per_byte)));
+        return static_cast<int8_t>(static_cast<int8_t>(bits & 0xc0) >> 6);
+    }
+
+    /// @brief returns an unpacked copy of the steps
+    std::vector<int8_t> recipe_steps() const
+    {
+        std::vector<int8_t> steps(num_steps_);
+        for (std::size_t i = 0; i < num_steps_; ++i) steps[i] = step(i);
+        return steps;
+    }
+
+    const std::vector<uint8_t> & packed_steps() const { return recipe_steps_; }
+    std::size_t num_steps() const { return num_steps_; }
     const std::vector<std::size_t> & output_indices() const { return output_indices_; }
     std::size_t num_leaf_nodes() const { return num_leaf_nodes_; }
     const std::vector<std::size_t> & level_endpoints() const { return level_endpoints_; }
     std::size_t depth() const { return level_endpoints_.size()-1; }
+    /// @brief the base-2 log of the outputs per leaf of the DPFs this recipe
+    ///        is for
+    std::size_t lg_outputs_per_leaf() const { return lg_outputs_per_leaf_; }
+
+    /// @brief writes the recipe in the binary format described at
+    ///        `sequence_recipe::load(const void *, std::size_t)`
+    void save(std::ostream & os) const  // NOLINT(runtime/references)
+    {
+        write_word(os, magic);
+        write_word(os, num_steps_);
+        write_word(os, output_indices_.size());
+        write_word(os, num_leaf_nodes_);
+        write_word(os, depth());
+        write_word(os, lg_outputs_per_leaf_);
+        for (auto endpoint : level_endpoints_) write_word(os, endpoint);
+        for (auto index : output_indices_) write_word(os, index);
+        os.write(reinterpret_cast<const char *>(recipe_steps_.data()),
+            static_cast<std::streamsize>(recipe_steps_.size()));
+        if (!os)
+        {
+            throw std::runtime_error("failed to write sequence_recipe");
+        }
+    }
+
+    /// @brief reads a recipe written by `sequence_recipe::save`
+    static sequence_recipe load(std::istream & is)  // NOLINT(runtime/references)
+    {
+        std::vector<char> bytes{std::istreambuf_iterator<char>(is),
+            std::istreambuf_iterator<char>()};
+        return load(bytes.data(), bytes.size());
+    }
+
+    /// @brief parses a recipe from `bytes` bytes at `data`
+    /// @details The returned recipe owns a copy of everything it needs, so
+    ///          `data` may be released as soon as this returns. The format is a sequence of native-endian 64-bit words
+    ///          followed by the packed steps:
+    ///           - a magic number;
+    ///           - `num_steps`, `output_indices().size()`, `num_leaf_nodes`,
+    ///             `depth`, and `lg_outputs_per_leaf`;
+    ///           - the `depth+1` level endpoints;
+    ///           - the output indices; and
+    ///           - `ceil(num_steps/4)` bytes of packed steps.
+    ///
+    ///          Every word is 8-byte aligned relative to `data`.
+    /// @throws std::runtime_error if `data` is truncated or does not hold a
+    ///         well-formed recipe (see `sequence_recipe::well_formed`)
+    static sequence_recipe load(const void * data, std::size_t bytes)
+    {
+        auto ptr = static_cast<const unsigned char *>(data);
+        std::size_t offset = 0;
+        auto read_word = [&]()
+        {
+            if (HEDLEY_UNLIKELY(bytes - offset < sizeof(uint64_t)))
+            {
+                throw std::runtime_error("truncated sequence_recipe");
+            }
+            uint64_t word;
+            std::memcpy(&word, ptr + offset, sizeof(word));
+            offset += sizeof(word);
+            return word;
+        };
+
+        if (read_word() != magic)
+        {
+            throw std::runtime_error("not a sequence_recipe");
+        }
+        std::size_t num_steps = read_word(),
+            num_outputs = read_word(),
+            num_leaf_nodes = read_word(),
+            depth = read_word(),
+            lg_outputs_per_leaf = read_word();
+        // bound each count by the words left before combining them, so
+        // that no sum below can wrap
+        std::size_t words = (bytes - offset) / sizeof(uint64_t);
+        if (HEDLEY_UNLIKELY(depth >= words || num_outputs > words - (depth + 1)))
+        {
+            throw std::runtime_error("truncated sequence_recipe");
+        }
+        std::vector<std::size_t> level_endpoints(depth + 1), output_indices(num_outputs);
+        for (auto & endpoint : level_endpoints) endpoint = read_word();
+        for (auto & index : output_indices) index = read_word();
+        if (HEDLEY_UNLIKELY(bytes - offset < packed_size(num_steps)))
+        {
+            throw std::runtime_error("truncated sequence_recipe");
+        }
+        std::vector<uint8_t> packed(ptr + offset, ptr + offset + packed_size(num_steps));
+
+        sequence_recipe recipe{std::move(packed), num_steps,
+            std::move(output_indices), num_leaf_nodes, std::move(level_endpoints),
+            lg_outputs_per_leaf};
+        if (HEDLEY_UNLIKELY(!recipe.well_formed()))
+        {
+            throw std::runtime_error("malformed sequence_recipe");
+        }
+        return recipe;
+    }
+
+    /// @brief checks that every step uses a valid code, that each level
+    ///        has exactly one node per child of the level above it, and
+    ///        that the output indices cover exactly the leaves
+    /// @details The root level has one node, a `0` step has two children
+    ///          and a `-1` or `+1` step has one, and the children of the
+    ///          last level are the `num_leaf_nodes()` leaves. The output
+    ///          indices must be non-decreasing and name every leaf (or none,
+    ///          if the recipe is for an empty sequence), so that evaluation
+    ///          never reads past a buffer of `num_leaf_nodes()` leaves.
+    bool well_formed() const noexcept
+    {
+        if (lg_outputs_per_leaf_ >= std::numeric_limits<std::size_t>::digits)
+        {
+            return false;
+        }
+        if (level_endpoints_.empty() || level_endpoints_.front() != 0
+            || level_endpoints_.back() != num_steps_)
+        {
+            return false;
+        }
+        std::size_t nodes = 1;
+        for (std::size_t level = 0; level < depth(); ++level)
+        {
+            std::size_t begin = level_endpoints_[level], end = level_endpoints_[level+1];
+            if (end < begin || end - begin != nodes) return false;
+            nodes = 0;
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                auto code = (recipe_steps_[i / steps_per_byte] >> (2 * (i % steps_per_byte))) & 0x3;
+                if (code == 0b10) return false;  // not a step
+                nodes += (code == 0b00) ? 2 : 1;
+            }
+        }
+        if (nodes != num_leaf_nodes_) return false;
+
+        if (output_indices_.empty()) return num_leaf_nodes_ == 1;
+        std::size_t leaves = 0, prev = 0;
+        for (auto index : output_indices_)
+        {
+            // shifting first keeps the bound from overflowing
+            std::size_t leaf = index >> lg_outputs_per_leaf_;
+            if (index < prev || leaf >= num_leaf_nodes_) return false;
+            leaves += (leaves == 0 || leaf != (prev >> lg_outputs_per_leaf_));
+            prev = index;
+        }
+        return leaves == num_leaf_nodes_;
+    }
+
+    static constexpr std::size_t steps_per_byte = 4;
+
+    static constexpr std::size_t packed_size(std::size_t num_steps)
+    {
+        return num_steps / steps_per_byte + (num_steps % steps_per_byte != 0);
+    }
+
+    /// @brief stores `step` as step `i` of the zero-initialised `packed`
+    static void pack_step(std::vector<uint8_t> & packed, std::size_t i, int8_t step)  // NOLINT(runtime/references)
+    {
+        packed[i / steps_per_byte] |= (step & 0x3) << (2 * (i % steps_per_byte));
+    }
+
+    /// @brief packs `-1`/`0`/`+1` steps four to a byte
+    static std::vector<uint8_t> pack(const std::vector<int8_t> & steps)
+    {
+        std::vector<uint8_t> packed(packed_size(steps.size()), 0);
+        for (std::size_t i = 0; i < steps.size(); ++i) pack_step(packed, i, steps[i]);
+        return packed;
+    }
 
   private:
-    std::vector<int8_t> recipe_steps_;
+    static constexpr uint64_t magic = 0x0250434552465044;  // "DPFRECP\x02"
+
+    static void write_word(std::ostream & os, uint64_t word)  // NOLINT(runtime/references)
+    {
+        os.write(reinterpret_cast<const char *>(&word), sizeof(word));
+    }
+
+    std::vector<uint8_t> recipe_steps_;
+    std::size_t num_steps_;
     std::vector<std::size_t> output_indices_;
     std::size_t num_leaf_nodes_;
     std::vector<std::size_t> level_endpoints_;  // level_endpoints.size() = depth+1
+    std::size_t lg_outputs_per_leaf_;
 };
 
 namespace detail
 {
 
+/// @brief emits the recipe steps for levels `[from, to)` of the nodes that
+///        contain the points `[first, last)`, where `first` begins a node at
+///        level `from`
+/// @details `split[i]` is the level at which the paths to points `i-1` and
+///          `i` diverge (clamped to `depth`). A node at level `L` needs both
+///          children exactly when it contains an `i` with `split[i] == L`,
+///          and that `i` is where its right child begins. Bucketing the
+///          `i`s by `split[i]` therefore lets each level be produced by
+///          merging the node boundaries of the previous level with one
+///          bucket, in time linear in the number of nodes.
+template <typename GoesRight>
+void make_sequence_recipe_levels(const std::vector<uint8_t> & split,
+    std::size_t first, std::size_t last, std::size_t from, std::size_t to,
+    GoesRight && goes_right, std::vector<std::vector<int8_t>> & steps)  // NOLINT(runtime/references)
+{
+    std::vector<std::size_t> starts{first}, next;
+    std::vector<std::size_t> bucket_begin(to - from + 1, 0), buckets;
+    for (std::size_t i = first + 1; i < last; ++i)
+    {
+        if (split[i] < from) starts.push_back(i);
+        else if (split[i] < to) ++bucket_begin[split[i] - from + 1];
+    }
+    std::partial_sum(std::begin(bucket_begin), std::end(bucket_begin),
+        std::begin(bucket_begin));
+    buckets.resize(bucket_begin.back());
+    {
+        auto fill = bucket_begin;
+        for (std::size_t i = first + 1; i < last; ++i)
+        {
+            if (from <= split[i] && split[i] < to) buckets[fill[split[i] - from]++] = i;
+        }
+    }
+
+    for (std::size_t level = from; level < to; ++level)
+    {
+        auto & out = steps[level];
+        const std::size_t * bucket = buckets.data() + bucket_begin[level - from],
+            * bucket_end = buckets.data() + bucket_begin[level - from + 1];
+        next.clear();
+        for (std::size_t k = 0; k < starts.size(); ++k)
+        {
+            std::size_t upper = (k + 1 < starts.size()) ? starts[k+1] : last;
+            next.push_back(starts[k]);
+            if (bucket != bucket_end && *bucket < upper)
+            {
+                out.push_back(0);  // both ways
+                next.push_back(*bucket++);
+            }
+            else
+            {
+                out.push_back(goes_right(starts[k], level) ? -1 : +1);
+            }
+        }
+        std::swap(starts, next);
+    }
+}
+
 template <typename DpfKey,
           typename ForwardIterator>
-auto make_sequence_recipe(ForwardIterator begin, ForwardIterator end)
+auto make_sequence_recipe(ForwardIterator begin, ForwardIterator end,
+    std::size_t threads = 1)
 {
     static_assert(std::is_same_v<typename DpfKey::input_type, std::decay_t<decltype(*begin)>>);
 
     using dpf_type = DpfKey;
     using input_type = typename DpfKey::input_type;
+    constexpr std::size_t depth = dpf_type::depth;
+    constexpr auto clz = utils::countl_zero_symmetric_difference<input_type>{};
+    constexpr auto mod = utils::mod_pow_2<input_type>{};
+    constexpr bool random_access = std::is_base_of_v<std::random_access_iterator_tag,
+        typename std::iterator_traits<ForwardIterator>::iterator_category>;
 
     if (!std::is_sorted(begin, end))
     {
         throw std::runtime_error("list must be sorted");
     }
 
-    auto mask = dpf_type::msb_mask;
-
-    std::list<ForwardIterator> splits{begin, end};
+    // one linear pass over adjacent pairs finds where each pair of
+    // neighbouring paths diverges
+    std::size_t n = std::distance(begin, end);
+    std::vector<uint8_t> split(n, 0);
+    std::vector<ForwardIterator> iters;
+    if constexpr (!random_access) iters.reserve(n);
+    std::vector<std::size_t> output_indices;
+    output_indices.reserve(n);
+    std::size_t leaf_index = 0;
+    std::size_t i = 0;
+    for (auto curr = begin, prev = curr; curr != end; prev = curr++, ++i)
+    {
+        split[i] = static_cast<uint8_t>(std::min(clz(*prev, *curr), depth));
+        leaf_index += split[i] < depth;
+        output_indices.push_back(leaf_index * dpf_type::outputs_per_leaf + mod(*curr, dpf_type::lg_outputs_per_leaf));
+        if constexpr (!random_access) iters.push_back(curr);
+    }
 
-    std::vector<std::size_t> level_endpoints;
-    level_endpoints.push_back(0);
-    std::vector<int8_t> recipe_steps;
+    auto goes_right = [&begin, &iters](std::size_t index, std::size_t level)
+    {
+        auto mask = dpf_type::msb_mask >> level;
+        bool flip = (level == 0) && utils::is_signed_integral_v<input_type>;
+        if constexpr (random_access)
+        {
+            return static_cast<bool>(mask & begin[index]) ^ flip;
+        }
+        else
+        {
+            return static_cast<bool>(mask & *iters[index]) ^ flip;
+        }
+    };
 
-    auto func = [&](const bool flip = false)
+    std::vector<std::vector<int8_t>> steps(depth);
+    // the top levels are built serially until there are enough nodes to
+    // hand out; every deeper node then lies entirely within one chunk
+    std::size_t top = 0;
+    std::vector<std::size_t> chunk_starts{0};
+    if (threads > 1 && n > 1)
     {
-        // `lower` and `upper` are always adjacent elements of `splits` with `lower` < `upper`
-        // [lower, upper) = "block"
-        for (auto upper = std::begin(splits), lower = upper++; upper != std::end(splits); lower = upper++)
+        std::vector<std::size_t> diverging(depth + 1, 0);
+        for (std::size_t j = 1; j < n; ++j) ++diverging[split[j]];
+        for (std::size_t nodes = 1; top < depth && nodes < threads; )
         {
-            // `upper_bound()` returns iterator to first element where the relevant bit (based on `mask`) is set
-            auto it = std::upper_bound(*lower, *upper, mask,
-                [&flip](auto a, auto b){ return static_cast<bool>(a&b) ^ flip; });
-            if (it == *lower) recipe_steps.push_back(-1);       // right only since first element in "block" requires right traversal
-            else if (it == *upper) recipe_steps.push_back(+1);  // left only since no element in "block" requires right traversal
-            else
+            nodes += diverging[top++];
+        }
+        std::size_t target = (n + threads - 1) / threads;
+        for (std::size_t j = 1; j < n; ++j)
+        {
+            if (split[j] < top && j - chunk_starts.back() >= target)
             {
-                recipe_steps.push_back(0);                      // both ways since some (non-lower) element within "block" requires right traversal
-                splits.insert(upper, it);
+                chunk_starts.push_back(j);
             }
         }
-        level_endpoints.push_back(recipe_steps.size());
-    };
-    if (dpf_type::depth > 0)
+    }
+    chunk_starts.push_back(n);
+
+    if (n == 0)
     {
-        func(utils::is_signed_integral_v<input_type>);
-        mask >>= 1;
+        // an empty "block" has always been recorded as right-only
+        for (auto & level : steps) level.push_back(-1);
     }
-    for (std::size_t level_index = 1; level_index < dpf_type::depth; ++level_index, mask>>=1)
+    else if (chunk_starts.size() <= 2)
     {
-        func();
+        make_sequence_recipe_levels(split, 0, n, 0, depth, goes_right, steps);
     }
+    else
+    {
+        make_sequence_recipe_levels(split, 0, n, 0, top, goes_right, steps);
 
-    std::vector<std::size_t> output_indices;
-    // output_indices.push_back(*begin % outputs_per_leaf);
-    std::size_t leaf_index = 0;  // *begin/outputs_per_leaf < *(begin+1)/outs_per_leaf;
-    constexpr auto mod = utils::mod_pow_2<input_type>{};
-    constexpr auto clz = utils::countl_zero_symmetric_difference<input_type>{};
-    for (auto curr = begin, prev = curr; curr != end; prev = curr++)
+        std::size_t chunks = chunk_starts.size() - 1;
+        std::vector<std::vector<std::vector<int8_t>>> chunk_steps(chunks,
+            std::vector<std::vector<int8_t>>(depth));
+        std::vector<std::exception_ptr> errors(chunks);
+        auto task = [&](std::size_t c)
+        {
+            try
+            {
+                make_sequence_recipe_levels(split, chunk_starts[c],
+                    chunk_starts[c+1], top, depth, goes_right, chunk_steps[c]);
+            }
+            catch (...)
+            {
+                errors[c] = std::current_exception();
+            }
+        };
+        std::vector<std::thread> pool;
+        std::size_t started = 1;
+        try
+        {
+            pool.reserve(chunks - 1);
+            for (; started < chunks; ++started) pool.emplace_back(task, started);
+        }
+        catch (...)
+        {
+            // build whatever could not be handed off on this thread
+        }
+        task(0);
+        for (std::size_t c = started; c < chunks; ++c) task(c);
+        for (auto & thread : pool) thread.join();
+        for (auto & error : errors)
+        {
+            if (error) std::rethrow_exception(error);
+        }
+        for (std::size_t level = top; level < depth; ++level)
+        {
+            for (auto & chunk : chunk_steps)
+            {
+                steps[level].insert(std::end(steps[level]),
+                    std::begin(chunk[level]), std::end(chunk[level]));
+            }
+        }
+    }
+
+    std::vector<std::size_t> level_endpoints{0};
+    for (auto & level : steps)
     {
-        leaf_index += (clz(*prev, *curr)) < dpf_type::depth;
-        output_indices.push_back(leaf_index * dpf_type::outputs_per_leaf + mod(*curr, dpf_type::lg_outputs_per_leaf));
+        level_endpoints.push_back(level_endpoints.back() + level.size());
+    }
+    std::vector<uint8_t> packed(sequence_recipe::packed_size(level_endpoints.back()), 0);
+    for (std::size_t level = 0, r = 0; level < depth; ++level)
+    {
+        for (auto step : steps[level]) sequence_recipe::pack_step(packed, r++, step);
+        std::vector<int8_t>().swap(steps[level]);
     }
 
-    return sequence_recipe{recipe_steps, output_indices, leaf_index+1, level_endpoints};
+    return sequence_recipe{std::move(packed), level_endpoints.back(),
+        std::move(output_indices), leaf_index+1, std::move(level_endpoints),
+        dpf_type::lg_outputs_per_leaf};
 }
 
 }  // namespace detail
 
+/// @brief builds the recipe for evaluating a DPF at the sorted points
+///        `[begin, end)`
+/// @param threads if greater than `1`, the lower levels of the recipe are
+///        built concurrently over that many chunks of the points
 template <typename DpfKey,
           typename ForwardIterator>
-auto make_sequence_recipe(ForwardIterator begin, ForwardIterator end)
+auto make_sequence_recipe(ForwardIterator begin, ForwardIterator end,
+    std::size_t threads = 1)
 {
-    return detail::make_sequence_recipe<DpfKey>(begin, end);
+    return detail::make_sequence_recipe<DpfKey>(begin, end, threads);
 }
 
 template <typename DpfKey,
           typename ForwardIterator>
-auto make_sequence_recipe(const DpfKey &, ForwardIterator begin, ForwardIterator end)
+auto make_sequence_recipe(const DpfKey &, ForwardIterator begin, ForwardIterator end,
+    std::size_t threads = 1)
+{
+    return make_sequence_recipe<DpfKey>(begin, end, threads);
+}
+
+/// @brief the part of a `dpf::sequence_recipe` below one node; see
+///        `dpf::split_sequence_recipe`
+struct sequence_subrecipe
+{
+    sequence_recipe recipe;
+    std::size_t first_leaf;    // index in the full recipe of `recipe`'s first leaf
+    std::size_t first_output;  // index in the full recipe of `recipe`'s first output
+};
+
+/// @brief cuts `recipe` at `level` into one independent recipe per node on
+///        that level
+/// @details The `s`th sub-recipe covers the subtree below the `s`th node on
+///          `level`. Above `level`, its steps are the single-direction path
+///          from the root down to that node, so it is a complete recipe of
+///          the same depth and can be evaluated on its own with any
+///          sequence memoizer. Its leaves and outputs are the consecutive
+///          leaves and outputs of `recipe` starting at `first_leaf` and
+///          `first_output`.
+/// @throws std::invalid_argument if `level` exceeds the depth of `recipe`
+template <typename DpfKey>
+std::vector<sequence_subrecipe> split_sequence_recipe(const sequence_recipe & recipe,
+    std::size_t level)
 {
-    return make_sequence_recipe<DpfKey>(begin, end);
+    using dpf_type = DpfKey;
+    const auto & level_endpoints = recipe.level_endpoints();
+    const std::size_t depth = recipe.depth();
+
+    if (level > depth)
+    {
+        throw std::invalid_argument("level exceeds the depth of the recipe");
+    }
+
+    // the path from the root to each node, one level at a time
+    std::vector<std::vector<int8_t>> paths(1), children;
+    for (std::size_t l = 0; l < level; ++l)
+    {
+        children.clear();
+        for (std::size_t k = 0; k < paths.size(); ++k)
+        {
+            int8_t step = recipe.step(level_endpoints[l] + k);
+            if (step >= 0)
+            {
+                children.push_back(paths[k]);
+                children.back().push_back(+1);  // left only
+            }
+            if (step <= 0)
+            {
+                children.push_back(paths[k]);
+                children.back().push_back(-1);  // right only
+            }
+        }
+        std::swap(paths, children);
+    }
+
+    const std::size_t roots = paths.size();
+    std::vector<std::vector<int8_t>> steps(std::move(paths));
+    std::vector<std::vector<std::size_t>> endpoints(roots);
+    std::vector<std::size_t> lo(roots), hi(roots), first_child;
+    for (std::size_t s = 0; s < roots; ++s)
+    {
+        for (std::size_t l = 0; l <= level; ++l) endpoints[s].push_back(l);
+        lo[s] = s;
+        hi[s] = s + 1;
+    }
+
+    for (std::size_t l = level; l < depth; ++l)
+    {
+        // first_child[k] is the index on level l+1 of the first child of
+        // the kth node on level l
+        std::size_t nodes = level_endpoints[l+1] - level_endpoints[l];
+        first_child.assign(nodes + 1, 0);
+        for (std::size_t k = 0; k < nodes; ++k)
+        {
+            first_child[k+1] = first_child[k] + (recipe.step(level_endpoints[l] + k) == 0 ? 2 : 1);
+        }
+        for (std::size_t s = 0; s < roots; ++s)
+        {
+            for (std::size_t k = lo[s]; k < hi[s]; ++k)
+            {
+                steps[s].push_back(recipe.step(level_endpoints[l] + k));
+            }
+            endpoints[s].push_back(steps[s].size());
+            lo[s] = first_child[lo[s]];
+            hi[s] = first_child[hi[s]];
+        }
+    }
+
+    const auto & output_indices = recipe.output_indices();
+    std::vector<sequence_subrecipe> subrecipes;
+    subrecipes.reserve(roots);
+    for (std::size_t s = 0; s < roots; ++s)
+    {
+        std::size_t base = lo[s] * dpf_type::outputs_per_leaf;
+        auto first = std::lower_bound(std::begin(output_indices), std::end(output_indices), base),
+            last = std::lower_bound(first, std::end(output_indices), hi[s] * dpf_type::outputs_per_leaf);
+        std::vector<std::size_t> outputs(first, last);
+        for (auto & index : outputs) index -= base;
+
+        subrecipes.push_back(sequence_subrecipe{
+            sequence_recipe{steps[s], outputs, hi[s] - lo[s], endpoints[s],
+                recipe.lg_outputs_per_leaf()},
+            lo[s],
+            static_cast<std::size_t>(std::distance(std::begin(output_indices), first))});
+    }
+    return subrecipes;
 }
 
 }  // namespace dpf
@@ -0,0 +1,168 @@
+/// @file dpf/sequence_recipe_cache.hpp
+/// @brief process-wide cache of `dpf::sequence_recipe`s
+/// @details A server that evaluates many keys on one fixed set of points
+///          needs only one recipe for all of them. The cache is keyed by a
+///          SHA-256 digest of the points together with the shape of the DPF
+///          (depth, outputs per leaf, and signedness of the input type), so
+///          that each recipe is built once, by whichever thread asks first,
+///          and then shared read-only. Threads that ask for a recipe while
+///          it is still being built wait for it rather than building their
+///          own copy.
+/// @author Ryan Henry <ryan.henry@ucalgary.ca>
+/// @copyright Copyright (c) 2019-2024 Ryan Henry and [others](@ref authors)
+/// @license Released under a GNU General Public v2.0 (GPLv2) license;
+///          see [LICENSE.md](@ref license) for details.
+
+#ifndef LIBDPF_INCLUDE_DPF_SEQUENCE_RECIPE_CACHE_HPP__
+#define LIBDPF_INCLUDE_DPF_SEQUENCE_RECIPE_CACHE_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "dpf/utils.hpp"
+#include "dpf/sequence_recipe.hpp"
+
+namespace dpf
+{
+
+/// @brief a thread-safe map from point sets to shared recipes
+class sequence_recipe_cache final
+{
+  public:
+    using recipe_ptr = std::shared_ptr<const sequence_recipe>;
+
+    sequence_recipe_cache() = default;
+    sequence_recipe_cache(const sequence_recipe_cache &) = delete;
+    sequence_recipe_cache & operator=(const sequence_recipe_cache &) = delete;
+
+    /// @brief the cache shared by the whole process
+    static sequence_recipe_cache & global()
+    {
+        static sequence_recipe_cache cache;
+        return cache;
+    }
+
+    /// @brief returns the recipe for the sorted points `[begin, end)`,
+    ///        building it (with `threads` threads) if it is not yet cached
+    /// @throws std::runtime_error if the points are not sorted, in which
+    ///         case nothing is cached
+    template <typename DpfKey,
+              typename ForwardIterator>
+    recipe_ptr get(ForwardIterator begin, ForwardIterator end,
+        std::size_t threads = 1)
+    {
+        auto key = digest<DpfKey>(begin, end);
+
+        std::promise<recipe_ptr> promise;
+        std::shared_future<recipe_ptr> future;
+        bool inserted;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = recipes_.find(key);
+            inserted = (it == std::end(recipes_));
+            if (inserted)
+            {
+                it = recipes_.emplace(key, promise.get_future().share()).first;
+            }
+            future = it->second;
+        }
+
+        if (inserted)
+        {
+            try
+            {
+                promise.set_value(std::make_shared<const sequence_recipe>(
+                    make_sequence_recipe<DpfKey>(begin, end, threads)));
+            }
+            catch (...)
+            {
+                // let a later call try again, but fail everyone waiting now
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    recipes_.erase(key);
+                }
+                promise.set_exception(std::current_exception());
+            }
+        }
+        return future.get();
+    }
+
+    template <typename DpfKey,
+              typename ForwardIterator>
+    recipe_ptr get(const DpfKey &, ForwardIterator begin, ForwardIterator end,
+        std::size_t threads = 1)
+    {
+        return get<DpfKey>(begin, end, threads);
+    }
+
+    /// @brief the number of cached (or in-progress) recipes
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return recipes_.size();
+    }
+
+    /// @brief drops every cached recipe; recipes still held by callers stay
+    ///        alive until released
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        recipes_.clear();
+    }
+
+    /// @brief the cache key for the points `[begin, end)`
+    template <typename DpfKey,
+              typename ForwardIterator>
+    static digest_type digest(ForwardIterator begin, ForwardIterator end)
+    {
+        using input_type = typename DpfKey::input_type;
+        constexpr auto to_int = utils::to_integral_type<input_type>{};
+        const uint64_t shape[] = {
+            DpfKey::depth,
+            DpfKey::lg_outputs_per_leaf,
+            utils::is_signed_integral_v<input_type>
+        };
+
+        SHA256 h;
+        h.add(shape, sizeof(shape));
+        for (auto it = begin; it != end; ++it)
+        {
+            auto x = to_int(*it);
+            h.add(&x, sizeof(x));
+        }
+        digest_type digest;
+        h.getHash(digest.data());
+        return digest;
+    }
+
+  private:
+    mutable std::mutex mutex_;
+    std::map<digest_type, std::shared_future<recipe_ptr>> recipes_;
+};
+
+/// @brief returns the recipe for the sorted points `[begin, end)` from
+///        `dpf::sequence_recipe_cache::global()`
+template <typename DpfKey,
+          typename ForwardIterator>
+auto cached_sequence_recipe(ForwardIterator begin, ForwardIterator end,
+    std::size_t threads = 1)
+{
+    return sequence_recipe_cache::global().get<DpfKey>(begin, end, threads);
+}
+
+template <typename DpfKey,
+          typename ForwardIterator>
+auto cached_sequence_recipe(const DpfKey &, ForwardIterator begin,
+    ForwardIterator end, std::size_t threads = 1)
+{
+    return cached_sequence_recipe<DpfKey>(begin, end, threads);
+}
+
+}  // namespace dpf
+
+#endif  // LIBDPF_INCLUDE_DPF_SEQUENCE_RECIPE_CACHE_HPP__
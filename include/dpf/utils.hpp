@@ -20,6 +20,9 @@
 #include <functional>
 #include <bitset>
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
 
 #include "hedley/hedley.h"
 #include "simde/simde/x86/avx2.h"
@@ -467,6 +470,35 @@ static constexpr std::size_t get_leafnodes_in_output_interval(InputT from, Input
         get_to_node<DpfKey, InputT, IntegralT>(to));
 }
 
+/// @brief the base-2 logarithm of the number of outputs in the full domain
+///        of `DpfKey`
+template <typename DpfKey>
+static constexpr std::size_t lg_domain_size_v = DpfKey::depth + DpfKey::lg_outputs_per_leaf;
+
+/// @brief `true` iff `n` exceeds the number of outputs in the full domain of
+///        `DpfKey`
+/// @details Safe for domains of `2^64` or more outputs, which no `std::size_t`
+///          can exceed.
+template <typename DpfKey>
+static constexpr bool exceeds_domain_size(std::size_t n)
+{
+    constexpr std::size_t lg_domain = lg_domain_size_v<DpfKey>;
+    if constexpr (lg_domain >= bitlength_of_v<std::size_t>) return false;
+    else return n > (std::size_t(1) << lg_domain);
+}
+
+/// @brief `true` iff `n` is less than the number of outputs in the full
+///        domain of `DpfKey`
+/// @details Safe for domains of `2^64` or more outputs, which every
+///          `std::size_t` falls short of.
+template <typename DpfKey>
+static constexpr bool is_below_domain_size(std::size_t n)
+{
+    constexpr std::size_t lg_domain = lg_domain_size_v<DpfKey>;
+    if constexpr (lg_domain >= bitlength_of_v<std::size_t>) return true;
+    else return n < (std::size_t(1) << lg_domain);
+}
+
 template <typename T>
 struct mod_pow_2
 {
@@ -756,10 +788,94 @@ auto get_common_part_hash(const DpfKey & dpf)
 {
     return get_common_part_hash(dpf.correction_words(),
                                 dpf.correction_advice(),
-                                dpf.leaves(),
+                                dpf.leaf_nodes,
                                 dpf.wildcard_mask);
 }
 
+/// @brief hashes only the parts of a key that determine its interior nodes
+/// @details Unlike `get_common_part_hash`, the leaves are left out, so keys
+///          that differ only in their leaves (or in the wildcard outputs
+///          assigned to them) hash the same; memoized interior nodes can be
+///          reused across such keys.
+template <typename InteriorNodeT,
+          std::size_t Depth>
+auto get_interior_hash(const std::array<InteriorNodeT, Depth> & correction_words,
+                       const std::array<psnip_uint8_t, Depth> & correction_advice)
+{
+    SHA256 h;
+    digest_type digest;
+
+    h.add(&correction_words, sizeof(correction_words));
+    h.add(&correction_advice, sizeof(correction_advice));
+
+    h.getHash(digest.data());
+    return digest;
+}
+
+template <typename DpfKey>
+auto get_interior_hash(const DpfKey & dpf)
+{
+    return get_interior_hash(dpf.correction_words(),
+                             dpf.correction_advice());
+}
+
+/// @brief a digest that is computed on first use and cached
+/// @details Lets keys be constructed (e.g., read off the network in bulk)
+///          without hashing; only keys that reach a memoizer pay for it.
+///          Safe to `get` from several threads at once: one computes the
+///          digest while the others wait for it.
+template <typename DigestT = digest_type>
+class lazy_digest
+{
+  public:
+    lazy_digest() = default;
+    lazy_digest(lazy_digest && other) noexcept
+      : digest_{other.digest_}
+    {
+        state_.store(other.state_.load(std::memory_order_acquire) == ready
+            ? ready : empty, std::memory_order_relaxed);
+    }
+    lazy_digest & operator=(lazy_digest && other) noexcept
+    {
+        digest_ = other.digest_;
+        state_.store(other.state_.load(std::memory_order_acquire) == ready
+            ? ready : empty, std::memory_order_release);
+        return *this;
+    }
+
+    /// @brief returns the digest, calling `compute()` to get it if this is
+    ///        the first use
+    template <typename Compute>
+    HEDLEY_ALWAYS_INLINE
+    const DigestT & get(Compute && compute) const
+    {
+        if (HEDLEY_UNLIKELY(state_.load(std::memory_order_acquire) != ready))
+        {
+            std::uint8_t expected = empty;
+            if (state_.compare_exchange_strong(expected, computing,
+                std::memory_order_acquire))
+            {
+                digest_ = compute();
+                state_.store(ready, std::memory_order_release);
+            }
+            else
+            {
+                while (state_.load(std::memory_order_acquire) != ready)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        return digest_;
+    }
+
+  private:
+    static constexpr std::uint8_t empty = 0, computing = 1, ready = 2;
+
+    mutable std::atomic_uint8_t state_{empty};
+    mutable DigestT digest_{};
+};
+
 template <typename OutputT, typename Enable = void>
 struct has_operators_plus_minus : public std::false_type { };
 
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "dpf.hpp"
+
+#include "helpers/eval_common_data.hpp"
+#include "helpers/assert_same_outputs.hpp"
+
+template <typename T>
+struct AccumulateFullTest : public testing::Test
+{
+  public:
+    using input_type = typename std::tuple_element_t<0, T>;
+    using output_type = typename std::tuple_element_t<1, T>;
+    using dpf_type = dpf::utils::dpf_type_t<dpf::prg::aes128, dpf::prg::aes128, input_type, output_type>;
+
+  protected:
+    AccumulateFullTest()
+      : params{std::get<std::vector<T>>(allParams)},
+        range{std::size_t(1) << dpf::utils::bitlength_of_v<input_type>},
+        expected(range, output_type{})
+    {
+        for (auto [x, y] : params)
+        {
+            auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+            dpfs.push_back(std::move(dpf0));
+            dpfs.push_back(std::move(dpf1));
+        }
+        for (auto & dpf : dpfs)
+        {
+            auto [buf, iter] = dpf::eval_full(dpf);
+            auto it = std::begin(buf);
+            for (std::size_t i = 0; i < range; ++i, ++it) expected[i] = add(expected[i], *it);
+        }
+    }
+
+    template <typename U, typename = void>
+    struct has_plus : std::false_type { };
+
+    template <typename U>
+    struct has_plus<U, std::void_t<decltype(std::declval<U>() + std::declval<U>())>>
+      : std::true_type { };
+
+    // the group operation that `dpf::add_leaf` applies to `output_type`
+    static output_type add(output_type a, output_type b)
+    {
+        if constexpr (std::is_same_v<output_type, dpf::bit>) return dpf::to_bit(a ^ b);
+        else if constexpr (has_plus<output_type>::value) return static_cast<output_type>(a + b);
+        else return a ^ b;
+    }
+
+    std::vector<T> params;
+    std::size_t range;
+    std::vector<dpf_type> dpfs;
+    std::vector<output_type> expected;
+};
+
+TYPED_TEST_SUITE_P(AccumulateFullTest);
+
+TYPED_TEST_P(AccumulateFullTest, MatchesSumOfEvalFull)
+{
+    using output_type = typename TestFixture::output_type;
+
+    for (std::size_t threads : { 1, 3 })
+    {
+        for (std::size_t lg_block : { 0, 3, 12 })
+        {
+            auto acc = dpf::accumulate_full(this->dpfs, threads, lg_block);
+            ASSERT_EQ(std::size(acc), this->range);
+            assert_same_outputs<output_type>(this->expected, acc, this->range);
+        }
+    }
+}
+
+TYPED_TEST_P(AccumulateFullTest, AddsToExistingContents)
+{
+    using output_type = typename TestFixture::output_type;
+    using dpf_type = typename TestFixture::dpf_type;
+    constexpr auto from_integral_type_output = dpf::utils::make_from_integral_value<output_type>{};
+
+    auto acc = dpf::make_output_buffer_for_full<dpf_type>();
+    std::vector<output_type> sum;
+    for (std::size_t i = 0; i < this->range; ++i)
+    {
+        output_type initial = from_integral_type_output(i * 7 + 1);
+        acc[i] = initial;
+        sum.push_back(this->add(initial, this->expected[i]));
+    }
+    dpf::accumulate_full(this->dpfs, acc, 4, 5);
+    assert_same_outputs<output_type>(sum, acc, this->range);
+}
+
+TYPED_TEST_P(AccumulateFullTest, ReconstructsHistogram)
+{
+    using input_type = typename TestFixture::input_type;
+    using output_type = typename TestFixture::output_type;
+    using dpf_type = typename TestFixture::dpf_type;
+
+    // each server sums its own shares; the difference of the two sums is,
+    // at each point, the sum of the outputs of the keys for that point
+    std::vector<dpf_type> shares0, shares1;
+    for (std::size_t k = 0; k < this->params.size(); ++k)
+    {
+        shares0.push_back(std::move(this->dpfs[2*k]));
+        shares1.push_back(std::move(this->dpfs[2*k+1]));
+    }
+    auto acc0 = dpf::accumulate_full(shares0, 2, 3);
+    auto acc1 = dpf::accumulate_full(shares1, 3, 3);
+
+    auto it0 = std::begin(acc0);
+    auto it1 = std::begin(acc1);
+    input_type cur = std::numeric_limits<input_type>::min();
+    for (std::size_t i = 0; i < this->range; ++i, ++cur, ++it0, ++it1)
+    {
+        output_type histogram{};
+        for (auto [x, y] : this->params)
+        {
+            if (cur == x) histogram = this->add(histogram, y);
+        }
+        ASSERT_EQ(static_cast<output_type>(*it1 - *it0), histogram);
+    }
+}
+
+TYPED_TEST_P(AccumulateFullTest, TooSmall)
+{
+    using output_type = typename TestFixture::output_type;
+
+    dpf::output_buffer<output_type> acc(this->range / 2);
+    ASSERT_THROW(dpf::accumulate_full(this->dpfs, acc), std::length_error);
+}
+
+REGISTER_TYPED_TEST_SUITE_P(AccumulateFullTest,
+    MatchesSumOfEvalFull,
+    AddsToExistingContents,
+    ReconstructsHistogram,
+    TooSmall);
+using Types = testing::Types
+<
+    // base test
+    test_type<uint16_t, uint64_t>,
+
+    // test input types
+    test_type<int16_t, uint64_t>,
+    test_type<uint8_t, uint64_t>,
+    test_type<dpf::bitstring<10>, uint64_t>,
+    test_type<dpf::keyword<3, dpf::alphabets::hex>, uint64_t>,
+    test_type<dpf::modint<10>, uint64_t>,
+    test_type<dpf::xor_wrapper<int16_t>, uint64_t>,
+    test_type<dpf::xor_wrapper<uint16_t>, uint64_t>,
+
+    // test output types
+    test_type<uint16_t, int64_t>,
+    test_type<uint16_t, uint8_t>,
+    test_type<uint16_t, simde_int128>,
+    test_type<uint16_t, simde_uint128>,
+    test_type<uint16_t, dpf::bit>,
+    test_type<uint16_t, dpf::bitstring<20, uint8_t>>,
+    test_type<uint16_t, dpf::bitstring<150>>,
+    test_type<uint16_t, dpf::xor_wrapper<int64_t>>,
+    test_type<uint16_t, dpf::xor_wrapper<uint64_t>>,
+
+    // custom types
+    test_type<custom_input_type, uint64_t>,
+    test_type<uint16_t, custom_output_type_small>,
+    test_type<uint16_t, custom_output_type_large_plus_minus>,
+    test_type<uint16_t, custom_output_type_large_xor>
+>;
+INSTANTIATE_TYPED_TEST_SUITE_P(AccumulateFullTestInstantiation, AccumulateFullTest, Types);
+
+TEST(AccumulateFullLargeDomainTest, TooSmall)
+{
+    // the domain of a 64-bit input has more outputs than any std::size_t
+    // can count, so no accumulator is large enough
+    auto [dpf0, dpf1] = dpf::make_dpf(uint64_t(777), uint64_t(1));
+    dpf::output_buffer<uint64_t> acc(1 << 10);
+    ASSERT_THROW(dpf::accumulate_full(&dpf0, 1, acc), std::length_error);
+
+    auto [dpf2, dpf3] = dpf::make_dpf(uint64_t(777), dpf::bit::one);
+    dpf::output_buffer<dpf::bit> bits(1 << 10);
+    ASSERT_THROW(dpf::accumulate_full(&dpf2, 1, bits), std::length_error);
+}
@@ -2,13 +2,30 @@
 
 int main()
 {
+    system("./bin/prg_test");
+    system("./bin/prg_no_aesni_test");
+    system("./bin/random_test");
     system("./bin/dpf_key_test");
+    system("./bin/lazy_digest_test");
+    system("./bin/make_dpfs_test");
+    system("./bin/make_dpf_parallel_test");
+    system("./bin/dpf_key_batch_test");
+    system("./bin/half_tree_dpf_key_test");
     system("./bin/wildcard_test");
 
     system("./bin/eval_point_test");
+    system("./bin/eval_points_test");
     system("./bin/eval_interval_test");
     system("./bin/eval_full_test");
+    system("./bin/eval_full_depth_first_test");
+    system("./bin/eval_full_chunks_test");
+    system("./bin/eval_full_dot_test");
+    system("./bin/eval_full_batch_test");
+    system("./bin/accumulate_full_test");
     system("./bin/eval_sequence_test");
+    system("./bin/sequence_recipe_test");
+    system("./bin/eval_subtree_test");
+    system("./bin/eval_parallel_test");
 
     system("./bin/eval_point_multi_test");
     system("./bin/eval_interval_multi_test");
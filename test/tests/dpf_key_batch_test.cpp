@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include "dpf.hpp"
+
+#include "helpers/eval_common_data.hpp"
+#include "helpers/assert_same_outputs.hpp"
+
+template <typename T>
+struct DpfKeyBatchTest : public testing::Test
+{
+  public:
+    using input_type = typename std::tuple_element_t<0, T>;
+    using output_type = typename std::tuple_element_t<1, T>;
+    using dpf_type = dpf::utils::dpf_type_t<dpf::prg::aes128, dpf::prg::aes128, input_type, output_type>;
+
+  protected:
+    DpfKeyBatchTest()
+      : params{std::get<std::vector<T>>(allParams)}
+    {
+        for (auto [x, y] : params)
+        {
+            auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+            dpfs.push_back(std::move(dpf0));
+            dpfs.push_back(std::move(dpf1));
+        }
+    }
+
+    std::vector<T> params;
+    std::vector<dpf_type> dpfs;
+};
+
+TYPED_TEST_SUITE_P(DpfKeyBatchTest);
+
+TYPED_TEST_P(DpfKeyBatchTest, StoresKeysColumnWise)
+{
+    auto batch = dpf::make_dpf_key_batch(this->dpfs);
+    ASSERT_EQ(std::size(batch), std::size(this->dpfs));
+
+    for (std::size_t k = 0; k < std::size(this->dpfs); ++k)
+    {
+        const auto & dpf = this->dpfs[k];
+        auto view = batch[k];
+        ASSERT_EQ(std::memcmp(&batch.roots()[k], &dpf.root(), sizeof(dpf.root())), 0);
+        for (std::size_t level = 0; level < TestFixture::dpf_type::depth; ++level)
+        {
+            ASSERT_EQ(std::memcmp(&batch.correction_words(level)[k],
+                &dpf.correction_word(level), sizeof(dpf.root())), 0);
+            ASSERT_EQ(batch.correction_advice(level)[k], dpf.correction_advice(level));
+        }
+        ASSERT_EQ(view.interior_hash(), dpf.interior_hash());
+        ASSERT_EQ(view.common_part_hash(), dpf.common_part_hash());
+    }
+    ASSERT_THROW(batch.at(std::size(batch)), std::out_of_range);
+}
+
+TYPED_TEST_P(DpfKeyBatchTest, EmplaceBack)
+{
+    using output_type = typename TestFixture::output_type;
+    using dpf_type = typename TestFixture::dpf_type;
+
+    dpf::dpf_key_batch<dpf_type> batch;
+    auto [x, y] = this->params.front();
+    auto [correction_words, correction_advice, priv0, priv1]
+        = dpf::detail::make_dpf_impl<dpf::prg::aes128, dpf::prg::aes128>(
+            dpf::make_dpfargs(x, y));
+    auto & [root0, leaves0, beavers0, offset0] = priv0;
+    dpf_type::emplace_back(batch, root0, correction_words, correction_advice,
+        leaves0, beavers0, offset0);
+    dpf_type key(root0, correction_words, correction_advice, leaves0, beavers0, offset0);
+
+    ASSERT_EQ(std::size(batch), 1);
+    ASSERT_EQ(batch[0].common_part_hash(), key.common_part_hash());
+    assert_same_output<output_type>(dpf::eval_point(batch[0], x), dpf::eval_point(key, x));
+}
+
+TYPED_TEST_P(DpfKeyBatchTest, EvalPoint)
+{
+    using input_type = typename TestFixture::input_type;
+    using output_type = typename TestFixture::output_type;
+
+    auto batch = dpf::make_dpf_key_batch(this->dpfs);
+    auto memoizer = dpf::make_basic_path_memoizer(batch[0]);
+    for (std::size_t k = 0; k < std::size(this->dpfs); ++k)
+    {
+        auto view = batch[k];
+        input_type x = std::get<0>(this->params[k/2]), other = x;
+        ++other;
+        assert_same_output<output_type>(dpf::eval_point(view, x), dpf::eval_point(this->dpfs[k], x));
+        assert_same_output<output_type>(dpf::eval_point(view, other), dpf::eval_point(this->dpfs[k], other));
+        assert_same_output<output_type>(dpf::eval_point(view, x, memoizer), dpf::eval_point(this->dpfs[k], x));
+    }
+}
+
+TYPED_TEST_P(DpfKeyBatchTest, EvalFullAndBatch)
+{
+    using output_type = typename TestFixture::output_type;
+
+    auto batch = dpf::make_dpf_key_batch(this->dpfs);
+    auto views = batch.views();
+    auto outbufs = dpf::eval_full_batch(views);
+    auto acc = dpf::accumulate_full(views);
+    auto expected_acc = dpf::accumulate_full(this->dpfs);
+    for (std::size_t k = 0; k < std::size(views); ++k)
+    {
+        auto [expected, iter0] = dpf::eval_full(this->dpfs[k]);
+        auto [actual, iter1] = dpf::eval_full(views[k]);
+        assert_same_outputs<output_type>(expected, actual, std::size(expected));
+        assert_same_outputs<output_type>(expected, outbufs[k], std::size(expected));
+    }
+    assert_same_outputs<output_type>(expected_acc, acc, std::size(acc));
+
+    // views out of batch order cannot be read column-wise; they must still
+    // give the same outputs
+    std::vector<typename decltype(views)::value_type> reversed(std::rbegin(views), std::rend(views));
+    auto reversed_outbufs = dpf::eval_full_batch(reversed);
+    for (std::size_t k = 0; k < std::size(views); ++k)
+    {
+        assert_same_outputs<output_type>(outbufs[k],
+            reversed_outbufs[std::size(views) - 1 - k], std::size(outbufs[k]));
+    }
+}
+
+REGISTER_TYPED_TEST_SUITE_P(DpfKeyBatchTest,
+    StoresKeysColumnWise,
+    EmplaceBack,
+    EvalPoint,
+    EvalFullAndBatch);
+
+using Types = testing::Types
+<
+    // base test
+    test_type<uint16_t, uint64_t>,
+
+    // test input types
+    test_type<int16_t, uint64_t>,
+    test_type<uint8_t, uint64_t>,
+    test_type<dpf::bitstring<10>, uint64_t>,
+    test_type<dpf::keyword<3, dpf::alphabets::hex>, uint64_t>,
+    test_type<dpf::modint<10>, uint64_t>,
+    test_type<dpf::xor_wrapper<int16_t>, uint64_t>,
+    test_type<dpf::xor_wrapper<uint16_t>, uint64_t>,
+
+    // test output types
+    test_type<uint16_t, int64_t>,
+    test_type<uint16_t, uint8_t>,
+    test_type<uint16_t, simde_int128>,
+    test_type<uint16_t, simde_uint128>,
+    test_type<uint16_t, dpf::bit>,
+    test_type<uint16_t, dpf::bitstring<20, uint8_t>>,
+    test_type<uint16_t, dpf::bitstring<150>>,
+    test_type<uint16_t, dpf::xor_wrapper<int64_t>>,
+    test_type<uint16_t, dpf::xor_wrapper<uint64_t>>,
+
+    // custom types
+    test_type<custom_input_type, uint64_t>,
+    test_type<uint16_t, custom_output_type_small>,
+    test_type<uint16_t, custom_output_type_large_plus_minus>,
+    test_type<uint16_t, custom_output_type_large_xor>
+>;
+INSTANTIATE_TYPED_TEST_SUITE_P(DpfKeyBatchTestInstantiation, DpfKeyBatchTest, Types);
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "dpf.hpp"
+
+#include "helpers/eval_common_data.hpp"
+#include "helpers/assert_same_outputs.hpp"
+
+template <typename T>
+struct EvalFullBatchTest : public testing::Test
+{
+  public:
+    using input_type = typename std::tuple_element_t<0, T>;
+    using output_type = typename std::tuple_element_t<1, T>;
+    using dpf_type = dpf::utils::dpf_type_t<dpf::prg::aes128, dpf::prg::aes128, input_type, output_type>;
+
+  protected:
+    EvalFullBatchTest()
+      : range{std::size_t(1) << dpf::utils::bitlength_of_v<input_type>}
+    {
+        for (auto [x, y] : std::get<std::vector<T>>(allParams))
+        {
+            auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+            dpfs.push_back(std::move(dpf0));
+            dpfs.push_back(std::move(dpf1));
+        }
+        for (std::size_t i = 0; i < range; ++i)
+        {
+            database.push_back(uint64_t(i) * 0x9E3779B97F4A7C15 + 1);
+        }
+    }
+
+    // `eval_full_dot` multiplies outputs by `uint64_t` records
+    static constexpr bool has_dot = std::is_integral_v<output_type>
+        || std::is_same_v<output_type, dpf::bit>;
+
+    std::size_t range;
+    std::vector<dpf_type> dpfs;
+    std::vector<uint64_t> database;
+};
+
+TYPED_TEST_SUITE_P(EvalFullBatchTest);
+
+TYPED_TEST_P(EvalFullBatchTest, MatchesEvalFull)
+{
+    using output_type = typename TestFixture::output_type;
+
+    for (std::size_t lg_block : { 0, 3, 12 })
+    {
+        auto outbufs = dpf::eval_full_batch(this->dpfs, lg_block);
+        ASSERT_EQ(outbufs.size(), this->dpfs.size());
+        for (std::size_t k = 0; k < this->dpfs.size(); ++k)
+        {
+            auto [expected, iter] = dpf::eval_full(this->dpfs[k]);
+            assert_same_outputs<output_type>(expected, outbufs[k], this->range);
+        }
+    }
+}
+
+TYPED_TEST_P(EvalFullBatchTest, DotMatchesEvalFullDot)
+{
+    if constexpr (TestFixture::has_dot)
+    {
+        std::vector<uint64_t> accs(this->dpfs.size(), 0);
+        dpf::eval_full_dot_batch(this->dpfs, this->database, accs, 4);
+        for (std::size_t k = 0; k < this->dpfs.size(); ++k)
+        {
+            uint64_t expected = 0;
+            dpf::eval_full_dot(this->dpfs[k], this->database, expected);
+            ASSERT_EQ(accs[k], expected);
+        }
+    }
+}
+
+TYPED_TEST_P(EvalFullBatchTest, MismatchedSizes)
+{
+    if constexpr (TestFixture::has_dot)
+    {
+        std::vector<uint64_t> accs(this->dpfs.size() - 1, 0);
+        ASSERT_THROW(dpf::eval_full_dot_batch(this->dpfs, this->database, accs),
+            std::invalid_argument);
+    }
+}
+
+REGISTER_TYPED_TEST_SUITE_P(EvalFullBatchTest,
+    MatchesEvalFull,
+    DotMatchesEvalFullDot,
+    MismatchedSizes);
+using Types = testing::Types
+<
+    // base test
+    test_type<uint16_t, uint64_t>,
+
+    // test input types
+    test_type<int16_t, uint64_t>,
+    test_type<uint8_t, uint64_t>,
+    test_type<dpf::bitstring<10>, uint64_t>,
+    test_type<dpf::keyword<3, dpf::alphabets::hex>, uint64_t>,
+    test_type<dpf::modint<10>, uint64_t>,
+    test_type<dpf::xor_wrapper<int16_t>, uint64_t>,
+    test_type<dpf::xor_wrapper<uint16_t>, uint64_t>,
+
+    // test output types
+    test_type<uint16_t, int64_t>,
+    test_type<uint16_t, uint8_t>,
+    test_type<uint16_t, simde_int128>,
+    test_type<uint16_t, simde_uint128>,
+    test_type<uint16_t, dpf::bit>,
+    test_type<uint16_t, dpf::bitstring<20, uint8_t>>,
+    test_type<uint16_t, dpf::bitstring<150>>,
+    test_type<uint16_t, dpf::xor_wrapper<int64_t>>,
+    test_type<uint16_t, dpf::xor_wrapper<uint64_t>>,
+
+    // custom types
+    test_type<custom_input_type, uint64_t>,
+    test_type<uint16_t, custom_output_type_small>,
+    test_type<uint16_t, custom_output_type_large_plus_minus>,
+    test_type<uint16_t, custom_output_type_large_xor>
+>;
+INSTANTIATE_TYPED_TEST_SUITE_P(EvalFullBatchTestInstantiation, EvalFullBatchTest, Types);
+
+TEST(EvalFullDotBatchLargeDomainTest, RetrievesRecords)
+{
+    // the domain of a 64-bit input has more outputs than any std::size_t
+    // can count; a short database must still be accepted
+    std::vector<uint64_t> database(1 << 10);
+    for (std::size_t i = 0; i < database.size(); ++i) database[i] = uint64_t(i) * 0x9E3779B97F4A7C15 + 1;
+
+    using dpf_type = dpf::utils::dpf_type_t<dpf::prg::aes128, dpf::prg::aes128, uint64_t, uint64_t>;
+    std::vector<dpf_type> dpfs;
+    for (uint64_t x : { 0, 777, 1023 })
+    {
+        auto [dpf0, dpf1] = dpf::make_dpf(x, uint64_t(1));
+        dpfs.push_back(std::move(dpf0));
+        dpfs.push_back(std::move(dpf1));
+    }
+    std::vector<uint64_t> accs(dpfs.size(), 0);
+    dpf::eval_full_dot_batch(dpfs, database, accs, 4);
+    ASSERT_EQ(accs[1] - accs[0], database[0]);
+    ASSERT_EQ(accs[3] - accs[2], database[777]);
+    ASSERT_EQ(accs[5] - accs[4], database[1023]);
+}
+
+TEST(EvalFullBatchHalfTreeTest, MatchesEvalFull)
+{
+    using dpf_type = dpf::utils::half_tree_dpf_type_t<dpf::prg::aes128, dpf::prg::aes128, uint16_t, uint64_t>;
+    std::vector<dpf_type> dpfs;
+    for (uint16_t x : { 1, 1000, 65535 })
+    {
+        auto [dpf0, dpf1] = dpf::make_half_tree_dpf(x, uint64_t(x));
+        dpfs.push_back(std::move(dpf0));
+        dpfs.push_back(std::move(dpf1));
+    }
+    auto outbufs = dpf::eval_full_batch(dpfs, 6);
+    for (std::size_t k = 0; k < dpfs.size(); ++k)
+    {
+        auto [expected, iter] = dpf::eval_full(dpfs[k]);
+        ASSERT_TRUE(std::equal(std::begin(expected), std::end(expected), std::begin(outbufs[k])));
+    }
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "dpf.hpp"
+
+#include "helpers/eval_common_data.hpp"
+#include "helpers/assert_same_outputs.hpp"
+
+template <typename T>
+struct EvalFullChunksTest : public testing::Test
+{
+  public:
+    using input_type = typename std::tuple_element_t<0, T>;
+    using output_type = typename std::tuple_element_t<1, T>;
+
+  protected:
+    EvalFullChunksTest()
+      : params{std::get<std::vector<T>>(allParams)}
+    { }
+
+    std::vector<T> params;
+};
+
+TYPED_TEST_SUITE_P(EvalFullChunksTest);
+
+TYPED_TEST_P(EvalFullChunksTest, Range)
+{
+    using output_type = typename TestFixture::output_type;
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+        auto [expected, iter] = dpf::eval_full(dpf0);
+        for (std::size_t lg_chunk : { 0, 3, 12, 64 })
+        {
+            auto chunks = dpf::eval_full_chunks(dpf0, lg_chunk);
+            std::size_t total = 0, count = 0;
+            for (const auto & chunk : chunks)
+            {
+                ASSERT_EQ(std::size(chunk), chunks.chunk_size());
+                assert_same_outputs<output_type>(expected, chunk, std::size(chunk), total);
+                total += std::size(chunk);
+                ++count;
+            }
+            ASSERT_EQ(total, std::size(expected));
+            ASSERT_EQ(count, static_cast<std::size_t>(chunks.size()));
+        }
+    }
+}
+
+TYPED_TEST_P(EvalFullChunksTest, ForEach)
+{
+    using output_type = typename TestFixture::output_type;
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+        auto [expected, iter] = dpf::eval_full(dpf1);
+        for (bool overlap : { false, true })
+        {
+            for (std::size_t lg_chunk : { 2, 9 })
+            {
+                std::size_t total = 0, next = 0;
+                dpf::eval_full_for_each_chunk(dpf1, [&](auto k, const auto & chunk)
+                {
+                    ASSERT_EQ(static_cast<std::size_t>(k), next++);
+                    assert_same_outputs<output_type>(expected, chunk, std::size(chunk), total);
+                    total += std::size(chunk);
+                }, lg_chunk, overlap);
+                ASSERT_EQ(total, std::size(expected));
+            }
+        }
+    }
+}
+
+TYPED_TEST_P(EvalFullChunksTest, ForEachThrows)
+{
+    auto [x, y] = this->params.front();
+    auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+    for (bool overlap : { false, true })
+    {
+        std::size_t calls = 0;
+        ASSERT_THROW(dpf::eval_full_for_each_chunk(dpf0, [&](auto, const auto &)
+        {
+            if (++calls == 3) throw std::runtime_error("stop");
+        }, 2, overlap), std::runtime_error);
+        ASSERT_EQ(calls, 3);
+    }
+}
+
+REGISTER_TYPED_TEST_SUITE_P(EvalFullChunksTest,
+    Range,
+    ForEach,
+    ForEachThrows);
+using Types = testing::Types
+<
+    // base test
+    test_type<uint16_t, uint64_t>,
+
+    // test input types
+    test_type<int16_t, uint64_t>,
+    test_type<uint8_t, uint64_t>,
+    test_type<dpf::bitstring<10>, uint64_t>,
+    test_type<dpf::keyword<3, dpf::alphabets::hex>, uint64_t>,
+    test_type<dpf::modint<10>, uint64_t>,
+    test_type<dpf::xor_wrapper<int16_t>, uint64_t>,
+    test_type<dpf::xor_wrapper<uint16_t>, uint64_t>,
+
+    // test output types
+    test_type<uint16_t, int64_t>,
+    test_type<uint16_t, uint8_t>,
+    test_type<uint16_t, simde_int128>,
+    test_type<uint16_t, simde_uint128>,
+    test_type<uint16_t, dpf::bit>,
+    test_type<uint16_t, dpf::bitstring<20, uint8_t>>,
+    test_type<uint16_t, dpf::bitstring<150>>,
+    test_type<uint16_t, dpf::xor_wrapper<int64_t>>,
+    test_type<uint16_t, dpf::xor_wrapper<uint64_t>>,
+
+    // custom types
+    test_type<custom_input_type, uint64_t>,
+    test_type<uint16_t, custom_output_type_small>,
+    test_type<uint16_t, custom_output_type_large_plus_minus>,
+    test_type<uint16_t, custom_output_type_large_xor>
+>;
+INSTANTIATE_TYPED_TEST_SUITE_P(EvalFullChunksTestInstantiation, EvalFullChunksTest, Types);
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include "dpf.hpp"
+
+#include "helpers/eval_common_data.hpp"
+#include "helpers/assert_same_outputs.hpp"
+
+template <typename T>
+struct EvalFullDepthFirstTest : public testing::Test
+{
+  public:
+    using input_type = typename std::tuple_element_t<0, T>;
+    using output_type = typename std::tuple_element_t<1, T>;
+
+  protected:
+    EvalFullDepthFirstTest()
+      : params{std::get<std::vector<T>>(allParams)},
+        range{std::size_t(1) << dpf::utils::bitlength_of_v<input_type>}
+    { }
+
+    std::vector<T> params;
+    std::size_t range;
+};
+
+TYPED_TEST_SUITE_P(EvalFullDepthFirstTest);
+
+TYPED_TEST_P(EvalFullDepthFirstTest, MatchesBreadthFirst)
+{
+    using output_type = typename TestFixture::output_type;
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+        auto [expected, iter] = dpf::eval_full(dpf0);
+        for (std::size_t lg_block : { 0, 1, 5, 12, 64 })
+        {
+            auto [actual, diter] = dpf::eval_full_depth_first(dpf0, lg_block);
+            assert_same_outputs<output_type>(expected, actual, this->range);
+        }
+    }
+}
+
+TYPED_TEST_P(EvalFullDepthFirstTest, Outbuf)
+{
+    using output_type = typename TestFixture::output_type;
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+        auto [expected, iter] = dpf::eval_full(dpf1);
+        auto actual = dpf::make_output_buffer_for_full(dpf1);
+        dpf::eval_full_depth_first(dpf1, actual, 3);
+        assert_same_outputs<output_type>(expected, actual, this->range);
+    }
+}
+
+TYPED_TEST_P(EvalFullDepthFirstTest, HalfTreeKey)
+{
+    using output_type = typename TestFixture::output_type;
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_half_tree_dpf(x, y);
+        auto [expected, iter] = dpf::eval_full(dpf0);
+        auto [actual, diter] = dpf::eval_full_depth_first(dpf0, 4);
+        assert_same_outputs<output_type>(expected, actual, this->range);
+    }
+}
+
+REGISTER_TYPED_TEST_SUITE_P(EvalFullDepthFirstTest,
+    MatchesBreadthFirst,
+    Outbuf,
+    HalfTreeKey);
+using Types = testing::Types
+<
+    // base test
+    test_type<uint16_t, uint64_t>,
+
+    // test input types
+    test_type<int16_t, uint64_t>,
+    test_type<uint8_t, uint64_t>,
+    test_type<dpf::bitstring<10>, uint64_t>,
+    test_type<dpf::keyword<3, dpf::alphabets::hex>, uint64_t>,
+    test_type<dpf::modint<10>, uint64_t>,
+    test_type<dpf::xor_wrapper<int16_t>, uint64_t>,
+    test_type<dpf::xor_wrapper<uint16_t>, uint64_t>,
+
+    // test output types
+    test_type<uint16_t, int64_t>,
+    test_type<uint16_t, uint8_t>,
+    test_type<uint16_t, simde_int128>,
+    test_type<uint16_t, simde_uint128>,
+    test_type<uint16_t, dpf::bit>,
+    test_type<uint16_t, dpf::bitstring<20, uint8_t>>,
+    test_type<uint16_t, dpf::bitstring<150>>,
+    test_type<uint16_t, dpf::xor_wrapper<int64_t>>,
+    test_type<uint16_t, dpf::xor_wrapper<uint64_t>>,
+
+    // custom types
+    test_type<custom_input_type, uint64_t>,
+    test_type<uint16_t, custom_output_type_small>,
+    test_type<uint16_t, custom_output_type_large_plus_minus>,
+    test_type<uint16_t, custom_output_type_large_xor>
+>;
+INSTANTIATE_TYPED_TEST_SUITE_P(EvalFullDepthFirstTestInstantiation, EvalFullDepthFirstTest, Types);
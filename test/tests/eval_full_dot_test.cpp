@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "dpf.hpp"
+
+template <typename T>
+struct EvalFullDotTest : public testing::Test
+{
+  public:
+    using input_type = typename std::tuple_element_t<0, T>;
+    using output_type = typename std::tuple_element_t<1, T>;
+    using integral_type = dpf::utils::integral_type_from_bitlength_t<dpf::utils::bitlength_of_v<input_type>>;
+
+  protected:
+    EvalFullDotTest()
+      : x{from_integral_type(dpf::uniform_sample<integral_type>())},
+        database(range)
+    {
+        for (auto & record : database) record = dpf::uniform_sample<uint64_t>();
+    }
+
+    // the inner product computed the slow way, from `eval_full`
+    template <typename DpfKey>
+    static uint64_t expected_dot(const DpfKey & dpf, const std::vector<uint64_t> & database)
+    {
+        auto [buf, iter] = dpf::eval_full(dpf);
+        uint64_t acc = 0;
+        auto it = std::begin(buf);
+        for (std::size_t i = 0; i < database.size(); ++i, ++it)
+        {
+            if constexpr (std::is_same_v<output_type, dpf::bit>)
+            {
+                if (*it) acc ^= database[i];
+            }
+            else
+            {
+                acc += static_cast<uint64_t>(*it) * database[i];
+            }
+        }
+        return acc;
+    }
+
+    static constexpr auto from_integral_type = dpf::utils::make_from_integral_value<input_type>{};
+    static constexpr std::size_t range = std::size_t(1) << dpf::utils::bitlength_of_v<input_type>;
+
+    input_type x;
+    std::vector<uint64_t> database;
+};
+
+TYPED_TEST_SUITE_P(EvalFullDotTest);
+
+TYPED_TEST_P(EvalFullDotTest, MatchesEvalFull)
+{
+    using output_type = typename TestFixture::output_type;
+
+    auto [dpf0, dpf1] = dpf::make_dpf(this->x, output_type(1));
+    for (std::size_t lg_block : { 0, 3, 12 })
+    {
+        uint64_t acc = 0;
+        dpf::eval_full_dot(dpf0, this->database, acc, lg_block);
+        ASSERT_EQ(acc, this->expected_dot(dpf0, this->database));
+    }
+}
+
+TYPED_TEST_P(EvalFullDotTest, ShortDatabase)
+{
+    using output_type = typename TestFixture::output_type;
+
+    auto [dpf0, dpf1] = dpf::make_dpf(this->x, output_type(1));
+    this->database.resize(this->range / 3 + 1);
+    uint64_t acc = 0;
+    dpf::eval_full_dot(dpf1, this->database.data(), this->database.size(), acc, 2);
+    ASSERT_EQ(acc, this->expected_dot(dpf1, this->database));
+}
+
+TYPED_TEST_P(EvalFullDotTest, RetrievesRecord)
+{
+    using output_type = typename TestFixture::output_type;
+    auto to_integral_type = dpf::utils::to_integral_type<typename TestFixture::input_type>{};
+
+    auto [dpf0, dpf1] = dpf::make_dpf(this->x, output_type(1));
+    uint64_t acc0 = 0, acc1 = 0;
+    dpf::eval_full_dot(dpf0, this->database, acc0);
+    dpf::eval_full_dot(dpf1, this->database, acc1);
+
+    auto [buf, iter] = dpf::eval_full(dpf0);
+    std::size_t pos = static_cast<std::size_t>(to_integral_type(this->x));
+    if constexpr (std::is_same_v<output_type, dpf::bit>)
+    {
+        ASSERT_EQ(acc0 ^ acc1, this->database[pos]);
+    }
+    else
+    {
+        ASSERT_EQ(acc1 - acc0, this->database[pos]);
+    }
+}
+
+TYPED_TEST_P(EvalFullDotTest, TooLargeDatabase)
+{
+    using output_type = typename TestFixture::output_type;
+
+    auto [dpf0, dpf1] = dpf::make_dpf(this->x, output_type(1));
+    this->database.resize(this->range + 1);
+    uint64_t acc = 0;
+    ASSERT_THROW(dpf::eval_full_dot(dpf0, this->database, acc), std::length_error);
+}
+
+REGISTER_TYPED_TEST_SUITE_P(EvalFullDotTest,
+    MatchesEvalFull,
+    ShortDatabase,
+    RetrievesRecord,
+    TooLargeDatabase);
+using Types = testing::Types
+<
+    std::tuple<uint16_t, uint64_t>,
+    std::tuple<uint8_t, uint64_t>,
+    std::tuple<dpf::modint<14>, uint64_t>,
+    std::tuple<uint16_t, dpf::bit>,
+    std::tuple<dpf::modint<18>, dpf::bit>
+>;
+INSTANTIATE_TYPED_TEST_SUITE_P(EvalFullDotTestInstantiation, EvalFullDotTest, Types);
+
+TEST(EvalFullDotLargeDomainTest, RetrievesRecord)
+{
+    // the domain of a 64-bit input has more outputs than any std::size_t
+    // can count; a short database must still be accepted
+    std::vector<uint64_t> database(1 << 10);
+    for (auto & record : database) record = dpf::uniform_sample<uint64_t>();
+
+    auto [dpf0, dpf1] = dpf::make_dpf(uint64_t(777), uint64_t(1));
+    uint64_t acc0 = 0, acc1 = 0;
+    dpf::eval_full_dot(dpf0, database, acc0, 4);
+    dpf::eval_full_dot(dpf1, database, acc1, 4);
+    ASSERT_EQ(acc1 - acc0, database[777]);
+}
+
+TEST(EvalFullDotLargeDomainTest, RetrievesRecordBitOutput)
+{
+    std::vector<uint64_t> database(1 << 10);
+    for (auto & record : database) record = dpf::uniform_sample<uint64_t>();
+
+    auto [dpf0, dpf1] = dpf::make_dpf(uint64_t(1000), dpf::bit::one);
+    uint64_t acc0 = 0, acc1 = 0;
+    dpf::eval_full_dot(dpf0, database, acc0);
+    dpf::eval_full_dot(dpf1, database, acc1);
+    ASSERT_EQ(acc0 ^ acc1, database[1000]);
+}
+
+TEST(MappedDatabaseTest, MatchesVector)
+{
+    std::vector<uint64_t> database(1 << 12);
+    for (auto & record : database) record = dpf::uniform_sample<uint64_t>();
+    std::string path = testing::TempDir() + "mapped_database_test.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char *>(database.data()),
+            database.size() * sizeof(uint64_t));
+    }
+
+    dpf::mapped_database<uint64_t> mapped(path);
+    ASSERT_EQ(mapped.size(), database.size());
+
+    auto [dpf0, dpf1] = dpf::make_dpf(uint16_t(1234), dpf::bit::one);
+    uint64_t expected = 0, actual = 0;
+    dpf::eval_full_dot(dpf0, database, expected);
+    dpf::eval_full_dot(dpf0, mapped, actual);
+    ASSERT_EQ(actual, expected);
+
+    std::remove(path.c_str());
+}
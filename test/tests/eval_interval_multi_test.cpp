@@ -106,7 +106,7 @@ struct EvalIntervalMultiTest : public testing::Test
         for (auto [x, y0, y1, y2, y3] : this->params)
         {
             auto [from, to] = this->get_from_to(x);
-            std::size_t cur_range = dpf::utils::get_nodes_in_interval<dpf_type>(from, to);
+            std::size_t cur_range = dpf::utils::get_leafnodes_in_output_interval<dpf_type>(from, to);
             if (cur_range > max_range)
             {
                 max_range = cur_range;
@@ -91,7 +91,7 @@ struct EvalIntervalTest : public testing::Test
         for (auto [x, y] : this->params)
         {
             auto [from, to] = this->get_from_to(x);
-            std::size_t cur_range = dpf::utils::get_nodes_in_interval<dpf_type>(from, to);
+            std::size_t cur_range = dpf::utils::get_leafnodes_in_output_interval<dpf_type>(from, to);
             if (cur_range > max_range)
             {
                 max_range = cur_range;
@@ -217,13 +217,34 @@ TYPED_TEST_P(EvalIntervalTest, FullTreeIntervalMemoizerOutbuf)
     }
 }
 
+TYPED_TEST_P(EvalIntervalTest, TypeErasedIntervalMemoizer)
+{
+    using dpf_type = typename TestFixture::dpf_type;
+    // interval memoizers are move-only, so a named one must be moved in
+    auto full_tree = dpf::make_full_tree_interval_memoizer<dpf_type>(this->max_from_to.first, this->max_from_to.second);
+    auto memo0 = dpf::make_type_erased_interval_memoizer(
+            dpf::make_basic_interval_memoizer<dpf_type>(this->max_from_to.first, this->max_from_to.second)),
+         memo1 = dpf::make_type_erased_interval_memoizer(std::move(full_tree));
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+        auto [from, to] = this->get_from_to(x);
+        auto [buf0, iter0] = dpf::eval_interval(dpf0, from, to, *memo0);
+        auto [buf1, iter1] = dpf::eval_interval(dpf1, from, to, *memo1);
+
+        this->assert_wrapper(x, y, from, iter0, iter1);
+    }
+}
+
 REGISTER_TYPED_TEST_SUITE_P(EvalIntervalTest,
     Basic,
     Outbuf,
     BasicIntervalMemoizer,
     FullTreeIntervalMemoizer,
     BasicIntervalMemoizerOutbuf,
-    FullTreeIntervalMemoizerOutbuf);
+    FullTreeIntervalMemoizerOutbuf,
+    TypeErasedIntervalMemoizer);
 using Types = testing::Types
 <
     // base test
@@ -259,3 +280,33 @@ using Types = testing::Types
     test_type<uint16_t, custom_output_type_large_xor>
 >;
 INSTANTIATE_TYPED_TEST_SUITE_P(EvalIntervalTestInstantiation, EvalIntervalTest, Types);
+
+TEST(EvalIntervalInteriorHashTest, LeavesDoNotInvalidateMemoizer)
+{
+    using dpf_type = dpf::utils::dpf_type_t<dpf::prg::aes128, dpf::prg::aes128, uint16_t, uint64_t>;
+    auto [dpf0, dpf1] = dpf::make_dpf(uint16_t(1234), uint64_t(42));
+    auto [other0, other1] = dpf::make_dpf(uint16_t(4321), uint64_t(7));
+
+    // same root and interior as `dpf0`, but the leaves of `other0`
+    dpf_type mixed(dpf0.root(), dpf0.correction_words(), dpf0.correction_advice(),
+        typename dpf_type::leaf_tuple{std::get<0>(other0.leaf_nodes).get()},
+        typename dpf_type::beaver_tuple{}, uint16_t{0});
+    ASSERT_EQ(mixed.interior_hash(), dpf0.interior_hash());
+    ASSERT_NE(mixed.common_part_hash(), dpf0.common_part_hash());
+    ASSERT_NE(other0.interior_hash(), dpf0.interior_hash());
+
+    auto memo = dpf::make_basic_full_memoizer<dpf_type>();
+    ASSERT_EQ(memo.assign_interval(dpf0, 0, 8), 1);
+    memo.advance_level();
+    memo.advance_level();
+    ASSERT_EQ(memo.assign_interval(mixed, 0, 8), 3);
+    ASSERT_EQ(memo.assign_interval(other0, 0, 8), 1);
+
+    // only the exterior pass is rerun, and it uses the new leaves
+    auto memo0 = dpf::make_basic_full_memoizer<dpf_type>();
+    auto [buf0, iter0] = dpf::eval_full(dpf0, memo0);
+    auto [buf1, iter1] = dpf::eval_full(mixed, memo0);
+    auto [expected, iter2] = dpf::eval_full(mixed);
+    ASSERT_TRUE(std::equal(std::begin(expected), std::end(expected), std::begin(buf1)));
+    ASSERT_FALSE(std::equal(std::begin(expected), std::end(expected), std::begin(buf0)));
+}
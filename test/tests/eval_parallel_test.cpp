@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "dpf.hpp"
+
+#include "helpers/eval_common_data.hpp"
+#include "helpers/assert_same_outputs.hpp"
+
+template <typename T>
+struct EvalParallelTest : public testing::Test
+{
+  public:
+    using input_type = typename std::tuple_element_t<0, T>;
+    using output_type = typename std::tuple_element_t<1, T>;
+    using integral_type = dpf::utils::integral_type_from_bitlength_t<dpf::utils::bitlength_of_v<input_type>>;
+    using dpf_type = dpf::utils::dpf_type_t<dpf::prg::aes128, dpf::prg::aes128, input_type, output_type>;
+
+  protected:
+    EvalParallelTest()
+      : params{std::get<std::vector<T>>(allParams)},
+        range{std::size_t(1) << dpf::utils::bitlength_of_v<input_type>}
+    { }
+
+    static constexpr auto to_integral_type = dpf::utils::to_integral_type<input_type>{};
+
+    std::vector<T> params;
+    std::size_t range;
+};
+
+TYPED_TEST_SUITE_P(EvalParallelTest);
+
+TYPED_TEST_P(EvalParallelTest, FullMatchesSerial)
+{
+    using output_type = typename TestFixture::output_type;
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+        auto [expected, iter] = dpf::eval_full(dpf0);
+        for (std::size_t threads : { 1, 2, 3, 8 })
+        {
+            auto [actual, piter] = dpf::eval_full_parallel(dpf0, threads);
+            assert_same_outputs<output_type>(expected, actual, this->range);
+        }
+    }
+}
+
+TYPED_TEST_P(EvalParallelTest, FullOutbuf)
+{
+    using output_type = typename TestFixture::output_type;
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+        auto [expected, iter] = dpf::eval_full(dpf1);
+        auto actual = dpf::make_output_buffer_for_full(dpf1);
+        dpf::eval_full_parallel(dpf1, actual, 4);
+        assert_same_outputs<output_type>(expected, actual, this->range);
+    }
+}
+
+TYPED_TEST_P(EvalParallelTest, IntervalMatchesSerial)
+{
+    using input_type = typename TestFixture::input_type;
+    using output_type = typename TestFixture::output_type;
+    using integral_type = typename TestFixture::integral_type;
+    const input_type min = std::numeric_limits<input_type>::min(),
+                     max = std::numeric_limits<input_type>::max();
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+        for (auto [from, to] : { std::make_pair(min, x), std::make_pair(x, max) })
+        {
+            auto [buf, expected] = dpf::eval_interval(dpf0, from, to);
+            auto [pbuf, actual] = dpf::eval_interval_parallel(dpf0, from, to, 3);
+            std::size_t count = std::size_t(integral_type(this->to_integral_type(to)
+                - this->to_integral_type(from))) + 1;
+            assert_same_outputs<output_type>(expected, actual, count);
+        }
+    }
+}
+
+TYPED_TEST_P(EvalParallelTest, SequenceMatchesSerial)
+{
+    using input_type = typename TestFixture::input_type;
+    using output_type = typename TestFixture::output_type;
+    using dpf_type = typename TestFixture::dpf_type;
+
+    // the points of `params` plus an evenly spaced sample of the domain
+    std::set<input_type> set;
+    for (auto [x, y] : this->params) set.insert(x);
+    std::size_t stride = std::max(this->range / 1000, std::size_t(1));
+    input_type cur = std::numeric_limits<input_type>::min();
+    for (std::size_t i = 0; i < this->range; ++i, ++cur)
+    {
+        if (i % stride == 0) set.insert(cur);
+    }
+    std::vector<input_type> points(set.begin(), set.end());
+    auto recipe = dpf::make_sequence_recipe<dpf_type>(points.begin(), points.end());
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+        auto [expected, iter] = dpf::eval_sequence(dpf0, recipe);
+        auto [expected_only, iter_only] = dpf::eval_sequence(dpf0, recipe, dpf::return_output_only_tag_{});
+        for (std::size_t threads : { 1, 3, 8 })
+        {
+            auto [actual, piter] = dpf::eval_sequence_parallel(dpf0, recipe,
+                dpf::return_entire_node_tag_{}, threads);
+            assert_same_outputs<output_type>(expected, actual,
+                recipe.num_leaf_nodes() * dpf_type::outputs_per_leaf);
+
+            auto actual_only = dpf::make_output_buffer_for_recipe_subsequence(dpf0, recipe, dpf::return_output_only_tag_{});
+            dpf::eval_sequence_parallel(dpf0, recipe, actual_only, dpf::return_output_only_tag_{}, threads);
+            assert_same_outputs<output_type>(expected_only, actual_only, points.size());
+        }
+    }
+}
+
+TYPED_TEST_P(EvalParallelTest, HalfTreeKey)
+{
+    using output_type = typename TestFixture::output_type;
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_half_tree_dpf(x, y);
+        auto [expected, iter] = dpf::eval_full(dpf0);
+        auto [actual, piter] = dpf::eval_full_parallel(dpf0, 4);
+        assert_same_outputs<output_type>(expected, actual, this->range);
+    }
+}
+
+REGISTER_TYPED_TEST_SUITE_P(EvalParallelTest,
+    FullMatchesSerial,
+    FullOutbuf,
+    IntervalMatchesSerial,
+    SequenceMatchesSerial,
+    HalfTreeKey);
+using Types = testing::Types
+<
+    // base test
+    test_type<uint16_t, uint64_t>,
+
+    // test input types
+    test_type<int16_t, uint64_t>,
+    test_type<uint8_t, uint64_t>,
+    test_type<dpf::bitstring<10>, uint64_t>,
+    test_type<dpf::keyword<3, dpf::alphabets::hex>, uint64_t>,
+    test_type<dpf::modint<10>, uint64_t>,
+    test_type<dpf::xor_wrapper<int16_t>, uint64_t>,
+    test_type<dpf::xor_wrapper<uint16_t>, uint64_t>,
+
+    // test output types
+    test_type<uint16_t, int64_t>,
+    test_type<uint16_t, uint8_t>,
+    test_type<uint16_t, simde_int128>,
+    test_type<uint16_t, simde_uint128>,
+    test_type<uint16_t, dpf::bit>,
+    test_type<uint16_t, dpf::bitstring<20, uint8_t>>,
+    test_type<uint16_t, dpf::bitstring<150>>,
+    test_type<uint16_t, dpf::xor_wrapper<int64_t>>,
+    test_type<uint16_t, dpf::xor_wrapper<uint64_t>>,
+
+    // custom types
+    test_type<custom_input_type, uint64_t>,
+    test_type<uint16_t, custom_output_type_small>,
+    test_type<uint16_t, custom_output_type_large_plus_minus>,
+    test_type<uint16_t, custom_output_type_large_xor>
+>;
+INSTANTIATE_TYPED_TEST_SUITE_P(EvalParallelTestInstantiation, EvalParallelTest, Types);
@@ -155,10 +155,133 @@ TYPED_TEST_P(EvalPointTest, NonmemoizingPathMemoizer)
     }
 }
 
+TYPED_TEST_P(EvalPointTest, FrontierPathMemoizer)
+{
+    using input_type = typename TestFixture::input_type;
+    using dpf_type = typename TestFixture::dpf_type;
+
+    for (std::size_t level : { 0, 5, 12 })
+    {
+        level = std::min(level, dpf_type::depth);
+        auto memo0 = dpf::make_frontier_path_memoizer<dpf_type>(level),
+             memo1 = dpf::make_frontier_path_memoizer<dpf_type>(level);
+
+        for (auto [x, y] : this->params)
+        {
+            auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+
+            this->assert_wrapper(x, y,
+                [&dpf0, &memo0](input_type cur)
+                {
+                    return dpf::eval_point(dpf0, cur, memo0);
+                },
+                [&dpf1, &memo1](input_type cur)
+                {
+                    return dpf::eval_point(dpf1, cur, memo1);
+                }
+            );
+        }
+    }
+    ASSERT_THROW(dpf::make_frontier_path_memoizer<dpf_type>(dpf_type::depth + 1),
+        std::invalid_argument);
+}
+
+TYPED_TEST_P(EvalPointTest, LruPathMemoizer)
+{
+    using input_type = typename TestFixture::input_type;
+    using output_type = typename TestFixture::output_type;
+    using dpf_type = typename TestFixture::dpf_type;
+
+    for (std::size_t ways : { 1, 4, 64 })
+    {
+        auto memo0 = dpf::make_lru_path_memoizer<dpf_type>(ways),
+             memo1 = dpf::make_lru_path_memoizer<dpf_type>(ways);
+
+        for (auto [x, y] : this->params)
+        {
+            auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+
+            this->assert_wrapper(x, y,
+                [&dpf0, &memo0](input_type cur)
+                {
+                    return dpf::eval_point(dpf0, cur, memo0);
+                },
+                [&dpf1, &memo1](input_type cur)
+                {
+                    return dpf::eval_point(dpf1, cur, memo1);
+                }
+            );
+
+            // interleave queries around x with queries around other points
+            input_type others[3] = {
+                std::numeric_limits<input_type>::min(),
+                std::numeric_limits<input_type>::max(),
+                this->get_start(x)
+            };
+            for (std::size_t i = 0; i < 3 * this->range; ++i)
+            {
+                input_type cur = others[i % 3];
+                ++others[i % 3];
+                output_type y0 = dpf::eval_point(dpf0, cur, memo0),
+                            y1 = dpf::eval_point(dpf0, cur);
+                ASSERT_EQ(y0, y1);
+            }
+        }
+    }
+    ASSERT_THROW(dpf::make_lru_path_memoizer<dpf_type>(0), std::invalid_argument);
+}
+
+TYPED_TEST_P(EvalPointTest, TypeErasedPathMemoizer)
+{
+    using input_type = typename TestFixture::input_type;
+    using dpf_type = typename TestFixture::dpf_type;
+    dpf::type_erased_path_memoizer<dpf::basic_path_memoizer<dpf_type>> erased0;
+    auto erased1 = dpf::make_type_erased_path_memoizer(dpf::make_nonmemoizing_path_memoizer<dpf_type>());
+    dpf::path_memoizer_base<dpf_type> & memo0 = erased0, & memo1 = *erased1;
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+
+        this->assert_wrapper(x, y,
+            [&dpf0, &memo0](input_type cur)
+            {
+                return dpf::eval_point(dpf0, cur, memo0);
+            },
+            [&dpf1, &memo1](input_type cur)
+            {
+                return dpf::eval_point(dpf1, cur, memo1);
+            }
+        );
+    }
+
+    // an lvalue is copied into the adapter and stays usable
+    auto memo2 = dpf::make_basic_path_memoizer<dpf_type>();
+    auto erased2 = dpf::make_type_erased_path_memoizer(memo2);
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+
+        this->assert_wrapper(x, y,
+            [&dpf0, &erased2](input_type cur)
+            {
+                return dpf::eval_point(dpf0, cur, *erased2);
+            },
+            [&dpf1, &memo2](input_type cur)
+            {
+                return dpf::eval_point(dpf1, cur, memo2);
+            }
+        );
+    }
+}
+
 REGISTER_TYPED_TEST_SUITE_P(EvalPointTest,
     Basic,
     BasicPathMemoizer,
-    NonmemoizingPathMemoizer);
+    NonmemoizingPathMemoizer,
+    FrontierPathMemoizer,
+    LruPathMemoizer,
+    TypeErasedPathMemoizer);
 using Types = testing::Types
 <
     // base test
@@ -194,3 +317,26 @@ using Types = testing::Types
     test_type<uint16_t, custom_output_type_large_xor>
 >;
 INSTANTIATE_TYPED_TEST_SUITE_P(EvalPointTestInstantiation, EvalPointTest, Types);
+
+TEST(EvalPointBitstringTest, PathMemoizerIgnoresPaddingBits)
+{
+    using input_type = dpf::bitstring<10>;
+    using output_type = uint64_t;
+    input_type x{1023};
+    output_type y = 42;
+    auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+    auto memo0 = dpf::make_basic_path_memoizer(dpf0),
+         memo1 = dpf::make_basic_path_memoizer(dpf1);
+
+    // incrementing past 1023 carries into the padding bits above bit 9;
+    // the memoizer must still see "1024" as 0, sharing no path with 1023
+    input_type cur{1021};
+    for (std::size_t i = 0; i < 6; ++i, ++cur)
+    {
+        output_type y0 = dpf::eval_point(dpf0, cur, memo0),
+                    y1 = dpf::eval_point(dpf1, cur, memo1);
+        ASSERT_EQ(y0, static_cast<output_type>(dpf::eval_point(dpf0, cur)));
+        ASSERT_EQ(y1, static_cast<output_type>(dpf::eval_point(dpf1, cur)));
+        ASSERT_EQ(static_cast<output_type>(y1 - y0), cur == x ? y : output_type(0));
+    }
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "dpf.hpp"
+
+template <typename T>
+struct EvalPointsTest : public testing::Test
+{
+  public:
+    using input_type = typename std::tuple_element_t<0, T>;
+    using output_type = typename std::tuple_element_t<1, T>;
+    using integral_type = dpf::utils::integral_type_from_bitlength_t<dpf::utils::bitlength_of_v<input_type>>;
+    using output_integral_type = dpf::utils::integral_type_from_bitlength_t<dpf::utils::bitlength_of_v<output_type>>;
+
+  protected:
+    EvalPointsTest()
+      : x{from_integral_type(dpf::uniform_sample<integral_type>())},
+        // alternating bits, at the width of output_type
+        y{from_integral_type_output(static_cast<output_integral_type>(~output_integral_type{0}) / 3)}
+    {
+        // unsorted, with duplicates, and long enough to need several batches
+        points.push_back(x);
+        for (std::size_t i = 0; i < 100; ++i)
+        {
+            points.push_back(from_integral_type(dpf::uniform_sample<integral_type>()));
+        }
+        points.push_back(x);
+        points.push_back(std::numeric_limits<input_type>::max());
+        points.push_back(std::numeric_limits<input_type>::min());
+    }
+
+    template <typename DpfKey, typename Outputs>
+    void assert_matches_eval_point(const DpfKey & dpf,
+        const Outputs & outputs)
+    {
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            ASSERT_EQ(static_cast<output_type>(outputs[i]),
+                static_cast<output_type>(dpf::eval_point(dpf, points[i])));
+        }
+    }
+
+    static constexpr auto from_integral_type = dpf::utils::make_from_integral_value<input_type>{};
+    static constexpr auto from_integral_type_output = dpf::utils::make_from_integral_value<output_type>{};
+
+    input_type x;
+    output_type y;
+    std::vector<input_type> points;
+};
+
+TYPED_TEST_SUITE_P(EvalPointsTest);
+
+TYPED_TEST_P(EvalPointsTest, MatchesEvalPoint)
+{
+    auto [dpf0, dpf1] = dpf::make_dpf(this->x, this->y);
+    auto outputs0 = dpf::eval_points(dpf0, this->points);
+    auto outputs1 = dpf::eval_points(dpf1, this->points);
+    this->assert_matches_eval_point(dpf0, outputs0);
+    this->assert_matches_eval_point(dpf1, outputs1);
+}
+
+TYPED_TEST_P(EvalPointsTest, Outbuf)
+{
+    using output_type = typename TestFixture::output_type;
+
+    auto [dpf0, dpf1] = dpf::make_dpf(this->x, this->y);
+    auto outputs = dpf::output_buffer<output_type>(this->points.size());
+    dpf::eval_points(dpf1, this->points, outputs);
+    this->assert_matches_eval_point(dpf1, outputs);
+
+    auto too_small = dpf::output_buffer<output_type>(this->points.size() - 1);
+    ASSERT_THROW(dpf::eval_points(dpf1, this->points, too_small), std::length_error);
+}
+
+TYPED_TEST_P(EvalPointsTest, HalfTreeKey)
+{
+    auto [dpf0, dpf1] = dpf::make_half_tree_dpf(this->x, this->y);
+    auto outputs = dpf::eval_points(dpf0, this->points);
+    this->assert_matches_eval_point(dpf0, outputs);
+}
+
+REGISTER_TYPED_TEST_SUITE_P(EvalPointsTest,
+    MatchesEvalPoint,
+    Outbuf,
+    HalfTreeKey);
+using Types = testing::Types
+<
+    std::tuple<uint16_t, uint64_t>,
+    std::tuple<int16_t, uint64_t>,
+    std::tuple<uint8_t, uint64_t>,
+    std::tuple<uint64_t, uint64_t>,
+    std::tuple<dpf::modint<10>, uint64_t>,
+    std::tuple<uint16_t, uint8_t>,
+    std::tuple<uint16_t, simde_uint128>,
+    std::tuple<uint16_t, dpf::bit>
+>;
+INSTANTIATE_TYPED_TEST_SUITE_P(EvalPointsTestInstantiation, EvalPointsTest, Types);
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <stdexcept>
+
+#include "dpf.hpp"
+
+#include "helpers/eval_common_data.hpp"
+#include "helpers/assert_same_outputs.hpp"
+
+template <typename T>
+struct EvalSubtreeTest : public testing::Test
+{
+  public:
+    using input_type = typename std::tuple_element_t<0, T>;
+    using output_type = typename std::tuple_element_t<1, T>;
+    using dpf_type = dpf::utils::dpf_type_t<dpf::prg::aes128, dpf::prg::aes128, input_type, output_type>;
+
+  protected:
+    EvalSubtreeTest()
+      : params{std::get<std::vector<T>>(allParams)}
+    { }
+
+    std::vector<T> params;
+};
+
+TYPED_TEST_SUITE_P(EvalSubtreeTest);
+
+TYPED_TEST_P(EvalSubtreeTest, MatchesEvalFull)
+{
+    using output_type = typename TestFixture::output_type;
+    using dpf_type = typename TestFixture::dpf_type;
+    using integral_type = typename dpf_type::integral_type;
+    constexpr auto depth = dpf_type::depth;
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+        auto [expected, iter] = dpf::eval_full(dpf0);
+        for (std::size_t level : { std::size_t(0), std::size_t(1), std::size_t(3), depth - 1, depth })
+        {
+            auto frontier = dpf::export_frontier(dpf0, level);
+            ASSERT_EQ(frontier.size(), std::size_t(1) << level);
+
+            std::size_t n = dpf_type::outputs_per_leaf << (depth - level);
+            for (std::size_t k : { std::size_t(0), frontier.size() / 2, frontier.size() - 1 })
+            {
+                auto [buf, subiter] = dpf::eval_subtree(dpf0, level, integral_type(k), frontier[k]);
+                ASSERT_EQ(std::size(buf), n);
+                assert_same_outputs<output_type>(expected, buf, n, k * n);
+            }
+        }
+    }
+}
+
+TYPED_TEST_P(EvalSubtreeTest, Outbuf)
+{
+    using output_type = typename TestFixture::output_type;
+    using dpf_type = typename TestFixture::dpf_type;
+    using integral_type = typename dpf_type::integral_type;
+    constexpr std::size_t level = 4;
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+        auto [expected, iter] = dpf::eval_full(dpf1);
+        auto frontier = dpf::export_frontier(dpf1, level);
+        std::size_t n = dpf_type::outputs_per_leaf << (dpf_type::depth - level);
+        auto buf = dpf::output_buffer<output_type>(n);
+        for (std::size_t k = 0; k < frontier.size(); ++k)
+        {
+            dpf::eval_subtree(dpf1, level, integral_type(k), frontier[k], buf);
+            assert_same_outputs<output_type>(expected, buf, n, k * n);
+        }
+    }
+}
+
+TYPED_TEST_P(EvalSubtreeTest, Throws)
+{
+    using dpf_type = typename TestFixture::dpf_type;
+    using integral_type = typename dpf_type::integral_type;
+    constexpr auto depth = dpf_type::depth;
+
+    auto [x, y] = this->params.front();
+    auto [dpf0, dpf1] = dpf::make_dpf(x, y);
+    ASSERT_THROW(dpf::export_frontier(dpf0, depth + 1), std::invalid_argument);
+    ASSERT_THROW(dpf::eval_subtree(dpf0, depth + 1, integral_type(0), dpf0.root()),
+        std::invalid_argument);
+    ASSERT_THROW(dpf::eval_subtree(dpf0, 2, integral_type(4), dpf0.root()),
+        std::invalid_argument);
+}
+
+REGISTER_TYPED_TEST_SUITE_P(EvalSubtreeTest,
+    MatchesEvalFull,
+    Outbuf,
+    Throws);
+using Types = testing::Types
+<
+    // base test
+    test_type<uint16_t, uint64_t>,
+
+    // test input types
+    test_type<int16_t, uint64_t>,
+    test_type<uint8_t, uint64_t>,
+    test_type<dpf::bitstring<10>, uint64_t>,
+    test_type<dpf::keyword<3, dpf::alphabets::hex>, uint64_t>,
+    test_type<dpf::modint<10>, uint64_t>,
+    test_type<dpf::xor_wrapper<int16_t>, uint64_t>,
+    test_type<dpf::xor_wrapper<uint16_t>, uint64_t>,
+
+    // test output types
+    test_type<uint16_t, int64_t>,
+    test_type<uint16_t, uint8_t>,
+    test_type<uint16_t, simde_int128>,
+    test_type<uint16_t, simde_uint128>,
+    test_type<uint16_t, dpf::bit>,
+    test_type<uint16_t, dpf::bitstring<20, uint8_t>>,
+    test_type<uint16_t, dpf::bitstring<150>>,
+    test_type<uint16_t, dpf::xor_wrapper<int64_t>>,
+    test_type<uint16_t, dpf::xor_wrapper<uint64_t>>,
+
+    // custom types
+    test_type<custom_input_type, uint64_t>,
+    test_type<uint16_t, custom_output_type_small>,
+    test_type<uint16_t, custom_output_type_large_plus_minus>,
+    test_type<uint16_t, custom_output_type_large_xor>
+>;
+INSTANTIATE_TYPED_TEST_SUITE_P(EvalSubtreeTestInstantiation, EvalSubtreeTest, Types);
+
+// with 64-bit inputs and 128-bit outputs the depth is the full bitlength of
+// `integral_type`, which `export_frontier` and `eval_subtree` must not
+// shift by
+TEST(EvalSubtreeFullWidthTest, Depth64)
+{
+    for (uint64_t x : { uint64_t(0x0000000000000000), uint64_t(0x5555555555555555),
+                        uint64_t(0x8000000000000000), uint64_t(0xFFFFFFFFFFFFFFFF) })
+    {
+        auto [dpf0, dpf1] = dpf::make_dpf(x, simde_uint128(1));
+        using dpf_type = decltype(dpf0);
+        static_assert(dpf_type::depth == 64);
+
+        for (std::size_t level : { 0, 1, 4 })
+        {
+            auto frontier0 = dpf::export_frontier(dpf0, level),
+                 frontier1 = dpf::export_frontier(dpf1, level);
+            ASSERT_EQ(frontier0.size(), std::size_t(1) << level);
+            ASSERT_EQ(frontier1.size(), std::size_t(1) << level);
+
+            // the shares agree everywhere except on the path to `x`
+            std::size_t on_path = level ? x >> (64 - level) : 0;
+            for (std::size_t k = 0; k < frontier0.size(); ++k)
+            {
+                bool same = std::memcmp(&frontier0[k], &frontier1[k], sizeof(frontier0[k])) == 0;
+                ASSERT_EQ(same, k != on_path);
+            }
+        }
+
+        ASSERT_THROW(dpf::eval_subtree(dpf0, 0, uint64_t(0), dpf0.root()),
+            std::length_error);
+    }
+}
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include "dpf.hpp"
+
+#include "helpers/eval_common_data.hpp"
+
+template <typename T>
+struct HalfTreeDpfKeyTest : public testing::Test
+{
+  public:
+    using input_type = typename std::tuple_element_t<0, T>;
+    using output_type = typename std::tuple_element_t<1, T>;
+    using integral_type = dpf::utils::integral_type_from_bitlength_t<dpf::utils::bitlength_of_v<input_type>>;
+    using dpf_type = dpf::utils::half_tree_dpf_type_t<dpf::prg::aes128, dpf::prg::aes128, input_type, output_type>;
+
+  protected:
+    HalfTreeDpfKeyTest()
+      : params{std::get<std::vector<T>>(allParams)},
+        range{std::size_t(1) << dpf::utils::bitlength_of_v<input_type>},
+        zero_output{from_integral_type_output(0)}
+    { }
+
+    void SetUp() override
+    { }
+
+    void TearDown() override
+    { }
+
+    void assert_output(const input_type & x, const output_type & y,
+        const input_type & cur, const output_type & y0, const output_type & y1)
+    {
+        if (cur == x)
+        {
+            ASSERT_EQ(static_cast<output_type>(y1 - y0), y);
+        }
+        else
+        {
+            ASSERT_EQ(static_cast<output_type>(y1 - y0), zero_output);
+        }
+    }
+
+    template <typename IterableT>
+    void assert_wrapper(const input_type & x, const output_type & y,
+        IterableT & iter0, IterableT & iter1)  // NOLINT(runtime/references)
+    {
+        auto it0 = std::begin(iter0),
+             it1 = std::begin(iter1);
+        input_type cur = std::numeric_limits<input_type>::min();
+        for (std::size_t i = 0; i < range; ++i, ++cur, ++it0, ++it1)
+        {
+            assert_output(x, y, cur, *it0, *it1);
+        }
+    }
+
+    static constexpr auto from_integral_type = dpf::utils::make_from_integral_value<input_type>{};
+    static constexpr auto from_integral_type_output = dpf::utils::make_from_integral_value<output_type>{};
+
+    std::vector<T> params;
+    std::size_t range;
+    output_type zero_output;
+};
+
+TYPED_TEST_SUITE_P(HalfTreeDpfKeyTest);
+
+TYPED_TEST_P(HalfTreeDpfKeyTest, EvalPoint)
+{
+    using input_type = typename TestFixture::input_type;
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_half_tree_dpf(x, y);
+        input_type cur = std::numeric_limits<input_type>::min();
+        for (std::size_t i = 0; i < this->range; ++i, ++cur)
+        {
+            this->assert_output(x, y, cur, dpf::eval_point(dpf0, cur),
+                dpf::eval_point(dpf1, cur));
+        }
+    }
+}
+
+TYPED_TEST_P(HalfTreeDpfKeyTest, EvalInterval)
+{
+    using input_type = typename TestFixture::input_type;
+    auto from = std::numeric_limits<input_type>::min(),
+         to = std::numeric_limits<input_type>::max();
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_half_tree_dpf(x, y);
+        auto [buf0, iter0] = dpf::eval_interval(dpf0, from, to);
+        auto [buf1, iter1] = dpf::eval_interval(dpf1, from, to);
+
+        this->assert_wrapper(x, y, iter0, iter1);
+    }
+}
+
+TYPED_TEST_P(HalfTreeDpfKeyTest, EvalFull)
+{
+    using dpf_type = typename TestFixture::dpf_type;
+    auto memo0 = dpf::make_basic_full_memoizer<dpf_type>(),
+         memo1 = dpf::make_basic_full_memoizer<dpf_type>();
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_half_tree_dpf(x, y);
+        auto [buf0, iter0] = dpf::eval_full(dpf0, memo0);
+        auto [buf1, iter1] = dpf::eval_full(dpf1, memo1);
+
+        this->assert_wrapper(x, y, iter0, iter1);
+    }
+}
+
+TYPED_TEST_P(HalfTreeDpfKeyTest, EvalSequence)
+{
+    using input_type = typename TestFixture::input_type;
+    using integral_type = typename TestFixture::integral_type;
+
+    std::set<input_type> point_set;
+    for (auto [x, y] : this->params)
+    {
+        point_set.insert(x);
+    }
+    while (point_set.size() < std::min(this->range, std::size_t(200)))
+    {
+        point_set.emplace(this->from_integral_type(dpf::uniform_sample<integral_type>()));
+    }
+    std::vector<input_type> points(point_set.begin(), point_set.end());
+
+    for (auto [x, y] : this->params)
+    {
+        auto [dpf0, dpf1] = dpf::make_half_tree_dpf(x, y);
+        auto [buf0, iter0] = dpf::eval_sequence(dpf0, points.begin(), points.end());
+        auto [buf1, iter1] = dpf::eval_sequence(dpf1, points.begin(), points.end());
+
+        auto it0 = std::begin(iter0),
+             it1 = std::begin(iter1);
+        for (auto cur = points.cbegin(); cur != points.cend(); ++cur, ++it0, ++it1)
+        {
+            this->assert_output(x, y, *cur, *it0, *it1);
+        }
+    }
+}
+
+REGISTER_TYPED_TEST_SUITE_P(HalfTreeDpfKeyTest,
+    EvalPoint,
+    EvalInterval,
+    EvalFull,
+    EvalSequence);
+using Types = testing::Types
+<
+    // base test
+    test_type<uint16_t, uint64_t>,
+
+    // test input types
+    test_type<int16_t, uint64_t>,
+    test_type<uint8_t, uint64_t>,
+    test_type<dpf::modint<10>, uint64_t>,
+
+    // test output types
+    test_type<uint16_t, uint8_t>,
+    test_type<uint16_t, simde_uint128>,
+    test_type<uint16_t, dpf::bit>,
+    test_type<uint16_t, dpf::bitstring<150>>,
+    test_type<uint16_t, dpf::xor_wrapper<uint64_t>>
+>;
+INSTANTIATE_TYPED_TEST_SUITE_P(HalfTreeDpfKeyTestInstantiation, HalfTreeDpfKeyTest, Types);
+
+TEST(HalfTreeDpfKeyPrgTest, OneInteriorCallPerParent)
+{
+    using interior_prg = dpf::prg::counter_wrapper<dpf::prg::aes128>;
+    auto [dpf0, dpf1] = dpf::make_half_tree_dpf<interior_prg, dpf::prg::aes128>(uint16_t(12345), uint64_t(1));
+    using dpf_type = std::decay_t<decltype(dpf0)>;
+    constexpr std::size_t interior_nodes = (std::size_t(1) << dpf_type::depth) - 1;
+
+    auto before = interior_prg::count();
+    auto [buf0, iter0] = dpf::eval_full(dpf0);
+    ASSERT_EQ(interior_prg::count() - before, interior_nodes);
+}
@@ -0,0 +1,35 @@
+#ifndef LIBDPF_TEST_TESTS_HELPERS_ASSERT_SAME_OUTPUTS_HPP__
+#define LIBDPF_TEST_TESTS_HELPERS_ASSERT_SAME_OUTPUTS_HPP__
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+
+// asserts that `y0` and `y1` are bytewise equal
+template <typename OutputT>
+void assert_same_output(const OutputT & y0, const OutputT & y1)
+{
+    ASSERT_EQ(std::memcmp(&y0, &y1, sizeof(OutputT)), 0);
+}
+
+// asserts that the first `count` outputs of `actual` are bytewise equal to
+// outputs `[first, first+count)` of `expected`
+template <typename OutputT,
+          typename IterableT0,
+          typename IterableT1>
+void assert_same_outputs(IterableT0 && expected, IterableT1 && actual,
+    std::size_t count, std::size_t first = 0)
+{
+    auto it0 = std::begin(expected);
+    std::advance(it0, first);
+    auto it1 = std::begin(actual);
+    for (std::size_t i = 0; i < count; ++i, ++it0, ++it1)
+    {
+        OutputT y0 = *it0, y1 = *it1;
+        ASSERT_EQ(std::memcmp(&y0, &y1, sizeof(OutputT)), 0);
+    }
+}
+
+#endif  // LIBDPF_TEST_TESTS_HELPERS_ASSERT_SAME_OUTPUTS_HPP__
@@ -15,7 +15,7 @@ template <typename InputT,
 using param_type = std::vector<test_type<InputT, OutputT>>;
 
 using dpf::literals::operator""_bitstring;
-using dpf::literals::operator""_bitstring_8;
+using dpf::literals::operator""_bitstring_u8;
 
 static std::tuple
 <
@@ -451,30 +451,30 @@ static std::tuple
         std::make_tuple(uint16_t(0xFFFF), dpf::bit::one)
     },
     {
-        std::make_tuple(uint16_t(0x0000), 00000000000000000001_bitstring_8),
-        std::make_tuple(uint16_t(0x0000), 01010101010101010101_bitstring_8),
-        std::make_tuple(uint16_t(0x0000), 10101010101010101010_bitstring_8),
-        std::make_tuple(uint16_t(0x0000), 11111111111111111111_bitstring_8),
-        std::make_tuple(uint16_t(0x5555), 00000000000000000001_bitstring_8),
-        std::make_tuple(uint16_t(0x5555), 01010101010101010101_bitstring_8),
-        std::make_tuple(uint16_t(0x5555), 10101010101010101010_bitstring_8),
-        std::make_tuple(uint16_t(0x5555), 11111111111111111111_bitstring_8),
-        std::make_tuple(uint16_t(0x7FFF), 00000000000000000001_bitstring_8),
-        std::make_tuple(uint16_t(0x7FFF), 01010101010101010101_bitstring_8),
-        std::make_tuple(uint16_t(0x7FFF), 10101010101010101010_bitstring_8),
-        std::make_tuple(uint16_t(0x7FFF), 11111111111111111111_bitstring_8),
-        std::make_tuple(uint16_t(0x8000), 00000000000000000001_bitstring_8),
-        std::make_tuple(uint16_t(0x8000), 01010101010101010101_bitstring_8),
-        std::make_tuple(uint16_t(0x8000), 10101010101010101010_bitstring_8),
-        std::make_tuple(uint16_t(0x8000), 11111111111111111111_bitstring_8),
-        std::make_tuple(uint16_t(0xAAAA), 00000000000000000001_bitstring_8),
-        std::make_tuple(uint16_t(0xAAAA), 01010101010101010101_bitstring_8),
-        std::make_tuple(uint16_t(0xAAAA), 10101010101010101010_bitstring_8),
-        std::make_tuple(uint16_t(0xAAAA), 11111111111111111111_bitstring_8),
-        std::make_tuple(uint16_t(0xFFFF), 00000000000000000001_bitstring_8),
-        std::make_tuple(uint16_t(0xFFFF), 01010101010101010101_bitstring_8),
-        std::make_tuple(uint16_t(0xFFFF), 10101010101010101010_bitstring_8),
-        std::make_tuple(uint16_t(0xFFFF), 11111111111111111111_bitstring_8)
+        std::make_tuple(uint16_t(0x0000), 00000000000000000001_bitstring_u8),
+        std::make_tuple(uint16_t(0x0000), 01010101010101010101_bitstring_u8),
+        std::make_tuple(uint16_t(0x0000), 10101010101010101010_bitstring_u8),
+        std::make_tuple(uint16_t(0x0000), 11111111111111111111_bitstring_u8),
+        std::make_tuple(uint16_t(0x5555), 00000000000000000001_bitstring_u8),
+        std::make_tuple(uint16_t(0x5555), 01010101010101010101_bitstring_u8),
+        std::make_tuple(uint16_t(0x5555), 10101010101010101010_bitstring_u8),
+        std::make_tuple(uint16_t(0x5555), 11111111111111111111_bitstring_u8),
+        std::make_tuple(uint16_t(0x7FFF), 00000000000000000001_bitstring_u8),
+        std::make_tuple(uint16_t(0x7FFF), 01010101010101010101_bitstring_u8),
+        std::make_tuple(uint16_t(0x7FFF), 10101010101010101010_bitstring_u8),
+        std::make_tuple(uint16_t(0x7FFF), 11111111111111111111_bitstring_u8),
+        std::make_tuple(uint16_t(0x8000), 00000000000000000001_bitstring_u8),
+        std::make_tuple(uint16_t(0x8000), 01010101010101010101_bitstring_u8),
+        std::make_tuple(uint16_t(0x8000), 10101010101010101010_bitstring_u8),
+        std::make_tuple(uint16_t(0x8000), 11111111111111111111_bitstring_u8),
+        std::make_tuple(uint16_t(0xAAAA), 00000000000000000001_bitstring_u8),
+        std::make_tuple(uint16_t(0xAAAA), 01010101010101010101_bitstring_u8),
+        std::make_tuple(uint16_t(0xAAAA), 10101010101010101010_bitstring_u8),
+        std::make_tuple(uint16_t(0xAAAA), 11111111111111111111_bitstring_u8),
+        std::make_tuple(uint16_t(0xFFFF), 00000000000000000001_bitstring_u8),
+        std::make_tuple(uint16_t(0xFFFF), 01010101010101010101_bitstring_u8),
+        std::make_tuple(uint16_t(0xFFFF), 10101010101010101010_bitstring_u8),
+        std::make_tuple(uint16_t(0xFFFF), 11111111111111111111_bitstring_u8)
     },
     {
         std::make_tuple(uint16_t(0x0000), 000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000001_bitstring),
@@ -29,7 +29,7 @@ template <typename InputT,
 using multi_param_type = std::vector<multi_test_type<InputT, OutputT0, OutputT1, OutputT2, OutputT3>>;
 
 using dpf::literals::operator""_bitstring;
-using dpf::literals::operator""_bitstring_8;
+using dpf::literals::operator""_bitstring_u8;
 
 static std::tuple
 <
@@ -487,30 +487,30 @@ static std::tuple
                                           dpf::bit::one)
     },
     {
-        std::make_tuple(uint16_t(0x0000), 00000000000000000001_bitstring_8,
-                                          01010101010101010101_bitstring_8,
-                                          10101010101010101010_bitstring_8,
-                                          11111111111111111111_bitstring_8),
-        std::make_tuple(uint16_t(0x5555), 00000000000000000001_bitstring_8,
-                                          01010101010101010101_bitstring_8,
-                                          10101010101010101010_bitstring_8,
-                                          11111111111111111111_bitstring_8),
-        std::make_tuple(uint16_t(0x7FFF), 00000000000000000001_bitstring_8,
-                                          01010101010101010101_bitstring_8,
-                                          10101010101010101010_bitstring_8,
-                                          11111111111111111111_bitstring_8),
-        std::make_tuple(uint16_t(0x8000), 00000000000000000001_bitstring_8,
-                                          01010101010101010101_bitstring_8,
-                                          10101010101010101010_bitstring_8,
-                                          11111111111111111111_bitstring_8),
-        std::make_tuple(uint16_t(0xAAAA), 00000000000000000001_bitstring_8,
-                                          01010101010101010101_bitstring_8,
-                                          10101010101010101010_bitstring_8,
-                                          11111111111111111111_bitstring_8),
-        std::make_tuple(uint16_t(0xFFFF), 00000000000000000001_bitstring_8,
-                                          01010101010101010101_bitstring_8,
-                                          10101010101010101010_bitstring_8,
-                                          11111111111111111111_bitstring_8)
+        std::make_tuple(uint16_t(0x0000), 00000000000000000001_bitstring_u8,
+                                          01010101010101010101_bitstring_u8,
+                                          10101010101010101010_bitstring_u8,
+                                          11111111111111111111_bitstring_u8),
+        std::make_tuple(uint16_t(0x5555), 00000000000000000001_bitstring_u8,
+                                          01010101010101010101_bitstring_u8,
+                                          10101010101010101010_bitstring_u8,
+                                          11111111111111111111_bitstring_u8),
+        std::make_tuple(uint16_t(0x7FFF), 00000000000000000001_bitstring_u8,
+                                          01010101010101010101_bitstring_u8,
+                                          10101010101010101010_bitstring_u8,
+                                          11111111111111111111_bitstring_u8),
+        std::make_tuple(uint16_t(0x8000), 00000000000000000001_bitstring_u8,
+                                          01010101010101010101_bitstring_u8,
+                                          10101010101010101010_bitstring_u8,
+                                          11111111111111111111_bitstring_u8),
+        std::make_tuple(uint16_t(0xAAAA), 00000000000000000001_bitstring_u8,
+                                          01010101010101010101_bitstring_u8,
+                                          10101010101010101010_bitstring_u8,
+                                          11111111111111111111_bitstring_u8),
+        std::make_tuple(uint16_t(0xFFFF), 00000000000000000001_bitstring_u8,
+                                          01010101010101010101_bitstring_u8,
+                                          10101010101010101010_bitstring_u8,
+                                          11111111111111111111_bitstring_u8)
     },
     {
         std::make_tuple(uint16_t(0x0000), 000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000001_bitstring,
@@ -697,99 +697,99 @@ static std::tuple
     {
         std::make_tuple(uint16_t(0x0000), uint32_t(0x00000001),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0x00000001)),
-                                          00000000000000000001_bitstring_8,
+                                          00000000000000000001_bitstring_u8,
                                           00000000000000000000000000000001_bitstring),
         std::make_tuple(uint16_t(0x0000), uint32_t(0x55555555),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0x55555555)),
-                                          01010101010101010101_bitstring_8,
+                                          01010101010101010101_bitstring_u8,
                                           01010101010101010101010101010101_bitstring),
         std::make_tuple(uint16_t(0x0000), uint32_t(0xAAAAAAAA),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0xAAAAAAAA)),
-                                          10101010101010101010_bitstring_8,
+                                          10101010101010101010_bitstring_u8,
                                           10101010101010101010101010101010_bitstring),
         std::make_tuple(uint16_t(0x0000), uint32_t(0xFFFFFFFF),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0xFFFFFFFF)),
-                                          11111111111111111111_bitstring_8,
+                                          11111111111111111111_bitstring_u8,
                                           11111111111111111111111111111111_bitstring),
         std::make_tuple(uint16_t(0x5555), uint32_t(0x00000001),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0x00000001)),
-                                          00000000000000000001_bitstring_8,
+                                          00000000000000000001_bitstring_u8,
                                           00000000000000000000000000000001_bitstring),
         std::make_tuple(uint16_t(0x5555), uint32_t(0x55555555),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0x55555555)),
-                                          01010101010101010101_bitstring_8,
+                                          01010101010101010101_bitstring_u8,
                                           01010101010101010101010101010101_bitstring),
         std::make_tuple(uint16_t(0x5555), uint32_t(0xAAAAAAAA),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0xAAAAAAAA)),
-                                          10101010101010101010_bitstring_8,
+                                          10101010101010101010_bitstring_u8,
                                           10101010101010101010101010101010_bitstring),
         std::make_tuple(uint16_t(0x5555), uint32_t(0xFFFFFFFF),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0xFFFFFFFF)),
-                                          11111111111111111111_bitstring_8,
+                                          11111111111111111111_bitstring_u8,
                                           11111111111111111111111111111111_bitstring),
         std::make_tuple(uint16_t(0x7FFF), uint32_t(0x00000001),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0x00000001)),
-                                          00000000000000000001_bitstring_8,
+                                          00000000000000000001_bitstring_u8,
                                           00000000000000000000000000000001_bitstring),
         std::make_tuple(uint16_t(0x7FFF), uint32_t(0x55555555),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0x55555555)),
-                                          01010101010101010101_bitstring_8,
+                                          01010101010101010101_bitstring_u8,
                                           01010101010101010101010101010101_bitstring),
         std::make_tuple(uint16_t(0x7FFF), uint32_t(0xAAAAAAAA),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0xAAAAAAAA)),
-                                          10101010101010101010_bitstring_8,
+                                          10101010101010101010_bitstring_u8,
                                           10101010101010101010101010101010_bitstring),
         std::make_tuple(uint16_t(0x7FFF), uint32_t(0xFFFFFFFF),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0xFFFFFFFF)),
-                                          11111111111111111111_bitstring_8,
+                                          11111111111111111111_bitstring_u8,
                                           11111111111111111111111111111111_bitstring),
         std::make_tuple(uint16_t(0x8000), uint32_t(0x00000001),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0x00000001)),
-                                          00000000000000000001_bitstring_8,
+                                          00000000000000000001_bitstring_u8,
                                           00000000000000000000000000000001_bitstring),
         std::make_tuple(uint16_t(0x8000), uint32_t(0x55555555),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0x55555555)),
-                                          01010101010101010101_bitstring_8,
+                                          01010101010101010101_bitstring_u8,
                                           01010101010101010101010101010101_bitstring),
         std::make_tuple(uint16_t(0x8000), uint32_t(0xAAAAAAAA),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0xAAAAAAAA)),
-                                          10101010101010101010_bitstring_8,
+                                          10101010101010101010_bitstring_u8,
                                           10101010101010101010101010101010_bitstring),
         std::make_tuple(uint16_t(0x8000), uint32_t(0xFFFFFFFF),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0xFFFFFFFF)),
-                                          11111111111111111111_bitstring_8,
+                                          11111111111111111111_bitstring_u8,
                                           11111111111111111111111111111111_bitstring),
         std::make_tuple(uint16_t(0xAAAA), uint32_t(0x00000001),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0x00000001)),
-                                          00000000000000000001_bitstring_8,
+                                          00000000000000000001_bitstring_u8,
                                           00000000000000000000000000000001_bitstring),
         std::make_tuple(uint16_t(0xAAAA), uint32_t(0x55555555),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0x55555555)),
-                                          01010101010101010101_bitstring_8,
+                                          01010101010101010101_bitstring_u8,
                                           01010101010101010101010101010101_bitstring),
         std::make_tuple(uint16_t(0xAAAA), uint32_t(0xAAAAAAAA),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0xAAAAAAAA)),
-                                          10101010101010101010_bitstring_8,
+                                          10101010101010101010_bitstring_u8,
                                           10101010101010101010101010101010_bitstring),
         std::make_tuple(uint16_t(0xAAAA), uint32_t(0xFFFFFFFF),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0xFFFFFFFF)),
-                                          11111111111111111111_bitstring_8,
+                                          11111111111111111111_bitstring_u8,
                                           11111111111111111111111111111111_bitstring),
         std::make_tuple(uint16_t(0xFFFF), uint32_t(0x00000001),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0x00000001)),
-                                          00000000000000000001_bitstring_8,
+                                          00000000000000000001_bitstring_u8,
                                           00000000000000000000000000000001_bitstring),
         std::make_tuple(uint16_t(0xFFFF), uint32_t(0x55555555),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0x55555555)),
-                                          01010101010101010101_bitstring_8,
+                                          01010101010101010101_bitstring_u8,
                                           01010101010101010101010101010101_bitstring),
         std::make_tuple(uint16_t(0xFFFF), uint32_t(0xAAAAAAAA),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0xAAAAAAAA)),
-                                          10101010101010101010_bitstring_8,
+                                          10101010101010101010_bitstring_u8,
                                           10101010101010101010101010101010_bitstring),
         std::make_tuple(uint16_t(0xFFFF), uint32_t(0xFFFFFFFF),
                                           dpf::xor_wrapper<uint32_t>(uint32_t(0xFFFFFFFF)),
-                                          11111111111111111111_bitstring_8,
+                                          11111111111111111111_bitstring_u8,
                                           11111111111111111111111111111111_bitstring)
     },
 };
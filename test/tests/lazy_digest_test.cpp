@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "dpf.hpp"
+
+TEST(LazyDigestTest, ConcurrentGetComputesOnce)
+{
+    static constexpr std::size_t num_threads = 8;
+    dpf::utils::lazy_digest<> digest;
+    std::atomic_size_t calls{0};
+    std::atomic_bool go{false};
+    auto compute = [&calls]()
+    {
+        ++calls;
+        // keep the other threads waiting on the computing state for a while
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        dpf::digest_type d{};
+        d[0] = 0x2a;
+        return d;
+    };
+
+    std::vector<const dpf::digest_type *> seen(num_threads);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            while (!go.load()) std::this_thread::yield();
+            seen[t] = &digest.get(compute);
+        });
+    }
+    go.store(true);
+    for (auto & thread : threads) thread.join();
+
+    ASSERT_EQ(calls.load(), 1);
+    for (auto d : seen)
+    {
+        ASSERT_EQ(d, seen[0]);
+        ASSERT_EQ((*d)[0], 0x2a);
+    }
+    ASSERT_EQ(digest.get(compute)[0], 0x2a);
+    ASSERT_EQ(calls.load(), 1);
+}
+
+TEST(LazyDigestTest, MoveKeepsDigest)
+{
+    std::size_t calls = 0;
+    auto compute = [&calls]()
+    {
+        dpf::digest_type d{};
+        d[0] = static_cast<psnip_uint8_t>(++calls);
+        return d;
+    };
+
+    // a computed digest moves with the object, and the source keeps it
+    dpf::utils::lazy_digest<> digest0;
+    ASSERT_EQ(digest0.get(compute)[0], 1);
+    dpf::utils::lazy_digest<> digest1{std::move(digest0)}, digest2;
+    ASSERT_EQ(digest1.get(compute)[0], 1);
+    ASSERT_EQ(digest0.get(compute)[0], 1);
+    digest2 = std::move(digest1);
+    ASSERT_EQ(digest2.get(compute)[0], 1);
+    ASSERT_EQ(calls, 1);
+
+    // one that was never computed is computed on first use after the move
+    dpf::utils::lazy_digest<> digest3, digest4{std::move(digest3)};
+    ASSERT_EQ(digest4.get(compute)[0], 2);
+}
+
+TEST(LazyDigestTest, MovedKeyKeepsHashes)
+{
+    auto [dpf0, dpf1] = dpf::make_dpf(uint16_t(1234), uint64_t(42));
+    using dpf_type = decltype(dpf0);
+
+    auto common_part_hash = dpf0.common_part_hash();
+    auto interior_hash = dpf0.interior_hash();
+    ASSERT_EQ(common_part_hash, dpf::utils::get_common_part_hash(dpf0));
+    ASSERT_EQ(interior_hash, dpf::utils::get_interior_hash(dpf0));
+
+    // dpf0's hashes were computed before the move; dpf1's were not
+    dpf_type moved0{std::move(dpf0)}, moved1{std::move(dpf1)};
+    ASSERT_EQ(moved0.common_part_hash(), common_part_hash);
+    ASSERT_EQ(moved0.interior_hash(), interior_hash);
+    ASSERT_EQ(moved1.common_part_hash(), dpf::utils::get_common_part_hash(moved1));
+    ASSERT_EQ(moved1.interior_hash(), interior_hash);
+}
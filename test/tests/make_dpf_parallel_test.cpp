@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "asio.hpp"
+#define LIBDPF_HAS_ASIO
+#include "dpf.hpp"
+
+bool do_quickack = false;
+
+struct MakeDpfParallelTest : public testing::Test
+{
+  public:
+    using input_type = uint16_t;
+    using output_type = uint64_t;
+    using dpf_type = dpf::utils::dpf_type_t<dpf::prg::aes128, dpf::prg::aes128, input_type, output_type>;
+    using socket_type = asio::local::stream_protocol::socket;
+
+  protected:
+    MakeDpfParallelTest()
+      : writer0{io_context}, reader0{io_context},
+        writer1{io_context}, reader1{io_context}
+    {
+        asio::local::connect_pair(writer0, reader0);
+        asio::local::connect_pair(writer1, reader1);
+    }
+
+    // reads `count` keys from each reader on its own thread while `write`
+    // runs on this one, so that neither side can fill a socket buffer and
+    // stall the other
+    template <typename Write>
+    void exchange(std::size_t count, Write && write)
+    {
+        std::thread thread0([this, count]() { dpf::asio::read_dpf<dpf_type>(reader0, dpfs0, count); });
+        std::thread thread1([this, count]() { dpf::asio::read_dpf<dpf_type>(reader1, dpfs1, count); });
+        write();
+        thread0.join();
+        thread1.join();
+    }
+
+    asio::io_context io_context;
+    socket_type writer0, reader0, writer1, reader1;
+    std::vector<dpf_type> dpfs0, dpfs1;
+};
+
+TEST_F(MakeDpfParallelTest, KeysReconstruct)
+{
+    static constexpr std::size_t count = 200;
+    input_type x = 0xBEEF;
+    output_type y = 0xDEADBEEFCAFEBABE;
+    auto args = dpf::make_dpfargs(x, y);
+
+    // more keys than ring slots, so the workers must wait on the writer
+    for (std::size_t threads : { 1, 3 })
+    {
+        dpfs0.clear();
+        dpfs1.clear();
+        exchange(count, [&]()
+        {
+            auto [bytes_written0, bytes_written1, num_written]
+                = dpf::asio::make_dpf_parallel(writer0, writer1, count, args, threads);
+            ASSERT_EQ(num_written, count);
+            ASSERT_EQ(bytes_written0, bytes_written1);
+        });
+
+        ASSERT_EQ(dpfs0.size(), count);
+        ASSERT_EQ(dpfs1.size(), count);
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            ASSERT_EQ(dpf::eval_point(dpfs1[k], x) - dpf::eval_point(dpfs0[k], x), y);
+            ASSERT_EQ(dpf::eval_point(dpfs1[k], input_type(x + 1)), dpf::eval_point(dpfs0[k], input_type(x + 1)));
+        }
+    }
+}
+
+TEST_F(MakeDpfParallelTest, ClosedPeer)
+{
+    static constexpr std::size_t count = 100;
+    auto args = dpf::make_dpfargs(input_type(1234), output_type(1));
+
+    reader0.close();
+    asio::error_code error{};
+    auto [bytes_written0, bytes_written1, num_written]
+        = dpf::asio::make_dpf_parallel(writer0, writer1, count, args, 3, error);
+    ASSERT_TRUE(error);
+    ASSERT_EQ(num_written, 0);
+    ASSERT_EQ(bytes_written1, 0);
+
+    ASSERT_THROW(dpf::asio::make_dpf_parallel(writer0, writer1, count, args, 3), asio::error_code);
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include "dpf.hpp"
+
+namespace
+{
+
+// a deterministic root sampler, so that `make_dpf` and `make_dpfs` can be
+// made to draw the same roots
+psnip_uint64_t sampled_roots = 0;
+
+simde__m128i counting_root_sampler()
+{
+    return simde_mm_set_epi64x(0x0123456789abcdef, ++sampled_roots);
+}
+
+}  // namespace
+
+template <typename T>
+struct MakeDpfsTest : public testing::Test
+{
+  public:
+    using input_type = typename std::tuple_element_t<0, T>;
+    using output_type = typename std::tuple_element_t<1, T>;
+    using integral_type = dpf::utils::integral_type_from_bitlength_t<dpf::utils::bitlength_of_v<input_type>>;
+    using dpf_type = dpf::utils::dpf_type_t<dpf::prg::aes128, dpf::prg::aes128, input_type, output_type>;
+    using args_type = decltype(dpf::make_dpfargs(std::declval<input_type>(), std::declval<output_type>()));
+
+  protected:
+    std::vector<args_type> make_args(std::size_t count)
+    {
+        std::vector<args_type> args;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            args.push_back(dpf::make_dpfargs(from_integral_type(dpf::uniform_sample<integral_type>()),
+                from_integral_type_output(i + 1)));
+        }
+        return args;
+    }
+
+    static void assert_same(const dpf_type & a, const dpf_type & b)
+    {
+        auto root_a = a.root(), root_b = b.root();
+        ASSERT_EQ(std::memcmp(&root_a, &root_b, sizeof(root_a)), 0);
+        ASSERT_EQ(std::memcmp(std::data(a.correction_words()), std::data(b.correction_words()),
+            sizeof(a.correction_words())), 0);
+        ASSERT_EQ(a.correction_advice(), b.correction_advice());
+        ASSERT_EQ(a.common_part_hash(), b.common_part_hash());
+    }
+
+    static constexpr auto from_integral_type = dpf::utils::make_from_integral_value<input_type>{};
+    static constexpr auto from_integral_type_output = dpf::utils::make_from_integral_value<output_type>{};
+};
+
+TYPED_TEST_SUITE_P(MakeDpfsTest);
+
+TYPED_TEST_P(MakeDpfsTest, MatchesMakeDpf)
+{
+    for (std::size_t count : { 0, 1, 37, 70 })
+    {
+        auto args = this->make_args(count);
+
+        sampled_roots = 0;
+        auto [dpfs0, dpfs1] = dpf::make_dpfs(args, &counting_root_sampler);
+        ASSERT_EQ(std::size(dpfs0), count);
+        ASSERT_EQ(std::size(dpfs1), count);
+
+        sampled_roots = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto [dpf0, dpf1] = dpf::make_dpf(args[i], &counting_root_sampler);
+            this->assert_same(dpfs0[i], dpf0);
+            this->assert_same(dpfs1[i], dpf1);
+        }
+    }
+}
+
+TYPED_TEST_P(MakeDpfsTest, Reconstructs)
+{
+    using input_type = typename TestFixture::input_type;
+    using output_type = typename TestFixture::output_type;
+
+    auto args = this->make_args(40);
+    auto [dpfs0, dpfs1] = dpf::make_dpfs(args);
+    for (std::size_t i = 0; i < std::size(args); ++i)
+    {
+        input_type x = args[i].x, other = x;
+        ++other;
+        output_type y0 = dpf::eval_point(dpfs0[i], x),
+                    y1 = dpf::eval_point(dpfs1[i], x);
+        ASSERT_EQ(static_cast<output_type>(y1 - y0), std::get<0>(args[i].y));
+        y0 = dpf::eval_point(dpfs0[i], other);
+        y1 = dpf::eval_point(dpfs1[i], other);
+        ASSERT_EQ(static_cast<output_type>(y1 - y0), this->from_integral_type_output(0));
+    }
+}
+
+REGISTER_TYPED_TEST_SUITE_P(MakeDpfsTest,
+    MatchesMakeDpf,
+    Reconstructs);
+
+using Types = testing::Types
+<
+    std::tuple<uint8_t, uint64_t>,
+    std::tuple<int16_t, uint16_t>,
+    std::tuple<uint32_t, uint32_t>,
+    std::tuple<uint64_t, uint64_t>,
+    std::tuple<dpf::modint<10>, uint64_t>,
+    std::tuple<simde_uint128, simde_uint128>
+>;
+INSTANTIATE_TYPED_TEST_SUITE_P(MakeDpfsTestInstantiation, MakeDpfsTest, Types);
+
+// three one-block outputs put leaf blocks at positions 0, 1 and 2, so the
+// bulk leaf expansion must use positions past the two `eval01` children
+TEST(MakeDpfsMultiTest, MatchesMakeDpf)
+{
+    using args_type = decltype(dpf::make_dpfargs(uint16_t{}, uint64_t{}, simde_uint128{}, simde_uint128{}));
+    std::vector<args_type> args;
+    for (std::size_t i = 0; i < 37; ++i)
+    {
+        args.push_back(dpf::make_dpfargs(dpf::uniform_sample<uint16_t>(), uint64_t(i),
+            simde_uint128(2*i), simde_uint128(2*i+1)));
+    }
+
+    sampled_roots = 0;
+    auto [dpfs0, dpfs1] = dpf::make_dpfs(args, &counting_root_sampler);
+    sampled_roots = 0;
+    for (std::size_t i = 0; i < std::size(args); ++i)
+    {
+        auto [dpf0, dpf1] = dpf::make_dpf(args[i], &counting_root_sampler);
+        ASSERT_EQ(dpfs0[i].common_part_hash(), dpf0.common_part_hash());
+        ASSERT_EQ(dpfs1[i].common_part_hash(), dpf1.common_part_hash());
+    }
+}
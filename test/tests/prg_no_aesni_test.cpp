@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+// this file is compiled with -mno-aes (see CMakeLists.txt): including
+// dpf.hpp, initializing the library's statics, and using the bitsliced
+// PRGs must not require AES-NI
+#if defined(__AES__)
+#error "prg_no_aesni_test must be compiled without AES-NI"
+#endif
+
+#include "dpf.hpp"
+
+template <typename PRG>
+void expect_zero_key_known_answer(const unsigned char (&expected)[16])
+{
+    using block_type = typename PRG::block_type;
+
+    // with seed 0 and position 0 the output is just AES_0(0)
+    block_type zero = simde_mm_setzero_si128();
+    auto block = PRG::eval(zero, 0);
+    EXPECT_EQ(std::memcmp(&block, expected, sizeof(block)), 0);
+
+    auto children = PRG::eval01(zero);
+    EXPECT_EQ(std::memcmp(&children[0], expected, sizeof(block)), 0);
+
+    block_type many[3] = { zero, zero, zero }, output[3];
+    PRG::eval_many(many, 0, output, 3);
+    for (const auto & out : output)
+    {
+        EXPECT_EQ(std::memcmp(&out, expected, sizeof(block)), 0);
+    }
+}
+
+TEST(PrgNoAesNiTest, BitslicedKnownAnswer)
+{
+    // FIPS-197 style all-zero key, all-zero plaintext vectors
+    static constexpr unsigned char aes128_zero[16] = {
+        0x66, 0xe9, 0x4b, 0xd4, 0xef, 0x8a, 0x2c, 0x3b,
+        0x88, 0x4c, 0xfa, 0x59, 0xca, 0x34, 0x2b, 0x2e };
+    static constexpr unsigned char aes256_zero[16] = {
+        0xdc, 0x95, 0xc0, 0x78, 0xa2, 0x40, 0x89, 0x89,
+        0xad, 0x48, 0xa2, 0x14, 0x92, 0x84, 0x20, 0x87 };
+    expect_zero_key_known_answer<dpf::prg::aes128_bitsliced>(aes128_zero);
+    expect_zero_key_known_answer<dpf::prg::aes256_bitsliced>(aes256_zero);
+}
+
+TEST(PrgNoAesNiTest, BitslicedDpf)
+{
+    using prg = dpf::prg::aes128_bitsliced;
+    uint16_t x = 12345;
+    uint64_t y = 0xdeadbeef;
+    auto [dpf0, dpf1] = dpf::make_dpf<prg, prg>(x, y);
+
+    for (uint16_t z : { uint16_t(0), uint16_t(x-1), x, uint16_t(x+1), uint16_t(65535) })
+    {
+        uint64_t y0 = dpf::eval_point(dpf0, z),
+                 y1 = dpf::eval_point(dpf1, z);
+        EXPECT_EQ(static_cast<uint64_t>(y1 - y0), z == x ? y : 0);
+    }
+}
+
+TEST(PrgNoAesNiTest, UserKeySchedule)
+{
+    // FIPS-197 Appendix A.1 and A.3 key expansions (last round key)
+    static constexpr unsigned char key128[16] = {
+        0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+        0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c };
+    static constexpr unsigned char last128[16] = {
+        0xd0, 0x14, 0xf9, 0xa8, 0xc9, 0xee, 0x25, 0x89,
+        0xe1, 0x3f, 0x0c, 0xc8, 0xb6, 0x63, 0x0c, 0xa6 };
+    static constexpr unsigned char key256[32] = {
+        0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe,
+        0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+        0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7,
+        0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4 };
+    static constexpr unsigned char last256[16] = {
+        0xfe, 0x48, 0x90, 0xd1, 0xe6, 0x18, 0x8d, 0x0b,
+        0x04, 0x6d, 0xf3, 0x44, 0x70, 0x6c, 0x63, 0x1e };
+
+    dpf::prg::aes128_key k128(simde_mm_loadu_si128(
+        reinterpret_cast<const simde__m128i *>(key128)));
+    EXPECT_EQ(std::memcmp(&k128.rd_key[0], key128, 16), 0);
+    EXPECT_EQ(std::memcmp(&k128.rd_key[10], last128, 16), 0);
+
+    dpf::prg::aes256_key k256(simde_mm256_loadu_si256(
+        reinterpret_cast<const simde__m256i *>(key256)));
+    EXPECT_EQ(std::memcmp(&k256.rd_key[0], key256, 16), 0);
+    EXPECT_EQ(std::memcmp(&k256.rd_key[1], key256 + 16, 16), 0);
+    EXPECT_EQ(std::memcmp(&k256.rd_key[14], last256, 16), 0);
+
+    // the default constructor still yields the all-zero key's schedule
+    dpf::prg::aes128_key zero128;
+    dpf::prg::aes128_key zero128_user(simde_mm_setzero_si128());
+    EXPECT_EQ(std::memcmp(zero128.rd_key.data(), zero128_user.rd_key.data(),
+        sizeof(zero128.rd_key)), 0);
+}
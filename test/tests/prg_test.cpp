@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "dpf.hpp"
+
+template <typename PRG>
+struct PrgTest : public testing::Test
+{
+  public:
+    using prg = PRG;
+    using block_type = typename PRG::block_type;
+
+    // deliberately not a multiple of any batch size used by the PRGs
+    static constexpr std::size_t count = 77;
+
+  protected:
+    PrgTest()
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            seeds[i] = dpf::uniform_sample<block_type>();
+        }
+    }
+
+    static bool equal(const block_type & a, const block_type & b)
+    {
+        return std::memcmp(&a, &b, sizeof(block_type)) == 0;
+    }
+
+    block_type seeds[count];
+};
+
+TYPED_TEST_SUITE_P(PrgTest);
+
+TYPED_TEST_P(PrgTest, Eval01)
+{
+    using prg = typename TestFixture::prg;
+
+    for (std::size_t i = 0; i < this->count; ++i)
+    {
+        auto children = prg::eval01(this->seeds[i]);
+        ASSERT_TRUE(this->equal(children[0], prg::eval(this->seeds[i], 0)));
+        ASSERT_TRUE(this->equal(children[1], prg::eval(this->seeds[i], 1)));
+    }
+}
+
+TYPED_TEST_P(PrgTest, EvalMany)
+{
+    using prg = typename TestFixture::prg;
+    using block_type = typename TestFixture::block_type;
+
+    // positions past 1 are used to expand leaves that span several blocks
+    for (psnip_uint32_t pos : { 0u, 1u, 6u })
+    {
+        for (std::size_t n : { std::size_t(0), std::size_t(1), std::size_t(8), this->count })
+        {
+            block_type output[TestFixture::count];
+            prg::eval_many(this->seeds, pos, output, n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                ASSERT_TRUE(this->equal(output[i], prg::eval(this->seeds[i], pos)));
+            }
+        }
+    }
+}
+
+TYPED_TEST_P(PrgTest, EvalCounter)
+{
+    using prg = typename TestFixture::prg;
+    using block_type = typename TestFixture::block_type;
+
+    for (psnip_uint32_t pos : { 0u, 5u, 1000u })
+    {
+        for (psnip_uint32_t n : { 1u, 3u, 8u, 21u })
+        {
+            block_type output[21];
+            prg::eval(this->seeds[n], output, n, pos);
+            for (psnip_uint32_t i = 0; i < n; ++i)
+            {
+                ASSERT_TRUE(this->equal(output[i], prg::eval(this->seeds[n], pos+i)));
+            }
+        }
+    }
+}
+
+REGISTER_TYPED_TEST_SUITE_P(PrgTest,
+    Eval01,
+    EvalMany,
+    EvalCounter);
+using Types = testing::Types
+<
+    dpf::prg::aes128,
+    dpf::prg::aes256,
+    dpf::prg::aes128_bitsliced,
+    dpf::prg::aes256_bitsliced,
+    dpf::prg::chacha8,
+    dpf::prg::chacha12
+>;
+INSTANTIATE_TYPED_TEST_SUITE_P(PrgTestInstantiation, PrgTest, Types);
+
+// `dpf::prg::chacha<Rounds>` is ChaCha with a 128-bit key, a 64-bit
+// counter in words 12-13 and a zero IV, so its positions 4c through 4c+3
+// are keystream block c of the reference cipher
+template <typename PRG>
+void expect_chacha_known_answer(const char * zero_key_block0, const char * pinned_pos5)
+{
+    using block_type = typename PRG::block_type;
+    auto from_hex = [](const char * hex, std::size_t len)
+    {
+        std::vector<unsigned char> bytes(len);
+        for (std::size_t i = 0; i < len; ++i)
+        {
+            bytes[i] = static_cast<unsigned char>(std::stoul(std::string(hex + 2*i, 2), nullptr, 16));
+        }
+        return bytes;
+    };
+
+    // the 128-bit all-zero key, zero IV test vector (eSTREAM / Bernstein)
+    auto expected = from_hex(zero_key_block0, 64);
+    block_type zero = simde_mm_setzero_si128(), ctr[4];
+    PRG::eval(zero, ctr, 4, 0);
+    for (psnip_uint32_t pos = 0; pos < 4; ++pos)
+    {
+        auto block = PRG::eval(zero, pos);
+        EXPECT_EQ(std::memcmp(&block, &expected[16*pos], sizeof(block)), 0);
+        EXPECT_EQ(std::memcmp(&ctr[pos], &expected[16*pos], sizeof(block)), 0);
+    }
+    auto children = PRG::eval01(zero);
+    EXPECT_EQ(std::memcmp(&children[0], &expected[0], sizeof(block_type)), 0);
+    EXPECT_EQ(std::memcmp(&children[1], &expected[16], sizeof(block_type)), 0);
+
+    // a seed with distinct bytes fixes the key word order; position 5 is
+    // words 4-7 of keystream block 1
+    block_type seed;
+    unsigned char seed_bytes[sizeof(block_type)];
+    for (std::size_t i = 0; i < sizeof(seed_bytes); ++i) seed_bytes[i] = static_cast<unsigned char>(i);
+    std::memcpy(&seed, seed_bytes, sizeof(seed));
+    auto pinned = from_hex(pinned_pos5, 16);
+    auto block = PRG::eval(seed, 5);
+    EXPECT_EQ(std::memcmp(&block, pinned.data(), sizeof(block)), 0);
+}
+
+TEST(ChachaPrgTest, KnownAnswer)
+{
+    expect_chacha_known_answer<dpf::prg::chacha8>(
+        "e28a5fa4a67f8c5defed3e6fb7303486aa8427d31419a729572d777953491120"
+        "b64ab8e72b8deb85cd6aea7cb6089a101824beeb08814a428aab1fa2c816081b",
+        "4fa9dc5a18864a31a96cbc0b60ab20a6");
+    expect_chacha_known_answer<dpf::prg::chacha12>(
+        "e1047ba9476bf8ff312c01b4345a7d8ca5792b0ad467313f1dc412b5fdce3241"
+        "0dea8b68bd774c36a920f092a04d3f95274fbeff97bc8491fcef37f85970b450",
+        "5ea9293ac730857068ef215908ec9e7a");
+}
+
+template <typename PRG>
+void expect_same_output_on_all_aes_backends()
+{
+    using block_type = typename PRG::block_type;
+    constexpr std::size_t count = 45;
+
+    block_type seeds[count], expected_many[count], expected_ctr[count];
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        seeds[i] = dpf::uniform_sample<block_type>();
+    }
+
+    auto original = dpf::prg::get_aes_backend();
+    dpf::prg::set_aes_backend(dpf::prg::aes_backend::aesni);
+    PRG::eval_many(seeds, 1, expected_many, count);
+    PRG::eval(seeds[0], expected_ctr, count, 7);
+
+    for (auto backend : { dpf::prg::aes_backend::vaes256, dpf::prg::aes_backend::vaes512 })
+    {
+        if (dpf::prg::aes_backend_supported(backend) == false) continue;
+        dpf::prg::set_aes_backend(backend);
+
+        block_type many[count], ctr[count];
+        PRG::eval_many(seeds, 1, many, count);
+        PRG::eval(seeds[0], ctr, count, 7);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            EXPECT_EQ(std::memcmp(&many[i], &expected_many[i], sizeof(block_type)), 0);
+            EXPECT_EQ(std::memcmp(&ctr[i], &expected_ctr[i], sizeof(block_type)), 0);
+        }
+    }
+    dpf::prg::set_aes_backend(original);
+}
+
+TEST(AesBackendTest, AllBackendsAgree)
+{
+    expect_same_output_on_all_aes_backends<dpf::prg::aes128>();
+    expect_same_output_on_all_aes_backends<dpf::prg::aes256>();
+}
+
+template <typename Bitsliced, typename Reference>
+void expect_same_output_as_reference()
+{
+    using block_type = typename Reference::block_type;
+    constexpr std::size_t count = 45;
+
+    block_type seeds[count];
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        seeds[i] = dpf::uniform_sample<block_type>();
+    }
+
+    for (bool dir : { false, true })
+    {
+        block_type expected[count], actual[count];
+        Reference::eval_many(seeds, dir, expected, count);
+        Bitsliced::eval_many(seeds, dir, actual, count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            EXPECT_EQ(std::memcmp(&actual[i], &expected[i], sizeof(block_type)), 0);
+        }
+    }
+
+    block_type expected_ctr[count], ctr[count];
+    Reference::eval(seeds[0], expected_ctr, count, 3);
+    Bitsliced::eval(seeds[0], ctr, count, 3);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        EXPECT_EQ(std::memcmp(&ctr[i], &expected_ctr[i], sizeof(block_type)), 0);
+    }
+}
+
+TEST(AesBitslicedTest, MatchesAesNi)
+{
+    expect_same_output_as_reference<dpf::prg::aes128_bitsliced, dpf::prg::aes128>();
+    expect_same_output_as_reference<dpf::prg::aes256_bitsliced, dpf::prg::aes256>();
+}
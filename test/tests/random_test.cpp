@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "dpf.hpp"
+
+#if !defined(LIBDPF_USE_DEV_RANDOM) && !defined(LIBDPF_USE_ARC4RANDOM) \
+    && !defined(LIBDPF_USE_DEV_URANDOM)
+TEST(RandomTest, ChaCha20KnownAnswer)
+{
+    // RFC 7539, Appendix A.1, test vectors #1 and #2 (all-zero key and nonce);
+    // these also check the block function shared with dpf::prg::chacha
+    static constexpr unsigned char expected[2][64] = {
+        { 0x76, 0xb8, 0xe0, 0xad, 0xa0, 0xf1, 0x3d, 0x90, 0x40, 0x5d, 0x6a, 0xe5, 0x53, 0x86, 0xbd, 0x28,
+          0xbd, 0xd2, 0x19, 0xb8, 0xa0, 0x8d, 0xed, 0x1a, 0xa8, 0x36, 0xef, 0xcc, 0x8b, 0x77, 0x0d, 0xc7,
+          0xda, 0x41, 0x59, 0x7c, 0x51, 0x57, 0x48, 0x8d, 0x77, 0x24, 0xe0, 0x3f, 0xb8, 0xd8, 0x4a, 0x37,
+          0x6a, 0x43, 0xb8, 0xf4, 0x15, 0x18, 0xa1, 0x1c, 0xc3, 0x87, 0xb6, 0x69, 0xb2, 0xee, 0x65, 0x86 },
+        { 0x9f, 0x07, 0xe7, 0xbe, 0x55, 0x51, 0x38, 0x7a, 0x98, 0xba, 0x97, 0x7c, 0x73, 0x2d, 0x08, 0x0d,
+          0xcb, 0x0f, 0x29, 0xa0, 0x48, 0xe3, 0x65, 0x69, 0x12, 0xc6, 0x53, 0x3e, 0x32, 0xee, 0x7a, 0xed,
+          0x29, 0xb7, 0x21, 0x76, 0x9c, 0xe6, 0x4e, 0x43, 0xd5, 0x71, 0x33, 0xb0, 0x74, 0xd8, 0x39, 0xd5,
+          0x31, 0xed, 0x1f, 0x28, 0x51, 0x0a, 0xfb, 0x45, 0xac, 0xe1, 0x0a, 0x1f, 0x4b, 0x79, 0x4d, 0x6f }
+    };
+    const psnip_uint32_t key[8] = { 0 };
+    for (psnip_uint64_t counter : { 0, 1 })
+    {
+        unsigned char block[64];
+        dpf::detail::chacha20_drbg::chacha20_block(key, counter, block);
+        ASSERT_EQ(std::memcmp(block, expected[counter], sizeof(block)), 0);
+    }
+}
+#endif
+
+TEST(RandomTest, SamplesDiffer)
+{
+    std::set<psnip_uint64_t> seen;
+    for (std::size_t i = 0; i < 10000; ++i)
+    {
+        ASSERT_TRUE(seen.insert(dpf::uniform_sample<psnip_uint64_t>()).second);
+    }
+}
+
+TEST(RandomTest, FillsSpans)
+{
+    // spans larger than, and not a multiple of, the DRBG's internal buffer
+    for (std::size_t count : { 1, 1000, 12345 })
+    {
+        std::vector<psnip_uint32_t> a(count, 0), b(count, 0);
+        dpf::uniform_fill(std::data(a), count);
+        dpf::uniform_fill(std::data(b), count);
+        std::size_t same = 0;
+        for (std::size_t i = 0; i < count; ++i) same += (a[i] == b[i]);
+        ASSERT_LE(same, count / 1000 + 1);
+    }
+}
+
+TEST(RandomTest, ThreadsDiffer)
+{
+    std::array<psnip_uint64_t, 4> samples;
+    std::vector<std::thread> pool;
+    for (std::size_t t = 0; t < std::size(samples); ++t)
+    {
+        pool.emplace_back([&samples, t]() { samples[t] = dpf::uniform_sample<psnip_uint64_t>(); });
+    }
+    for (auto & thread : pool) thread.join();
+    std::set<psnip_uint64_t> seen(std::begin(samples), std::end(samples));
+    ASSERT_EQ(std::size(seen), std::size(samples));
+}
+
+TEST(RandomTest, ForkedChildDiffers)
+{
+    dpf::uniform_sample<psnip_uint64_t>();  // make sure this thread is seeded
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+    {
+        auto sample = dpf::uniform_sample<psnip_uint64_t>();
+        _exit(write(fds[1], &sample, sizeof(sample)) == sizeof(sample) ? 0 : 1);
+    }
+    auto parent = dpf::uniform_sample<psnip_uint64_t>();
+    psnip_uint64_t child;
+    ASSERT_EQ(read(fds[0], &child, sizeof(child)), static_cast<ssize_t>(sizeof(child)));
+    waitpid(pid, nullptr, 0);
+    close(fds[0]);
+    close(fds[1]);
+    ASSERT_NE(parent, child);
+}
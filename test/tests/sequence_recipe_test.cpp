@@ -0,0 +1,320 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "dpf.hpp"
+
+// the original std::list-based builder, kept as a reference
+template <typename DpfKey,
+          typename ForwardIterator>
+auto make_reference_recipe(ForwardIterator begin, ForwardIterator end)
+{
+    using dpf_type = DpfKey;
+    using input_type = typename DpfKey::input_type;
+
+    auto mask = dpf_type::msb_mask;
+    std::list<ForwardIterator> splits{begin, end};
+    std::vector<std::size_t> level_endpoints{0};
+    std::vector<int8_t> recipe_steps;
+
+    auto func = [&](const bool flip = false)
+    {
+        for (auto upper = std::begin(splits), lower = upper++; upper != std::end(splits); lower = upper++)
+        {
+            auto it = std::upper_bound(*lower, *upper, mask,
+                [&flip](auto a, auto b){ return static_cast<bool>(a&b) ^ flip; });
+            if (it == *lower) recipe_steps.push_back(-1);
+            else if (it == *upper) recipe_steps.push_back(+1);
+            else
+            {
+                recipe_steps.push_back(0);
+                splits.insert(upper, it);
+            }
+        }
+        level_endpoints.push_back(recipe_steps.size());
+    };
+    if (dpf_type::depth > 0)
+    {
+        func(dpf::utils::is_signed_integral_v<input_type>);
+        mask >>= 1;
+    }
+    for (std::size_t level_index = 1; level_index < dpf_type::depth; ++level_index, mask>>=1)
+    {
+        func();
+    }
+
+    std::vector<std::size_t> output_indices;
+    std::size_t leaf_index = 0;
+    constexpr auto mod = dpf::utils::mod_pow_2<input_type>{};
+    constexpr auto clz = dpf::utils::countl_zero_symmetric_difference<input_type>{};
+    for (auto curr = begin, prev = curr; curr != end; prev = curr++)
+    {
+        leaf_index += (clz(*prev, *curr)) < dpf_type::depth;
+        output_indices.push_back(leaf_index * dpf_type::outputs_per_leaf + mod(*curr, dpf_type::lg_outputs_per_leaf));
+    }
+
+    return dpf::sequence_recipe{recipe_steps, output_indices, leaf_index+1, level_endpoints,
+        dpf_type::lg_outputs_per_leaf};
+}
+
+template <typename T>
+struct SequenceRecipeTest : public testing::Test
+{
+  public:
+    using input_type = typename std::tuple_element_t<0, T>;
+    using output_type = typename std::tuple_element_t<1, T>;
+    using integral_type = dpf::utils::integral_type_from_bitlength_t<dpf::utils::bitlength_of_v<input_type>>;
+    using dpf_type = dpf::utils::dpf_type_t<dpf::prg::aes128, dpf::prg::aes128, input_type, output_type>;
+
+  protected:
+    static std::vector<input_type> get_points(std::size_t count)
+    {
+        std::set<input_type> ret;
+        while (ret.size() < std::min(count, range))
+        {
+            ret.emplace(from_integral_type(dpf::uniform_sample<integral_type>()));
+        }
+        return std::vector<input_type>(ret.begin(), ret.end());
+    }
+
+    static void assert_same(const dpf::sequence_recipe & expected,
+        const dpf::sequence_recipe & actual)
+    {
+        ASSERT_EQ(expected.recipe_steps(), actual.recipe_steps());
+        ASSERT_EQ(expected.output_indices(), actual.output_indices());
+        ASSERT_EQ(expected.num_leaf_nodes(), actual.num_leaf_nodes());
+        ASSERT_EQ(expected.level_endpoints(), actual.level_endpoints());
+        ASSERT_EQ(expected.lg_outputs_per_leaf(), actual.lg_outputs_per_leaf());
+    }
+
+    static constexpr auto from_integral_type = dpf::utils::make_from_integral_value<input_type>{};
+    static constexpr std::size_t range = std::size_t(1) << std::min(dpf::utils::bitlength_of_v<input_type>, std::size_t(20));
+};
+
+TYPED_TEST_SUITE_P(SequenceRecipeTest);
+
+TYPED_TEST_P(SequenceRecipeTest, MatchesReference)
+{
+    using dpf_type = typename TestFixture::dpf_type;
+
+    for (std::size_t count : { 1, 2, 3, 50, 5000 })
+    {
+        auto points = this->get_points(count);
+        auto expected = make_reference_recipe<dpf_type>(points.begin(), points.end());
+        for (std::size_t threads : { 1, 2, 7 })
+        {
+            this->assert_same(expected,
+                dpf::make_sequence_recipe<dpf_type>(points.begin(), points.end(), threads));
+        }
+    }
+}
+
+TYPED_TEST_P(SequenceRecipeTest, ForwardIterators)
+{
+    using dpf_type = typename TestFixture::dpf_type;
+
+    auto points = this->get_points(300);
+    std::list<typename TestFixture::input_type> list(points.begin(), points.end());
+    this->assert_same(make_reference_recipe<dpf_type>(points.begin(), points.end()),
+        dpf::make_sequence_recipe<dpf_type>(list.begin(), list.end(), 3));
+}
+
+TYPED_TEST_P(SequenceRecipeTest, Unsorted)
+{
+    using dpf_type = typename TestFixture::dpf_type;
+
+    auto points = this->get_points(10);
+    std::reverse(points.begin(), points.end());
+    ASSERT_THROW(dpf::make_sequence_recipe<dpf_type>(points.begin(), points.end()),
+        std::runtime_error);
+}
+
+TYPED_TEST_P(SequenceRecipeTest, BreadthFirst)
+{
+    using output_type = typename TestFixture::output_type;
+
+    auto points = this->get_points(500);
+    auto [dpf0, dpf1] = dpf::make_dpf(points[points.size()/2], output_type(1));
+    auto [buf, iter] = dpf::eval_sequence_breadth_first(dpf0, points.begin(), points.end());
+    auto it = std::begin(iter);
+    for (std::size_t i = 0; i < points.size(); ++i, ++it)
+    {
+        ASSERT_EQ(static_cast<output_type>(*it),
+            static_cast<output_type>(dpf::eval_point(dpf0, points[i])));
+    }
+}
+
+TYPED_TEST_P(SequenceRecipeTest, SaveLoad)
+{
+    using dpf_type = typename TestFixture::dpf_type;
+
+    auto points = this->get_points(777);
+    auto recipe = dpf::make_sequence_recipe<dpf_type>(points.begin(), points.end());
+    ASSERT_EQ(recipe.packed_steps().size(), (recipe.num_steps() + 3) / 4);
+
+    std::stringstream ss;
+    recipe.save(ss);
+    std::string bytes = ss.str();
+    this->assert_same(recipe, dpf::sequence_recipe::load(ss));
+    this->assert_same(recipe, dpf::sequence_recipe::load(bytes.data(), bytes.size()));
+
+    ASSERT_THROW(dpf::sequence_recipe::load(bytes.data(), bytes.size() - 1),
+        std::runtime_error);
+    bytes[0] ^= 1;
+    ASSERT_THROW(dpf::sequence_recipe::load(bytes.data(), bytes.size()),
+        std::runtime_error);
+
+    // an empty sequence has one (unused) leaf and no outputs
+    std::vector<typename TestFixture::input_type> none;
+    auto empty = dpf::make_sequence_recipe<dpf_type>(none.begin(), none.end());
+    std::stringstream empty_ss;
+    empty.save(empty_ss);
+    this->assert_same(empty, dpf::sequence_recipe::load(empty_ss));
+}
+
+TYPED_TEST_P(SequenceRecipeTest, LoadMalformed)
+{
+    using dpf_type = typename TestFixture::dpf_type;
+
+    auto points = this->get_points(777);
+    auto recipe = dpf::make_sequence_recipe<dpf_type>(points.begin(), points.end());
+    std::stringstream ss;
+    recipe.save(ss);
+    const std::string bytes = ss.str();
+
+    // header words: magic, num_steps, num_outputs, num_leaf_nodes, depth,
+    // lg_outputs_per_leaf
+    auto load_with_word = [&bytes](std::size_t word, uint64_t value)
+    {
+        std::string corrupt = bytes;
+        std::memcpy(corrupt.data() + word * sizeof(uint64_t), &value, sizeof(value));
+        return dpf::sequence_recipe::load(corrupt.data(), corrupt.size());
+    };
+    const uint64_t depth = recipe.depth(), num_outputs = recipe.output_indices().size();
+    ASSERT_THROW(load_with_word(4, UINT64_MAX), std::runtime_error);
+    ASSERT_THROW(load_with_word(4, depth + 1), std::runtime_error);
+    ASSERT_THROW(load_with_word(2, UINT64_MAX), std::runtime_error);
+    ASSERT_THROW(load_with_word(2, UINT64_MAX - depth), std::runtime_error);
+    ASSERT_THROW(load_with_word(1, UINT64_MAX), std::runtime_error);
+    ASSERT_THROW(load_with_word(3, recipe.num_leaf_nodes() + 1), std::runtime_error);
+    ASSERT_THROW(load_with_word(5, 64), std::runtime_error);
+    // leaves are numbered consecutively, so a wider leaf merges neighbours
+    // and the output indices no longer name num_leaf_nodes distinct leaves
+    ASSERT_THROW(load_with_word(5, dpf_type::lg_outputs_per_leaf + 1), std::runtime_error);
+
+    // the output indices must stay sorted and inside the leaves
+    const std::size_t outputs = 6 + depth + 1, last = outputs + num_outputs - 1;
+    ASSERT_THROW(load_with_word(outputs, std::size_t(1) << 20), std::runtime_error);
+    ASSERT_THROW(load_with_word(last, UINT64_MAX), std::runtime_error);
+    ASSERT_THROW(load_with_word(last, recipe.num_leaf_nodes() << dpf_type::lg_outputs_per_leaf),
+        std::runtime_error);
+    ASSERT_THROW(load_with_word(last, 0), std::runtime_error);
+
+    // the packed steps follow the header, level endpoints, and output indices
+    const std::size_t packed = (last + 1) * sizeof(uint64_t);
+    auto load_with_step = [&bytes, packed](std::size_t i, uint8_t code)
+    {
+        std::string corrupt = bytes;
+        auto & byte = reinterpret_cast<uint8_t &>(corrupt[packed + i / 4]);
+        byte = (byte & ~(0x3 << 2 * (i % 4))) | (code << 2 * (i % 4));
+        return dpf::sequence_recipe::load(corrupt.data(), corrupt.size());
+    };
+    ASSERT_THROW(load_with_step(0, 0b10), std::runtime_error);
+    ASSERT_THROW(load_with_step(recipe.num_steps() - 1, 0b10), std::runtime_error);
+
+    // swapping a one-way step for a two-way one (or vice versa) leaves the
+    // node counts inconsistent with the level endpoints
+    auto flip = [&recipe](std::size_t i) -> uint8_t { return recipe.step(i) == 0 ? 0b01 : 0b00; };
+    ASSERT_THROW(load_with_step(0, flip(0)), std::runtime_error);
+    ASSERT_THROW(load_with_step(recipe.num_steps() - 1, flip(recipe.num_steps() - 1)),
+        std::runtime_error);
+}
+
+TYPED_TEST_P(SequenceRecipeTest, Cache)
+{
+    using dpf_type = typename TestFixture::dpf_type;
+
+    dpf::sequence_recipe_cache cache;
+    auto points = this->get_points(100), others = this->get_points(101);
+    std::vector<dpf::sequence_recipe_cache::recipe_ptr> recipes(4);
+    std::vector<std::thread> threads;
+    for (auto & recipe : recipes)
+    {
+        threads.emplace_back([&]{ recipe = cache.get<dpf_type>(points.begin(), points.end()); });
+    }
+    for (auto & thread : threads) thread.join();
+    for (auto & recipe : recipes) ASSERT_EQ(recipe, recipes[0]);
+    this->assert_same(make_reference_recipe<dpf_type>(points.begin(), points.end()), *recipes[0]);
+
+    ASSERT_NE(cache.get<dpf_type>(others.begin(), others.end()), recipes[0]);
+    ASSERT_EQ(cache.size(), 2);
+
+    std::reverse(others.begin(), others.end());
+    ASSERT_THROW(cache.get<dpf_type>(others.begin(), others.end()), std::runtime_error);
+    ASSERT_EQ(cache.size(), 2);
+
+    cache.clear();
+    ASSERT_EQ(cache.size(), 0);
+    ASSERT_NE(cache.get<dpf_type>(points.begin(), points.end()), recipes[0]);
+}
+
+TYPED_TEST_P(SequenceRecipeTest, Split)
+{
+    using dpf_type = typename TestFixture::dpf_type;
+
+    auto points = this->get_points(300);
+    auto recipe = dpf::make_sequence_recipe<dpf_type>(points.begin(), points.end());
+    for (std::size_t level = 0; level <= dpf_type::depth; ++level)
+    {
+        auto subrecipes = dpf::split_sequence_recipe<dpf_type>(recipe, level);
+        ASSERT_EQ(subrecipes.size(), level < dpf_type::depth
+            ? recipe.level_endpoints()[level+1] - recipe.level_endpoints()[level]
+            : recipe.num_leaf_nodes());
+
+        std::size_t leaves = 0;
+        std::vector<std::size_t> outputs;
+        for (const auto & sub : subrecipes)
+        {
+            ASSERT_EQ(sub.recipe.depth(), recipe.depth());
+            ASSERT_EQ(sub.first_leaf, leaves);
+            ASSERT_EQ(sub.first_output, outputs.size());
+            for (auto index : sub.recipe.output_indices())
+            {
+                outputs.push_back(index + sub.first_leaf * dpf_type::outputs_per_leaf);
+            }
+            leaves += sub.recipe.num_leaf_nodes();
+        }
+        ASSERT_EQ(leaves, recipe.num_leaf_nodes());
+        ASSERT_EQ(outputs, recipe.output_indices());
+    }
+    ASSERT_THROW(dpf::split_sequence_recipe<dpf_type>(recipe, dpf_type::depth + 1),
+        std::invalid_argument);
+}
+
+REGISTER_TYPED_TEST_SUITE_P(SequenceRecipeTest,
+    MatchesReference,
+    ForwardIterators,
+    Unsorted,
+    BreadthFirst,
+    SaveLoad,
+    LoadMalformed,
+    Cache,
+    Split);
+using Types = testing::Types
+<
+    std::tuple<uint16_t, uint64_t>,
+    std::tuple<int16_t, uint64_t>,
+    std::tuple<uint8_t, uint64_t>,
+    std::tuple<uint64_t, uint64_t>,
+    std::tuple<int64_t, uint64_t>,
+    std::tuple<dpf::modint<10>, uint64_t>,
+    std::tuple<uint16_t, uint8_t>,
+    std::tuple<uint16_t, dpf::bit>
+>;
+INSTANTIATE_TYPED_TEST_SUITE_P(SequenceRecipeTestInstantiation, SequenceRecipeTest, Types);